@@ -10,6 +10,13 @@
 #include "app_config.h"
 #include "app_process.h"
 #include "app_tools.h"
+#include "app_topology.h"
+#include "app_trace.h"
+#include "app_power.h"
+#include "app_network.h"
+#include "app_consensus.h"
+#include "app_gossip.h"
+#include "sl_rail_util_init.h"
 
 /** CLI - info: Prints the unique ID of the board to the console.
  *
@@ -19,11 +26,13 @@
  */
 void cli_info(sl_cli_command_arg_t *arguments) {
 	(void) arguments;
-	app_log_info("  MCU Id:       0x%llx\n", SYSTEM_GetUnique());
+	app_log_info("  MCU Id:       0x%llx\n", (unsigned long long)SYSTEM_GetUnique());
 }
 
 /** CLI - average: Wakes up the system and starts the execution of the Average
- * Consensus algorithm in a distributed manner.
+ * Consensus algorithm in a distributed manner. While the board tracks the
+ * average (see the 'track' command), it prints its current estimates instead,
+ * without a new run.
  *
  * @date 01/02/2023
  * @param arguments A pointer to the arguments provided by the user through the
@@ -31,25 +40,173 @@ void cli_info(sl_cli_command_arg_t *arguments) {
  */
 void cli_avg_consensus(sl_cli_command_arg_t *arguments) {
 	(void) arguments;
-	if(!app_is_ok_to_sleep()){
+	if(gossip_tracks()){
+		print_consensus_estimates();
+		return;
+	}
+	if(!is_asleep()){
 		app_log_info("Boards are busy. Try again in a while.\n");
 		return;
 	}
+	bool on_path = false;
+	for(int i=0;i<length_of_baton_path;i++)
+		on_path = on_path || baton_path[i]==board_id;
+	if(!USE_TDMA && !on_path){ //The task of the baton starts where the baton does
+		app_log_info("This board is not on the baton path. Start the task from another board.\n");
+		return;
+	}
 	wake_up();
 	average_command = true;
 
-	starting_board = BOARD_ID;
+	starting_board = board_id;
 	baton = true;    //Acquire the baton
 	baton_cntr = 1;
-	for(int i=0;i<LENGTH_OF_BATON_PATH;i++){ //Compute the destination of the baton, after being released from this board
-		if(baton_path[i]==BOARD_ID){
+	for(int i=0;i<length_of_baton_path;i++){ //Compute the destination of the baton, after being released from this board
+		if(baton_path[i]==board_id){
 			dst_of_baton = i+1;
 			break;
 		}
 	}
-	if(dst_of_baton==LENGTH_OF_BATON_PATH)
+	if(dst_of_baton==length_of_baton_path)
 		dst_of_baton = 0;
 	dst_of_baton = baton_path[dst_of_baton];
 
 	app_log_info("CLI command was given to execute Distributed Average Consensus.\n");
 }
+
+/** CLI - gossip: Wakes up the system and starts the execution of the
+ * randomized gossip (see app_gossip.h), i.e., Average Consensus with pairwise
+ * exchanges between random neighbors instead of the baton.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_gossip(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	if(!is_asleep()){
+		app_log_info("Boards are busy. Try again in a while.\n");
+		return;
+	}
+	wake_up();
+	gossip_command = true;
+	starting_board = board_id;
+	app_log_info("CLI command was given to execute Randomized Gossip.\n");
+}
+
+/** CLI - track: Wakes up the system and starts the tracking of the average
+ * (see app_gossip.h), i.e., the randomized gossip over the changing readings
+ * of the boards, which continues until the command is given again (on any
+ * board which tracks the average).
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_track(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	if(gossip_tracks()){
+		stop_tracking();
+		app_log_info("CLI command was given to stop tracking the average.\n");
+		return;
+	}
+	if(!is_asleep()){
+		app_log_info("Boards are busy. Try again in a while.\n");
+		return;
+	}
+	wake_up();
+	tracking_command = true;
+	starting_board = board_id;
+	app_log_info("CLI command was given to track the average.\n");
+}
+
+/** CLI - provision: Stores the identity of the board and the topology of the
+ * system to the flash, and applies them immediately (no rebuild is required).
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console: the identity of the board, the total number of boards, the edges of
+ * the graph (e.g., "0-1,0-5,1-2", with "a>b" for a one-way link from board a
+ * to board b) and the baton path (e.g., "3,2,1,0,5,4,5,1,2",
+ * or "auto" for the path generated from the graph).
+ */
+void cli_provision(sl_cli_command_arg_t *arguments) {
+	if(!is_asleep()){
+		app_log_info("Boards are busy. Try again in a while.\n");
+		return;
+	}
+	uint8_t id = sl_cli_get_argument_uint8(arguments, 0);
+	uint8_t boards = sl_cli_get_argument_uint8(arguments, 1);
+	char *edges = sl_cli_get_argument_string(arguments, 2);
+	char *path = sl_cli_get_argument_string(arguments, 3);
+	if(!provision_topology(id, boards, edges, path))
+		return;
+
+	initialize_app(sl_rail_util_get_handle(SL_RAIL_UTIL_HANDLE_INST0)); //Start receiving on the (possibly new) channel of this board
+	app_log_info("Provisioning complete.\n");
+	print_topology();
+}
+
+/** CLI - discover: Wakes up the system and discovers the graph from the links
+ * measured by the boards (see app_discovery.h). Every board then stores the
+ * discovered graph with its generated baton path to the flash, as if it was
+ * provisioned with it.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_discover(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	if(!USE_SHARED_CHANNEL || (USE_LOW_POWER_LISTEN && !USE_TDMA)){
+		app_log_error("Error. The discovery requires every board to receive continuously on the shared channel (USE_SHARED_CHANNEL 1, and USE_LOW_POWER_LISTEN 0 unless USE_TDMA is 1).\n");
+		return;
+	}
+	if(!is_asleep()){
+		app_log_info("Boards are busy. Try again in a while.\n");
+		return;
+	}
+	wake_up();
+	discovery_command = true;
+	starting_board = board_id;
+	app_log_info("CLI command was given to discover the graph.\n");
+}
+
+/** CLI - topology: Prints the identity of the board and the topology of the
+ * system to the console.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_topology(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	print_topology();
+}
+
+/** CLI - trace: Prints the records of the trace of the board to the console
+ * (see host/trace_decode for rendering them as text), and empties the trace.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_trace(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	dump_trace();
+}
+
+/** CLI - energy: Prints the energy estimate of the current (or the last) run of
+ * the board to the console: the time spent in every energy mode, the time of
+ * the radio, and the estimated charge. It also prints the counters of the
+ * link layer (see {@link USE_ACKS}).
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_energy(sl_cli_command_arg_t *arguments) {
+	(void) arguments;
+	print_energy_estimate();
+	print_link_stats();
+}
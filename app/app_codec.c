@@ -0,0 +1,433 @@
+/***************************************************************************//**
+ * @file app_codec.c
+ * @brief The implementation of the wire format of the exchanged messages.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include "app_codec.h"
+#include <math.h>
+#include <string.h>
+
+///The length of an encoded quantity of the state (see {@link STATE_ENCODING}).
+#define STATE_BYTES (STATE_ENCODING==STATE_FLOAT ? 4 : 2)
+
+///The length of an encoded state, i.e., of all its quantities (see {@link NUM_OF_QUANTITIES}).
+#define VECTOR_BYTES (NUM_OF_QUANTITIES*STATE_BYTES)
+
+///The length of the encoded weight of push-sum (a 32-bit float).
+#define WEIGHT_BYTES 4
+
+/** Writes a 16-bit value to a buffer (little-endian).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer.
+ * @param value The value.
+ */
+static void write_u16(uint8_t *buffer, uint16_t value){
+	buffer[0] = value & 0xFF;
+	buffer[1] = value >> 8;
+}
+
+/** Reads a 16-bit value from a buffer (little-endian).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer.
+ * @return The value.
+ */
+static uint16_t read_u16(const uint8_t *buffer){
+	return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+/** Writes a 32-bit value to a buffer (little-endian).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer.
+ * @param value The value.
+ */
+static void write_u32(uint8_t *buffer, uint32_t value){
+	for(int i=0;i<4;i++)
+		buffer[i] = (value >> (8*i)) & 0xFF;
+}
+
+/** Reads a 32-bit value from a buffer (little-endian).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer.
+ * @return The value.
+ */
+static uint32_t read_u32(const uint8_t *buffer){
+	uint32_t value = 0;
+	for(int i=0;i<4;i++)
+		value |= (uint32_t) buffer[i] << (8*i);
+	return value;
+}
+
+/** Converts a float to a half-precision float (IEEE 754 binary16), rounding to
+ * the nearest value (ties to even). Values beyond the range of the
+ * half-precision floats become infinite.
+ *
+ * @date 16/10/2026
+ * @param value The float.
+ * @return The bits of the half-precision float.
+ */
+static uint16_t float_to_half(float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint16_t sign = (bits >> 16) & 0x8000;
+	uint32_t mantissa = bits & 0x7FFFFF;
+	if(((bits >> 23) & 0xFF) == 0xFF) //infinity or NaN
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+	int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+	if(exponent >= 31)
+		return sign | 0x7C00;
+
+	uint32_t half, rest, halfway;
+	if(exponent <= 0){ //a subnormal half-precision float (or zero)
+		if(exponent < -10)
+			return sign;
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		half = mantissa >> shift;
+		rest = mantissa & ((1UL << shift) - 1);
+		halfway = 1UL << (shift - 1);
+	}
+	else {
+		half = ((uint32_t) exponent << 10) | (mantissa >> 13);
+		rest = mantissa & 0x1FFF;
+		halfway = 0x1000;
+	}
+	if(rest > halfway || (rest == halfway && (half & 1))) //a carry into the exponent is still correct (up to infinity)
+		half++;
+	return sign | (uint16_t) half;
+}
+
+/** Converts a half-precision float (IEEE 754 binary16) to a float (exactly).
+ *
+ * @date 16/10/2026
+ * @param half The bits of the half-precision float.
+ * @return The float.
+ */
+static float half_to_float(uint16_t half){
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+	if(exponent == 0){ //a subnormal half-precision float (or zero)
+		float value = ldexpf((float) mantissa, -24);
+		return sign ? -value : value;
+	}
+	uint32_t bits = sign | (mantissa << 13);
+	if(exponent == 31)
+		bits |= 0x7F800000;
+	else
+		bits |= (exponent - 15 + 127) << 23;
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/** Converts a float to a fixed-point number with {@link STATE_FIXED_FRACTION_BITS}
+ * fraction bits, rounding to the nearest value and saturating to its range
+ * (NaN becomes 0).
+ *
+ * @date 16/10/2026
+ * @param value The float.
+ * @return The fixed-point number.
+ */
+static int16_t float_to_fixed(float value){
+	float scaled = roundf(ldexpf(value, STATE_FIXED_FRACTION_BITS));
+	if(isnan(scaled))
+		return 0;
+	if(scaled >= INT16_MAX)
+		return INT16_MAX;
+	if(scaled <= INT16_MIN)
+		return INT16_MIN;
+	return (int16_t) scaled;
+}
+
+/** Converts a fixed-point number with {@link STATE_FIXED_FRACTION_BITS}
+ * fraction bits to a float (exactly).
+ *
+ * @date 16/10/2026
+ * @param fixed The fixed-point number.
+ * @return The float.
+ */
+static float fixed_to_float(int16_t fixed){
+	return ldexpf((float) fixed, -STATE_FIXED_FRACTION_BITS);
+}
+
+/** Writes a state to a buffer (see {@link STATE_ENCODING}).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link STATE_BYTES} bytes.
+ * @param state The state.
+ */
+static void write_state(uint8_t *buffer, float state){
+	if(STATE_ENCODING==STATE_HALF)
+		write_u16(buffer, float_to_half(state));
+	else if(STATE_ENCODING==STATE_FIXED)
+		write_u16(buffer, (uint16_t) float_to_fixed(state));
+	else {
+		uint32_t bits;
+		memcpy(&bits, &state, sizeof(bits));
+		write_u32(buffer, bits);
+	}
+}
+
+/** Reads a state from a buffer (see {@link STATE_ENCODING}).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link STATE_BYTES} bytes.
+ * @return The state.
+ */
+static float read_state(const uint8_t *buffer){
+	if(STATE_ENCODING==STATE_HALF)
+		return half_to_float(read_u16(buffer));
+	if(STATE_ENCODING==STATE_FIXED)
+		return fixed_to_float((int16_t) read_u16(buffer));
+	uint32_t bits = read_u32(buffer);
+	float state;
+	memcpy(&state, &bits, sizeof(state));
+	return state;
+}
+
+/** Writes all the quantities of a state to a buffer, one after the other.
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link VECTOR_BYTES} bytes.
+ * @param state The quantities of the state.
+ */
+static void write_states(uint8_t *buffer, const float *state){
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		write_state(&buffer[q*STATE_BYTES], state[q]);
+}
+
+/** Reads all the quantities of a state from a buffer.
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link VECTOR_BYTES} bytes.
+ * @param state The array where the quantities of the state are stored.
+ */
+static void read_states(const uint8_t *buffer, float *state){
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		state[q] = read_state(&buffer[q*STATE_BYTES]);
+}
+
+/** Writes a weight of push-sum to a buffer (as a 32-bit float, whatever the
+ * {@link STATE_ENCODING}).
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link WEIGHT_BYTES} bytes.
+ * @param weight The weight.
+ */
+static void write_weight(uint8_t *buffer, float weight){
+	uint32_t bits;
+	memcpy(&bits, &weight, sizeof(bits));
+	write_u32(buffer, bits);
+}
+
+/** Reads a weight of push-sum from a buffer.
+ *
+ * @date 16/10/2026
+ * @param buffer The buffer, of at least {@link WEIGHT_BYTES} bytes.
+ * @return The weight.
+ */
+static float read_weight(const uint8_t *buffer){
+	uint32_t bits = read_u32(buffer);
+	float weight;
+	memcpy(&weight, &bits, sizeof(weight));
+	return weight;
+}
+
+/** Returns the length of the fields of a type of message.
+ *
+ * @date 16/10/2026
+ * @param type The type of the message.
+ * @param tdma True if the fields of the TDMA mode are included.
+ * @param has_state True if a baton carries the state of its sender.
+ * @param has_weight True if the state is followed by the weight of push-sum.
+ * @return The length of the fields, or 0 if the type is invalid.
+ */
+static uint8_t fields_length(message_t type, bool tdma, bool has_state, bool has_weight){
+	switch(type){
+	case MSG_RESTART:
+		return 2;
+	case MSG_START_TASK:
+		return tdma ? 10 : 2;
+	case MSG_CONSENSUS_STATE:
+		return 1 + VECTOR_BYTES + (has_weight ? WEIGHT_BYTES : 0) + (tdma ? 1 : 0);
+	case MSG_BATON:
+		return 2 + (has_state ? VECTOR_BYTES + (has_weight ? WEIGHT_BYTES : 0) : 0);
+	case MSG_LINKS:
+		return 1 + 2*LINKS_BYTES;
+	case MSG_ACK:
+		return 1;
+	case MSG_GOSSIP:
+		return 3 + VECTOR_BYTES;
+	default:
+		return 0;
+	}
+}
+
+/*******************************************************************************
+ * Returns the length of the encoded packet of a message.
+ ******************************************************************************/
+uint8_t packet_length(const packet_t *packet){
+	uint8_t fields = fields_length(packet->type, packet->tdma, packet->has_state, packet->has_weight);
+	return fields ? PKTIDX_FIELDS + fields : 0;
+}
+
+/*******************************************************************************
+ * Encodes a message to a packet.
+ ******************************************************************************/
+uint8_t encode_packet(const packet_t *packet, uint8_t *buffer){
+	uint8_t length = packet_length(packet);
+	if(!length)
+		return 0;
+	buffer[PKTIDX_LENGTH] = length - 1;
+	buffer[PKTIDX_HEADER] = (PACKET_VERSION << 4) | packet->type;
+	buffer[PKTIDX_SRC] = packet->src;
+	buffer[PKTIDX_DST] = packet->dst;
+
+	uint8_t *fields = &buffer[PKTIDX_FIELDS];
+	switch(packet->type){
+	case MSG_RESTART:
+		fields[0] = packet->restart_id;
+		fields[1] = packet->origin;
+		break;
+	case MSG_START_TASK:
+		fields[0] = packet->task;
+		fields[1] = packet->origin;
+		if(packet->tdma){
+			write_u32(&fields[2], packet->timestamp);
+			write_u32(&fields[6], packet->epoch);
+		}
+		break;
+	case MSG_CONSENSUS_STATE:
+		fields[0] = packet->seq;
+		write_states(&fields[1], packet->state);
+		if(packet->has_weight)
+			write_weight(&fields[1+VECTOR_BYTES], packet->weight);
+		if(packet->tdma)
+			fields[1+VECTOR_BYTES+(packet->has_weight ? WEIGHT_BYTES : 0)] = packet->quiet_frames;
+		break;
+	case MSG_BATON:
+		fields[0] = packet->seq;
+		fields[1] = (uint8_t) packet->boards_over;
+		if(packet->has_state)
+			write_states(&fields[2], packet->state);
+		if(packet->has_state && packet->has_weight)
+			write_weight(&fields[2+VECTOR_BYTES], packet->weight);
+		break;
+	case MSG_LINKS:
+		fields[0] = packet->owner;
+		for(int i=0;i<LINKS_BYTES;i++){
+			fields[1+i] = (packet->links >> (8*i)) & 0xFF;
+			fields[1+LINKS_BYTES+i] = (packet->audible >> (8*i)) & 0xFF;
+		}
+		break;
+	case MSG_ACK:
+		fields[0] = packet->seq;
+		break;
+	case MSG_GOSSIP:
+		fields[0] = packet->seq;
+		fields[1] = packet->gossip;
+		fields[2] = packet->quiet_frames;
+		write_states(&fields[3], packet->state);
+		break;
+	default:
+		break;
+	}
+	return length;
+}
+
+/*******************************************************************************
+ * Decodes a received packet.
+ ******************************************************************************/
+bool decode_packet(const uint8_t *buffer, uint16_t length, packet_t *packet){
+	if(length <= PKTIDX_FIELDS || buffer[PKTIDX_LENGTH] != length - 1 || (buffer[PKTIDX_HEADER] >> 4) != PACKET_VERSION)
+		return false;
+	memset(packet, 0, sizeof(*packet));
+	packet->type = (message_t) PACKET_TYPE(buffer);
+	packet->src = buffer[PKTIDX_SRC];
+	packet->dst = buffer[PKTIDX_DST];
+	uint16_t fields = length - PKTIDX_FIELDS;
+	if(!fields_length(packet->type, false, false, false)) //an unknown type
+		return false;
+	if(fields != fields_length(packet->type, false, false, false)){ //the optional fields are inferred from the length
+		if(fields == fields_length(packet->type, true, false, false))
+			packet->tdma = true;
+		else if(fields == fields_length(packet->type, false, true, false))
+			packet->has_state = true;
+		else if(fields == fields_length(packet->type, false, false, true))
+			packet->has_weight = true;
+		else if(fields == fields_length(packet->type, true, false, true))
+			packet->tdma = packet->has_weight = true;
+		else if(fields == fields_length(packet->type, false, true, true))
+			packet->has_state = packet->has_weight = true;
+		else
+			return false;
+	}
+
+	const uint8_t *f = &buffer[PKTIDX_FIELDS];
+	switch(packet->type){
+	case MSG_RESTART:
+		packet->restart_id = f[0];
+		packet->origin = f[1];
+		break;
+	case MSG_START_TASK:
+		packet->task = f[0];
+		packet->origin = f[1];
+		if(packet->tdma){
+			packet->timestamp = read_u32(&f[2]);
+			packet->epoch = read_u32(&f[6]);
+		}
+		break;
+	case MSG_CONSENSUS_STATE:
+		packet->seq = f[0];
+		read_states(&f[1], packet->state);
+		if(packet->has_weight)
+			packet->weight = read_weight(&f[1+VECTOR_BYTES]);
+		if(packet->tdma)
+			packet->quiet_frames = f[1+VECTOR_BYTES+(packet->has_weight ? WEIGHT_BYTES : 0)];
+		break;
+	case MSG_BATON:
+		packet->seq = f[0];
+		packet->boards_over = (int8_t) f[1];
+		if(packet->has_state)
+			read_states(&f[2], packet->state);
+		if(packet->has_weight)
+			packet->weight = read_weight(&f[2+VECTOR_BYTES]);
+		break;
+	case MSG_LINKS:
+		packet->owner = f[0];
+		for(int i=0;i<LINKS_BYTES;i++){
+			packet->links |= (uint32_t) f[1+i] << (8*i);
+			packet->audible |= (uint32_t) f[1+LINKS_BYTES+i] << (8*i);
+		}
+		break;
+	case MSG_ACK:
+		packet->seq = f[0];
+		break;
+	case MSG_GOSSIP:
+		packet->seq = f[0];
+		packet->gossip = f[1];
+		packet->quiet_frames = f[2];
+		read_states(&f[3], packet->state);
+		if(packet->gossip > GOSSIP_STOP) //an unknown kind
+			return false;
+		break;
+	default:
+		break;
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * Rounds a state to the nearest value which can be encoded.
+ ******************************************************************************/
+float quantize_state(float state){
+	if(STATE_ENCODING==STATE_HALF)
+		return half_to_float(float_to_half(state));
+	if(STATE_ENCODING==STATE_FIXED)
+		return fixed_to_float(float_to_fixed(state));
+	return state;
+}
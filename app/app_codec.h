@@ -0,0 +1,160 @@
+/***************************************************************************//**
+ * @file app_codec.h
+ * @brief Header file for the wire format of the exchanged messages: every
+ * message is described by a {@link packet_t} and encoded as a variable-length
+ * packet, with only the fields of its type. Every packet starts with its
+ * length (the length field of the radio frame), a header with the version of
+ * the layout and the type of the message, and the source & destination boards:
+ *
+ *     | length | version:4 type:4 | src | dst | fields of the type ... |
+ *
+ * The fields of every type (multi-byte fields are little-endian):
+ * - MSG_RESTART: restart id (1 byte), and the board which started the restart (1 byte).
+ * - MSG_START_TASK: task (1 byte), the board which started the task (1 byte), and in TDMA mode the RAIL time of the sender and the start of frame 0 (4 bytes each).
+ * - MSG_CONSENSUS_STATE: the sequence number (1 byte), the state (4 or 2 bytes per quantity, see {@link STATE_ENCODING} & {@link NUM_OF_QUANTITIES}), with push-sum the weight (4 bytes, see {@link CONSENSUS_PUSH_SUM}), and in TDMA mode the quiet frames (1 byte).
+ * - MSG_BATON: the sequence number (1 byte), the boards which agree to terminate the algorithm (1 byte, signed), and optionally the state of the sender (4 or 2 bytes per quantity), which its neighbors overhear, followed with push-sum by its weight (4 bytes).
+ * - MSG_LINKS: the board whose links are carried (1 byte), the boards which it heard well enough during the discovery of the graph, and the boards which it heard at all (bitmasks of {@link LINKS_BYTES} bytes each).
+ * - MSG_ACK: the sequence number of the acknowledged message (1 byte).
+ * - MSG_GOSSIP: the sequence number (1 byte), the kind of the message (1 byte, see {@link gossip_kind_t}), the quiet hops of the sender (1 byte), and its state (4 or 2 bytes per quantity).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_CODEC_H
+#define APP_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+
+///The version of the layout of the packets, carried by every packet. A packet of another version is dropped by its receivers.
+#define PACKET_VERSION 4
+
+///The maximum length of an encoded packet (including its length field), i.e., of a start message in TDMA mode, or of a state with the weight of push-sum in TDMA mode (10 bytes and 4 per quantity, when the states are 32-bit floats) if longer.
+#define MAX_PACKET_LENGTH (10 + 4*NUM_OF_QUANTITIES > 14 ? 10 + 4*NUM_OF_QUANTITIES : 14)
+
+///The maximum length of a frame which the radio accepts (including its length field), i.e., var_length_maxlength of config/rail/radio_settings.radioconf plus 1, which has to change with it.
+#define RADIO_MAX_PACKET_LENGTH 18
+
+#if MAX_PACKET_LENGTH > RADIO_MAX_PACKET_LENGTH
+#error "The longest packet does not fit in a frame of the radio configuration (var_length_maxlength of radio_settings.radioconf)."
+#endif
+
+///The length of the bitmask of a {@link MSG_LINKS} message (one bit per board).
+#define LINKS_BYTES ((MAX_NUM_OF_BOARDS+7)/8)
+
+#if MAX_NUM_OF_BOARDS > 32
+#error "The links of a board are kept in 32 bits (see packet_t)."
+#endif
+
+///The index of the length field in a packet, i.e., the number of bytes which follow it.
+#define PKTIDX_LENGTH 0
+///The index of the header in a packet (the version in the upper 4 bits, the type in the lower 4 bits).
+#define PKTIDX_HEADER 1
+///The index of the source board in a packet.
+#define PKTIDX_SRC 2
+///The index of the destination board in a packet.
+#define PKTIDX_DST 3
+///The index of the first field of the type of the message in a packet.
+#define PKTIDX_FIELDS 4
+
+///The type of the message of an encoded packet (e.g., for the statistics of the host simulator).
+#define PACKET_TYPE(packet) ((packet)[PKTIDX_HEADER] & 0x0F)
+
+/** The various types of messages exchanged between the boards.
+ * - MSG_RESTART: A message indicating that the system is restarting at the moment.
+ * - MSG_START_TASK: A message indicating that the system is starting a new task at the moment.
+ * - MSG_CONSENSUS_STATE: A message with another board's current state.
+ * - MSG_BATON: A message with the baton.
+ * - MSG_LINKS: A message with the links which a board measured during the discovery of the graph (relayed by every board).
+ * - MSG_ACK: The acknowledgment of a message of type MSG_CONSENSUS_STATE, MSG_BATON or MSG_GOSSIP, sent by the auto-ACK of the radio of its receiver (see {@link USE_ACKS}).
+ * - MSG_GOSSIP: A message of a pairwise exchange of the randomized gossip (see app_gossip.h).
+ */
+typedef enum {
+	MSG_RESTART,
+	MSG_START_TASK,
+	MSG_CONSENSUS_STATE,
+	MSG_BATON,
+	MSG_LINKS,
+	MSG_ACK,
+	MSG_GOSSIP
+} message_t;
+
+///The number of types of messages.
+#define NUM_OF_MSG_TYPES (MSG_GOSSIP+1)
+
+/** The kinds of the messages of type {@link MSG_GOSSIP}.
+ * - GOSSIP_REQUEST: A board asks a neighbor to average their states, and sends its own.
+ * - GOSSIP_REPLY: The neighbor accepts, and sends its state before the averaging.
+ * - GOSSIP_BUSY: The neighbor refuses, since it waits for the reply to its own request.
+ * - GOSSIP_STOP: The sender has stopped, and its neighbors stop too (it is sent to all of them, and again to a neighbor whose request arrives after the stop).
+ */
+typedef enum {
+	GOSSIP_REQUEST,
+	GOSSIP_REPLY,
+	GOSSIP_BUSY,
+	GOSSIP_STOP
+} gossip_kind_t;
+
+///A decoded message. Only the fields of its type are encoded (the TDMA fields only if {@link tdma} is true, the state of a baton only if {@link has_state} is true, the weight only if {@link has_weight} is true).
+typedef struct {
+	message_t type;               ///< The type of the message.
+	uint8_t src;                  ///< The source board.
+	uint8_t dst;                  ///< The destination board (or {@link app_network#BROADCAST_ADDRESS BROADCAST_ADDRESS}).
+	bool tdma;                    ///< True if the message carries the fields of the TDMA mode.
+	uint8_t seq;                  ///< MSG_CONSENSUS_STATE, MSG_BATON & MSG_GOSSIP: the sequence number of the message, which its receiver uses to drop a retransmitted copy. MSG_ACK: the sequence number of the acknowledged message.
+	uint8_t restart_id;           ///< MSG_RESTART: the restart id (see {@link app_tools#restart_id restart_id}).
+	uint8_t task;                 ///< MSG_START_TASK: the task which starts.
+	uint8_t origin;               ///< MSG_RESTART & MSG_START_TASK: the board which started the restart or the task, i.e., the origin of the flood which relays the message (see app_routing.h).
+	uint32_t timestamp;           ///< MSG_START_TASK (TDMA): the RAIL time of the sender.
+	uint32_t epoch;               ///< MSG_START_TASK (TDMA): the start of frame 0, in the RAIL time of the sender.
+	float state[NUM_OF_QUANTITIES]; ///< MSG_CONSENSUS_STATE & MSG_GOSSIP: the state of the sender, one element per quantity (with push-sum, the running sums of the states which it has pushed, see app_consensus.h).
+	bool has_weight;              ///< MSG_CONSENSUS_STATE & MSG_BATON (with its state): true if the message carries the {@link weight} of the sender (push-sum).
+	float weight;                 ///< MSG_CONSENSUS_STATE & MSG_BATON: the running sum of the weights which the sender has pushed (push-sum, one for all the quantities), always sent as a 32-bit float.
+	uint8_t quiet_frames;         ///< MSG_CONSENSUS_STATE (TDMA): the consecutive frames for which the neighborhood of the sender has been below the STOP_THRESHOLD. MSG_GOSSIP: the quiet hops of the sender (see app_gossip.h).
+	int8_t boards_over;           ///< MSG_BATON: the number of boards which agree to terminate the algorithm.
+	bool has_state;               ///< MSG_BATON: true if the baton carries the {@link state} of the sender.
+	uint8_t owner;                ///< MSG_LINKS: the board which measured the {@link links}.
+	uint32_t links;               ///< MSG_LINKS: bit j is set if the owner heard board j well enough during the discovery.
+	uint32_t audible;             ///< MSG_LINKS: bit j is set if the owner heard board j at all during the discovery.
+	uint8_t gossip;               ///< MSG_GOSSIP: the kind of the message (see {@link gossip_kind_t}).
+} packet_t;
+
+/** Returns the length of the encoded packet of a message.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ * @return The length of the packet (including its length field), or 0 if the type of the message is invalid.
+ */
+uint8_t packet_length(const packet_t *packet);
+
+/** Encodes a message to a packet.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ * @param buffer A buffer for the packet, of at least {@link MAX_PACKET_LENGTH} bytes.
+ * @return The length of the packet (including its length field), or 0 if the type of the message is invalid.
+ */
+uint8_t encode_packet(const packet_t *packet, uint8_t *buffer);
+
+/** Decodes a received packet. The packet is rejected if its length does not
+ * match its length field and its type, if it has another version, or if it is
+ * a gossip message of an unknown kind.
+ *
+ * @date 16/10/2026
+ * @param buffer The received packet.
+ * @param length The length of the received packet.
+ * @param packet The decoded message (undefined if the packet is rejected).
+ * @return True if the packet is valid.
+ */
+bool decode_packet(const uint8_t *buffer, uint16_t length, packet_t *packet);
+
+/** Rounds a state to the nearest value which can be encoded (see
+ * {@link STATE_ENCODING}). A board keeps its own state rounded, so that its
+ * neighbors compute with exactly the state it computes with.
+ *
+ * @date 16/10/2026
+ * @param state The state.
+ * @return The state which its receivers decode.
+ */
+float quantize_state(float state);
+
+#endif  // APP_CODEC_H
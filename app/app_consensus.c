@@ -7,21 +7,207 @@
 #include "app_consensus.h"
 #include "app_log.h"
 #include "app_tools.h"
+#include "app_codec.h"
+#include <math.h>
+#include <string.h>
 
-///These weights are used by the algorithm to update the current board's state.
-static float weights[NUM_OF_BOARDS];
+///The weights of all boards (row i contains the weights used by board i to update its state).
+static float weights[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
 
-/** Initializes the weights array, required for the update of this board's state.
+///The convergence rate of the plain update on the current graph, used by the accelerated update rules (see {@link consensus_rate()}).
+static float convergence_rate;
+
+///The state of this board at the previous iteration (the memory term of the accelerated update rules).
+static float previous_state[NUM_OF_QUANTITIES];
+
+///The coefficient c(k) of the Chebyshev update rule at the current iteration (see {@link next_chebyshev_coefficient()}).
+static float chebyshev_coef;
+
+///The number of iterations of the power method in {@link largest_eigenvalue()}.
+#define RATE_ITERATIONS 300
+
+///The relative tolerance under which a vector is considered linearly dependent on the previous ones in {@link finite_time_polynomial()}.
+#define DEPENDENCE_TOLERANCE 1e-9
+
+///The relative precision of the states, which are computed & exchanged as floats. It limits the degree of the polynomials in {@link finite_time_polynomial()}.
+#define STATE_PRECISION 1e-7
+
+///The states of this board at iterations 0, 1, ..., {@link finite_time_iters} (used by {@link CONSENSUS_FINITE_TIME}), for every quantity.
+static float state_history[NUM_OF_QUANTITIES][MAX_NUM_OF_BOARDS+1];
+
+///The coefficients of the minimal polynomial of this board (see {@link finite_time_polynomial()}).
+static double finite_time_coefs[MAX_NUM_OF_BOARDS+1];
+
+///The degree of the minimal polynomial of this board.
+static uint8_t finite_time_degree;
+
+///The sums of this board (one per quantity), when {@link CONSENSUS_UPDATE} equals to {@link CONSENSUS_PUSH_SUM} (after it pushed the shares of its last update).
+static float push_sum[NUM_OF_QUANTITIES];
+
+///The weight of this board (push-sum), which is shared by all the quantities.
+static float push_weight;
+
+///The running sums of the shares of the sums which every board has pushed to each board which receives it, as last received (those of this board at board_id).
+static float pushed_sums[MAX_NUM_OF_BOARDS][NUM_OF_QUANTITIES];
+
+///The running sums of the shares of the weights which every board has pushed, as last received.
+static float pushed_weights[MAX_NUM_OF_BOARDS];
+
+///The running sums of the sums of every board which this board has already added to its own sums.
+static float consumed_sums[MAX_NUM_OF_BOARDS][NUM_OF_QUANTITIES];
+
+///The running sums of the weights of every board which this board has already added to its own weight.
+static float consumed_weights[MAX_NUM_OF_BOARDS];
+
+///The readings of this board which its state accounts for (see {@link track_measurements()}): the initial state, plus every change of a reading which has been added to the state since.
+static float tracked_readings[NUM_OF_QUANTITIES];
+
+///The state of this board at the end of its last run (see {@link USE_WARM_START}), valid if {@link result_kept} is true.
+static float kept_state[NUM_OF_QUANTITIES];
+
+///The readings which the {@link kept_state} accounts for.
+static float kept_readings[NUM_OF_QUANTITIES];
+
+///True if the result of the last run of this board has been kept.
+static bool result_kept;
+
+/** Computes the largest eigenvalue (in absolute value) of a symmetric matrix
+ * with the power method, restricted to the vectors which are orthogonal to the
+ * vector of ones (i.e., the component along the vector of ones is removed at
+ * every step).
+ *
+ * @date 16/10/2026
+ * @param m The matrix (only the first {@link num_of_boards} rows & columns are used).
+ * @return The absolute value of the eigenvalue.
+ */
+static float largest_eigenvalue(const float m[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	float v[MAX_NUM_OF_BOARDS], u[MAX_NUM_OF_BOARDS];
+	float result = 0;
+
+	for(int i=0;i<num_of_boards;i++)
+		v[i] = i + 1.0/(i+1); //any vector which is not orthogonal to the slowest mode
+
+	for(int it=0;it<RATE_ITERATIONS;it++){
+		float mean = 0, norm_v = 0, norm_u = 0;
+		for(int i=0;i<num_of_boards;i++)
+			mean += v[i]/num_of_boards;
+		for(int i=0;i<num_of_boards;i++){
+			v[i] -= mean;
+			norm_v += v[i]*v[i];
+		}
+		for(int i=0;i<num_of_boards;i++){
+			u[i] = 0;
+			for(int j=0;j<num_of_boards;j++)
+				u[i] += m[i][j]*v[j];
+			norm_u += u[i]*u[i];
+		}
+		if(norm_v==0 || norm_u==0)
+			return 0;
+		result = sqrtf(norm_u/norm_v);
+		for(int i=0;i<num_of_boards;i++)
+			v[i] = u[i]/sqrtf(norm_u);
+	}
+	return result;
+}
+
+/** Computes the constant edge weight of the best-constant weights,
+ * 2/(l_1+l_{n-1}), where l_1 and l_{n-1} are the largest and the second
+ * smallest eigenvalues of the Laplacian matrix L of the {@link graph}.
+ *
+ * @date 16/10/2026
+ * @param deg The degree of every board.
+ * @return The weight of every edge.
+ */
+static float best_constant_weight(const int *deg){
+	static float m[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	float l_max, l_2;
+
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=0;j<num_of_boards;j++)
+			m[i][j] = (i==j) ? deg[i] : (graph[i][j] ? -1 : 0);
+	l_max = largest_eigenvalue(m);
+
+	//The largest eigenvalue of l_max*I - L (orthogonally to the vector of ones) is l_max - l_{n-1}
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=0;j<num_of_boards;j++)
+			m[i][j] = (i==j) ? l_max - m[i][j] : -m[i][j];
+	l_2 = l_max - largest_eigenvalue(m);
+
+	if(l_max+l_2<=0) //a single board
+		return 0;
+	return 2.0/(l_max+l_2);
+}
+
+/** Returns whether the {@link default_weights} can be used on the current
+ * {@link graph}, i.e., whether it is the default graph.
+ *
+ * @date 16/10/2026
+ * @return True if the graph is the default one.
+ */
+static bool default_weights_apply(){
+	if(num_of_boards!=DEFAULT_NUM_OF_BOARDS)
+		return false;
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=0;j<num_of_boards;j++)
+			if(graph[i][j]!=default_graph[i][j])
+				return false;
+	return true;
+}
+
+/** Pushes the shares of push-sum: this board keeps a share 1/(d+1) of its sum &
+ * weight, and adds a share to the running sums which it sends to the d boards
+ * that receive it (according to the {@link directed_graph}).
  *
- * @date 01/02/2023
+ * @date 16/10/2026
  */
-static void initialize_weights(){
-    int deg[NUM_OF_BOARDS]; //the degree of each node of the graph
+static void push_shares(){
+	int receivers = 0;
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && directed_graph[j][board_id])
+			receivers++;
+	for(int q=0;q<NUM_OF_QUANTITIES;q++){
+		push_sum[q] /= receivers+1;
+		pushed_sums[board_id][q] += push_sum[q];
+	}
+	push_weight /= receivers+1;
+	pushed_weights[board_id] += push_weight;
+}
+
+/** Collects the shares of push-sum: this board adds to its sum & weight the
+ * shares which every board that it receives pushed since the last collection
+ * (the difference of the running sums, so that the shares of a lost message
+ * are collected with the next one).
+ *
+ * @date 16/10/2026
+ * @param next_state The array where the state of this board is stored, i.e.,
+ * the ratio of each of its sums to its weight.
+ */
+static void collect_shares(float *next_state){
+	for(int j=0;j<num_of_boards;j++){
+		if(j!=board_id && directed_graph[board_id][j]){
+			for(int q=0;q<NUM_OF_QUANTITIES;q++){
+				push_sum[q] += pushed_sums[j][q]-consumed_sums[j][q];
+				consumed_sums[j][q] = pushed_sums[j][q];
+			}
+			push_weight += pushed_weights[j]-consumed_weights[j];
+			consumed_weights[j] = pushed_weights[j];
+		}
+	}
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		next_state[q] = push_sum[q]/push_weight;
+}
+
+/*******************************************************************************
+ * Computes the weights of all boards, according to a weight policy.
+ ******************************************************************************/
+void consensus_weights(uint8_t policy, float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+    int deg[MAX_NUM_OF_BOARDS]; //the degree of each node of the graph
     int gr_deg = 0; //the degree of the graph
+    float edge_weight = 0; //the weight of every edge (for the policies with a constant one)
 
-    for(int i=0;i<NUM_OF_BOARDS;i++){
+    for(int i=0;i<num_of_boards;i++){
         deg[i] = 0;
-        for(int j=0;j<NUM_OF_BOARDS;j++){
+        for(int j=0;j<num_of_boards;j++){
             if(graph[i][j] && i!=j)
                 deg[i]++;
         }
@@ -29,13 +215,142 @@ static void initialize_weights(){
             gr_deg = deg[i];
     }
 
-	for(int j=0;j<NUM_OF_BOARDS;j++){
-		if(!graph[BOARD_ID][j])
-			weights[j] = 0;
-		else if(j==BOARD_ID)
-			weights[j] = 1.0 - deg[BOARD_ID]/(1.0*(gr_deg+1));
-		else
-			weights[j] = 1.0/(gr_deg+1);
+	if(policy==WEIGHTS_CONFIGURED && !default_weights_apply()){
+		app_log_warning("The configured weights are only valid for the default graph. Metropolis-Hastings weights will be used.\n");
+		policy = WEIGHTS_METROPOLIS;
+	}
+	if(policy==WEIGHTS_BEST_CONSTANT)
+		edge_weight = best_constant_weight(deg);
+	else
+		edge_weight = 1.0/(gr_deg+1);
+
+	for(int i=0;i<num_of_boards;i++){
+		float self = 1;
+		for(int j=0;j<num_of_boards;j++){
+			if(!graph[i][j] || j==i)
+				w[i][j] = 0;
+			else if(policy==WEIGHTS_METROPOLIS)
+				w[i][j] = 1.0/(1 + (deg[i]>deg[j] ? deg[i] : deg[j]));
+			else if(policy==WEIGHTS_CONFIGURED)
+				w[i][j] = default_weights[i][j];
+			else
+				w[i][j] = edge_weight;
+			self -= w[i][j];
+		}
+		w[i][i] = self; //every row sums to 1, so that the average is preserved
+	}
+}
+
+/*******************************************************************************
+ * Computes the convergence rate of the plain update with a weight matrix.
+ ******************************************************************************/
+float consensus_rate(const float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	//The largest eigenvalue of W - 11'/n, i.e., of W orthogonally to the vector of ones (the average)
+	return largest_eigenvalue(w);
+}
+
+/*******************************************************************************
+ * Computes the minimal polynomial of a board.
+ ******************************************************************************/
+uint8_t finite_time_polynomial(const float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], float rate, uint8_t board, double *coefs){
+	static double q[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]; //the orthonormal basis of the vectors r_0, r_1, ...
+	static double r[MAX_NUM_OF_BOARDS+1][MAX_NUM_OF_BOARDS+1]; //r[m][k] is the component of r_k along q_m
+	double a[MAX_NUM_OF_BOARDS+1], v[MAX_NUM_OF_BOARDS], u[MAX_NUM_OF_BOARDS];
+	double best_error = INFINITY, gap = (rate<1-1e-6) ? 1-rate : 1e-6;
+	uint8_t best = 0;
+	int n = num_of_boards;
+
+	coefs[0] = 1;
+	for(int j=0;j<n;j++) //r_0 = e_i'(W-I)
+		v[j] = w[board][j] - (j==board);
+	for(int d=0;d<=n;d++){
+		double norm = 0, residual = 0;
+		for(int j=0;j<n;j++){
+			norm += v[j]*v[j];
+			u[j] = v[j];
+		}
+		for(int pass=0;pass<2;pass++){ //modified Gram-Schmidt, twice for stability
+			for(int m=0;m<d;m++){
+				double dot = 0;
+				for(int j=0;j<n;j++)
+					dot += u[j]*q[m][j];
+				r[m][d] = pass ? r[m][d]+dot : dot;
+				for(int j=0;j<n;j++)
+					u[j] -= dot*q[m][j];
+			}
+		}
+		for(int j=0;j<n;j++)
+			residual += u[j]*u[j];
+
+		//The candidate of degree d: r_d minus its projection on r_0, ..., r_{d-1}, i.e., t^d - sum of c_k t^k with R c = r[.][d]
+		double p1 = 1, abs_sum = 1;
+		a[d] = 1;
+		for(int k=d-1;k>=0;k--){
+			double c = r[k][d];
+			for(int m=k+1;m<d;m++)
+				c += r[k][m]*a[m];
+			a[k] = -c/r[k][k];
+			p1 += a[k];
+			abs_sum += fabs(a[k]);
+		}
+		//Its error: the part of r_d which is not cancelled (amplified by the slowest mode), plus the rounding errors of the states
+		double error = (sqrt(residual)/gap + STATE_PRECISION*abs_sum)/fabs(p1);
+		if(p1!=0 && error<best_error){
+			best_error = error;
+			best = d;
+			for(int k=0;k<=d;k++)
+				coefs[k] = a[k];
+		}
+		if(d==n || residual<=DEPENDENCE_TOLERANCE*DEPENDENCE_TOLERANCE*norm)
+			break;
+
+		r[d][d] = sqrt(residual);
+		for(int j=0;j<n;j++)
+			q[d][j] = u[j]/r[d][d];
+		for(int j=0;j<n;j++){ //r_{d+1} = r_d W
+			u[j] = 0;
+			for(int m=0;m<n;m++)
+				u[j] += v[m]*w[m][j];
+		}
+		for(int j=0;j<n;j++)
+			v[j] = u[j];
+	}
+	return best;
+}
+
+/*******************************************************************************
+ * Computes the exact average from the first states of a board.
+ ******************************************************************************/
+float finite_time_average(uint8_t degree, const double *coefs, const float *history){
+	double sum = 0, weight = 0;
+	for(int k=0;k<=degree;k++){
+		sum += coefs[k]*history[k];
+		weight += coefs[k];
+	}
+	return sum/weight;
+}
+
+/*******************************************************************************
+ * Advances the coefficient of the Chebyshev update rule by one iteration.
+ ******************************************************************************/
+float next_chebyshev_coefficient(float coef, float rate){
+	if(coef==1) //c(1) = 2/(2-r^2), and c(k) = 1/(1-r^2 c(k-1)/4) after it (every c(k) is larger than c(0) = 1, unless r = 0)
+		return 2.0/(2.0 - rate*rate);
+	return 1.0/(1.0 - rate*rate*coef/4.0);
+}
+
+/*******************************************************************************
+ * Computes the next state of a board according to an update rule.
+ ******************************************************************************/
+float next_consensus_state(uint8_t rule, float coef, float rate, float wx, float x_prev){
+	switch(rule){
+	case CONSENSUS_SECOND_ORDER:{
+		float b = 2.0/(1.0 + sqrtf(1.0 - rate*rate));
+		return b*wx + (1.0-b)*x_prev;}
+	case CONSENSUS_CHEBYSHEV:
+		return coef*(wx - x_prev) + x_prev;
+	default:
+		return wx;
 	}
 }
 
@@ -48,10 +363,44 @@ void initialize_consensus_setup(){
 		return;
 	}
 
-	initialize_weights();
+	consensus_weights(CONSENSUS_WEIGHTS, weights);
+	convergence_rate = (CONSENSUS_UPDATE==CONSENSUS_FIRST_ORDER || CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM) ? 0 : consensus_rate(weights);
 	consensus_iters = 0;
+	chebyshev_coef = 1;
 
-	consensus_states[BOARD_ID] = temperature;
+	if(CONSENSUS_UPDATE==CONSENSUS_FINITE_TIME){ //The run lasts until every board has enough states for its own polynomial
+		static double coefs[MAX_NUM_OF_BOARDS+1];
+		finite_time_iters = 0;
+		for(int i=0;i<num_of_boards;i++){
+			uint8_t degree = finite_time_polynomial(weights, convergence_rate, i, (i==board_id) ? finite_time_coefs : coefs);
+			if(i==board_id)
+				finite_time_degree = degree;
+			if(degree>finite_time_iters)
+				finite_time_iters = degree;
+		}
+	}
+
+	bool warm = USE_WARM_START && result_kept;
+	if(warm)
+		app_log_info("Starting from the result of the last run.\n");
+	for(int q=0;q<NUM_OF_QUANTITIES;q++){
+		float reading = q==QUANTITY_HUMIDITY ? humidity : temperature;
+		float start = warm ? kept_state[q]+reading-kept_readings[q] : reading;
+		consensus_states[board_id][q] = quantize_state(start); //The neighbors receive the encoded state (see app_codec.h)
+		previous_state[q] = consensus_states[board_id][q];
+		tracked_readings[q] = reading+consensus_states[board_id][q]-start;
+	}
+	if(CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM){ //Nothing has been pushed or received yet, and the first message carries the first shares
+		for(int i=0;i<MAX_NUM_OF_BOARDS;i++){
+			pushed_weights[i] = consumed_weights[i] = 0;
+			for(int q=0;q<NUM_OF_QUANTITIES;q++)
+				pushed_sums[i][q] = consumed_sums[i][q] = 0;
+		}
+		for(int q=0;q<NUM_OF_QUANTITIES;q++)
+			push_sum[q] = consensus_states[board_id][q];
+		push_weight = 1;
+		push_shares();
+	}
 	//The states of the other boards do not need initialization.
 	//They will be set when a message from those boards will be received.
 }
@@ -60,9 +409,117 @@ void initialize_consensus_setup(){
  * It updates the state of this board.
  ******************************************************************************/
 void update_consensus_state(){
-	float next_state = 0;
-	for(int i=0;i<NUM_OF_BOARDS;i++)
-		next_state += weights[i]*consensus_states[i];
-	consensus_states[BOARD_ID] = next_state;
+	float next_state[NUM_OF_QUANTITIES] = { 0 };
+	if(CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM)
+		collect_shares(next_state);
+	else {
+		for(int q=0;q<NUM_OF_QUANTITIES;q++){ //The same weights for every quantity
+			for(int i=0;i<num_of_boards;i++)
+				next_state[q] += weights[board_id][i]*consensus_states[i][q];
+			next_state[q] = next_consensus_state(CONSENSUS_UPDATE, chebyshev_coef, convergence_rate, next_state[q], previous_state[q]);
+		}
+	}
+	for(int q=0;q<NUM_OF_QUANTITIES;q++){
+		if(consensus_iters<=MAX_NUM_OF_BOARDS)
+			state_history[q][consensus_iters] = consensus_states[board_id][q];
+		previous_state[q] = consensus_states[board_id][q];
+	}
 	consensus_iters++;
+	if(CONSENSUS_UPDATE==CONSENSUS_CHEBYSHEV)
+		chebyshev_coef = next_chebyshev_coefficient(chebyshev_coef, convergence_rate);
+
+	if(CONSENSUS_UPDATE==CONSENSUS_FINITE_TIME && consensus_iters==finite_time_iters){ //Every board has its states up to its degree: all boards switch to the exact average together
+		for(int q=0;q<NUM_OF_QUANTITIES;q++){
+			state_history[q][consensus_iters] = next_state[q];
+			next_state[q] = finite_time_average(finite_time_degree, finite_time_coefs, state_history[q]);
+		}
+		app_log_info("   - The exact average was computed from %d states.\n", finite_time_degree+1);
+	}
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		consensus_states[board_id][q] = quantize_state(next_state[q]);
+	if(CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM) //The shares of this update are sent with the next state of this board
+		push_shares();
+}
+
+/*******************************************************************************
+ * Returns the largest change of a quantity of the state of this board.
+ ******************************************************************************/
+float consensus_state_change(const float *prev_state){
+	float change = 0;
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		if(fabs(consensus_states[board_id][q]-prev_state[q])>change)
+			change = fabs(consensus_states[board_id][q]-prev_state[q]);
+	return change;
+}
+
+/*******************************************************************************
+ * Adds the changes of the readings of this board to its state.
+ ******************************************************************************/
+void track_measurements(){
+	for(int q=0;q<NUM_OF_QUANTITIES;q++){
+		float prev = consensus_states[board_id][q];
+		consensus_states[board_id][q] = quantize_state(prev+(q==QUANTITY_HUMIDITY ? humidity : temperature)-tracked_readings[q]);
+		tracked_readings[q] += consensus_states[board_id][q]-prev; //a change which the quantization dropped is added at the next sample
+	}
+}
+
+/*******************************************************************************
+ * Keeps the result of the run which has just been completed.
+ ******************************************************************************/
+void keep_consensus_result(){
+	memcpy(kept_state, consensus_states[board_id], sizeof(kept_state));
+	memcpy(kept_readings, tracked_readings, sizeof(kept_readings));
+	result_kept = true;
+}
+
+/*******************************************************************************
+ * Discards the result of the last run.
+ ******************************************************************************/
+void forget_consensus_result(){
+	result_kept = false;
+}
+
+/*******************************************************************************
+ * Prints the estimated averages of this board.
+ ******************************************************************************/
+void print_consensus_estimates(){
+	app_log_info("Estimated average temperature: %.2f degrees Celsius.\n", consensus_states[board_id][QUANTITY_TEMPERATURE]);
+#if NUM_OF_QUANTITIES > 1
+	app_log_info("Estimated average humidity: %.2f %%RH.\n", consensus_states[board_id][QUANTITY_HUMIDITY]);
+#endif
+}
+
+/*******************************************************************************
+ * Returns whether this board sends its state to another board.
+ ******************************************************************************/
+bool sends_state_to(uint8_t board){
+	return board!=board_id && board<num_of_boards
+			&& (graph[board_id][board] || (CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM && directed_graph[board][board_id]));
+}
+
+/*******************************************************************************
+ * Writes the state of this board to a message.
+ ******************************************************************************/
+void write_consensus_state(packet_t *packet){
+	if(CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM){
+		memcpy(packet->state, pushed_sums[board_id], sizeof(packet->state));
+		packet->weight = pushed_weights[board_id];
+		packet->has_weight = true;
+	}
+	else
+		memcpy(packet->state, consensus_states[board_id], sizeof(packet->state));
+}
+
+/*******************************************************************************
+ * Stores the state which another board sent with a message.
+ ******************************************************************************/
+void read_consensus_state(const packet_t *packet){
+	if(packet->src>=num_of_boards || packet->has_weight!=(CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM))
+		return;
+	if(packet->has_weight){
+		memcpy(pushed_sums[packet->src], packet->state, sizeof(packet->state));
+		pushed_weights[packet->src] = packet->weight;
+	}
+	else
+		memcpy(consensus_states[packet->src], packet->state, sizeof(packet->state));
 }
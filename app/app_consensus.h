@@ -8,14 +8,105 @@
 
 #include "rail_types.h"
 #include "app_config.h"
+#include "app_codec.h"
+
+#if CONSENSUS_UPDATE==CONSENSUS_PUSH_SUM && STATE_ENCODING!=STATE_FLOAT
+#error "The running sums of push-sum grow with every iteration, and need the precision of STATE_FLOAT."
+#endif
 
 ///The counter of the iterations. It is automatically updated by the {@link update_consensus_state()} function.
 uint8_t consensus_iters;
 
-///The knowledge of this board for the states of the other boards (used to update its state).
-float consensus_states[NUM_OF_BOARDS];
+///The number of iterations after which every board has computed the exact average, when {@link CONSENSUS_UPDATE} equals to {@link CONSENSUS_FINITE_TIME} (the maximum degree of the minimal polynomials of the boards, see {@link finite_time_polynomial()}). It is set by the {@link initialize_consensus_setup()} function.
+uint8_t finite_time_iters;
+
+///The knowledge of this board for the states of the other boards (used to update its state). consensus_states[i][q] is the quantity q of the state of board i (see {@link NUM_OF_QUANTITIES}), and every quantity is updated with the same weights. With {@link CONSENSUS_PUSH_SUM}, only the state of this board (the ratio of its sums to its weight) is kept here, since the messages carry running sums instead.
+float consensus_states[MAX_NUM_OF_BOARDS][NUM_OF_QUANTITIES];
+
+/** Computes the weights of all boards (every board computes the same ones)
+ * from the {@link graph}, according to a weight policy (see
+ * {@link CONSENSUS_WEIGHTS}). Every row sums to 1.
+ *
+ * @date 16/10/2026
+ * @param policy The weight policy.
+ * @param w The matrix where the weights are stored (w[i][j] is the weight of
+ * the state of board j in the update of board i).
+ */
+void consensus_weights(uint8_t policy, float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]);
+
+/** Computes the convergence rate of the plain update with a (symmetric) weight
+ * matrix W on the {@link graph}, i.e., the second largest eigenvalue (in
+ * absolute value) of W, with the power method. The accelerated update rules
+ * derive their parameters from it, and all boards compute the same value.
+ *
+ * @date 16/10/2026
+ * @param w The weight matrix (see {@link consensus_weights()}).
+ * @return The convergence rate, between 0 (fastest) and 1.
+ */
+float consensus_rate(const float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]);
+
+/** Computes the minimal polynomial p(t) = sum of a_k t^k (with a_d = 1) of a
+ * board for the plain update with a weight matrix W, i.e., the polynomial of the
+ * smallest degree d with e_i'(W-I)p(W) = 0. The states of the board then
+ * satisfy the recurrence of p, and the average is the weighted sum of its
+ * first d+1 states (see {@link finite_time_average()}). The degree is at most
+ * the number of distinct eigenvalues of W minus 1 (hence below
+ * {@link num_of_boards}). On large sparse graphs, the coefficients of the exact
+ * polynomial can be so large that the rounding errors of the states dominate,
+ * so the polynomial of the smallest estimated error is returned instead (i.e.,
+ * a lower degree, which is accurate but not exact).
+ *
+ * @date 16/10/2026
+ * @param w The weight matrix (see {@link consensus_weights()}).
+ * @param rate The convergence rate of W (see {@link consensus_rate()}).
+ * @param board The board.
+ * @param coefs The array where the d+1 coefficients a_0, ..., a_d are stored.
+ * @return The degree d of the polynomial.
+ */
+uint8_t finite_time_polynomial(const float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], float rate, uint8_t board, double *coefs);
+
+/** Computes the exact average from the first states of a board, i.e.,
+ * (sum of a_k x(k)) / (sum of a_k), with the coefficients of its minimal
+ * polynomial (see {@link finite_time_polynomial()}).
+ *
+ * @date 16/10/2026
+ * @param degree The degree d of the polynomial.
+ * @param coefs The coefficients of the polynomial.
+ * @param history The states x(0), ..., x(d) of the board.
+ * @return The average of the initial states of all boards.
+ */
+float finite_time_average(uint8_t degree, const double *coefs, const float *history);
+
+/** Advances the coefficient of {@link CONSENSUS_CHEBYSHEV} by one iteration,
+ * from c(k) to c(k+1), starting from c(0) = 1.
+ *
+ * @date 16/10/2026
+ * @param coef The coefficient c(k).
+ * @param rate The convergence rate of the graph (see {@link consensus_rate()}).
+ * @return The coefficient c(k+1).
+ */
+float next_chebyshev_coefficient(float coef, float rate);
 
-/** This function initializes the consensus setup. It has to be called after a
+/** Computes the next state of a board according to an update rule (see
+ * {@link CONSENSUS_UPDATE}).
+ *
+ * @date 16/10/2026
+ * @param rule The update rule.
+ * @param coef The coefficient c(k) of {@link CONSENSUS_CHEBYSHEV} at the current
+ * iteration k (see {@link next_chebyshev_coefficient()}), ignored by the other
+ * rules.
+ * @param rate The convergence rate of the graph (see {@link consensus_rate()}).
+ * @param wx The weighted sum of the current states of the board & its neighbors.
+ * @param x_prev The state of the board at the previous iteration (equal to its
+ * current state at the first update).
+ * @return The next state of the board.
+ */
+float next_consensus_state(uint8_t rule, float coef, float rate, float wx, float x_prev);
+
+/** This function initializes the consensus setup, with the measured quantities
+ * as the state of this board (or, if {@link USE_WARM_START} equals to 1, with
+ * the result of the last run corrected by the change of the measured
+ * quantities, see {@link keep_consensus_result()}). It has to be called after a
  * temperature has been measured (with the
  * {@link app_tools#measure_temperature() measure_temperature()} function).
  *
@@ -31,4 +122,77 @@ void initialize_consensus_setup(); //Has to be called after a temperature has be
  */
 void update_consensus_state();
 
+/** Returns the largest change of a quantity of the state of this board, since
+ * a previous state (e.g., by an update), which is compared with the
+ * {@link STOP_THRESHOLD}.
+ *
+ * @date 16/10/2026
+ * @param prev_state The quantities of the previous state.
+ * @return The largest absolute difference of a quantity.
+ */
+float consensus_state_change(const float *prev_state);
+
+/** Adds the changes of the readings of this board (see
+ * {@link app_tools#measure_temperature() measure_temperature()}) since the
+ * last call (or since {@link initialize_consensus_setup()}) to its state, for
+ * the tracking of a changing average (see app_gossip.h). The sum of the states
+ * then follows the sum of the current readings, hence their average tracks the
+ * current average, and the exchanges only have to spread the changes.
+ *
+ * @date 16/10/2026
+ */
+void track_measurements();
+
+/** Keeps the state of this board at the end of a completed run, and the
+ * readings which it accounts for, as the start of the next run (see
+ * {@link USE_WARM_START}).
+ *
+ * @date 16/10/2026
+ */
+void keep_consensus_result();
+
+/** Discards the result of the last run, e.g., when the topology changes, so
+ * that the next run starts from the readings of this board.
+ *
+ * @date 16/10/2026
+ */
+void forget_consensus_result();
+
+/** Prints the estimated averages of this board (i.e., its state) to the
+ * console, one line per quantity.
+ *
+ * @date 16/10/2026
+ */
+void print_consensus_estimates();
+
+/** Returns whether this board sends its state to another board: to its
+ * neighbors in the {@link graph}, and with {@link CONSENSUS_PUSH_SUM} also to
+ * the boards which receive it over a one-way link (see {@link directed_graph}).
+ *
+ * @date 16/10/2026
+ * @param board The other board.
+ * @return True if the other board needs the state of this board.
+ */
+bool sends_state_to(uint8_t board);
+
+/** Writes the state of this board to a message of type
+ * {@link app_codec#message_t MSG_CONSENSUS_STATE} or
+ * {@link app_codec#message_t MSG_BATON}: with {@link CONSENSUS_PUSH_SUM}, the
+ * running sums of the sums & the weights which it has pushed, otherwise its
+ * state.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ */
+void write_consensus_state(packet_t *packet);
+
+/** Stores the state which another board sent with a message (see
+ * {@link write_consensus_state()}). A message without the weight is ignored
+ * with {@link CONSENSUS_PUSH_SUM}, and a message with it is ignored otherwise.
+ *
+ * @date 16/10/2026
+ * @param packet The received message.
+ */
+void read_consensus_state(const packet_t *packet);
+
 #endif  // APP_CONSENSUS_H
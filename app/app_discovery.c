@@ -0,0 +1,164 @@
+/***************************************************************************//**
+ * @file app_discovery.c
+ * @brief Implementation file for the discovery of the graph.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_discovery.h"
+#include <string.h>
+#include "rail.h"
+#include "app_log.h"
+#include "app_tdma.h"
+#include "app_topology.h"
+
+///The number of beacons which this board received from every board during the beacon frames.
+static uint8_t beacons[MAX_NUM_OF_BOARDS];
+
+///The sum of the RSSI (in dBm) of the beacons which this board received from every board.
+static int32_t rssi_sum[MAX_NUM_OF_BOARDS];
+
+///The links of every board (bit j of links[i] is set if board i heard board j), valid if {@link known} is true.
+static uint32_t links_of[MAX_NUM_OF_BOARDS];
+
+///The boards which every board heard at all (bit j of audible_of[i] is set if board i received a beacon of board j), valid if {@link known} is true.
+static uint32_t audible_of[MAX_NUM_OF_BOARDS];
+
+///True for the boards whose links are known to this board.
+static bool known[MAX_NUM_OF_BOARDS];
+
+///The number of times that this board has broadcast the links of every board.
+static uint8_t sends[MAX_NUM_OF_BOARDS];
+
+///The boards whose links are known, in the order they became known.
+static uint8_t order[MAX_NUM_OF_BOARDS];
+
+///The number of boards in {@link order}.
+static uint8_t num_known;
+
+/** Returns whether this board heard another board well enough during the
+ * beacon frames.
+ *
+ * @date 16/10/2026
+ * @param j The other board.
+ * @return True if the link from the other board passes the thresholds.
+ */
+static bool heard(int j){
+	return beacons[j]>=DISCOVERY_MIN_BEACONS && rssi_sum[j]>=(int32_t) DISCOVERY_MIN_RSSI*beacons[j];
+}
+
+/** Stores the links of a board, if they are not known yet.
+ *
+ * @date 16/10/2026
+ * @param owner The board which measured the links.
+ * @param links The links.
+ * @param heard_at_all The boards which the owner heard at all.
+ */
+static void store_links(uint8_t owner, uint32_t links, uint32_t heard_at_all){
+	if(known[owner])
+		return;
+	known[owner] = true;
+	links_of[owner] = links;
+	audible_of[owner] = heard_at_all | links;
+	order[num_known++] = owner;
+}
+
+/** Stores the links of this board, once its beacons have been counted (i.e.,
+ * when the exchange of the links starts), so that they are sent first.
+ *
+ * @date 16/10/2026
+ */
+static void measure_links(){
+	uint32_t links = 0, heard_at_all = 0;
+	for(int j=0;j<num_of_boards;j++){
+		if(j!=board_id && heard(j))
+			links |= 1UL << j;
+		if(j!=board_id && beacons[j])
+			heard_at_all |= 1UL << j;
+	}
+	store_links(board_id, links, heard_at_all);
+}
+
+/*******************************************************************************
+ * Starts the discovery on this board.
+ ******************************************************************************/
+void start_discovery(){
+	memset(beacons, 0, sizeof(beacons));
+	memset(rssi_sum, 0, sizeof(rssi_sum));
+	memset(known, 0, sizeof(known));
+	memset(sends, 0, sizeof(sends));
+	num_known = 0;
+	initialize_tdma_without_graph();
+}
+
+/*******************************************************************************
+ * Records a beacon received in a frame of the discovery.
+ ******************************************************************************/
+void record_beacon(uint8_t src, int frame, int8_t rssi){
+	if(frame<0 || frame>=DISCOVERY_BEACONS || src>=num_of_boards || src==board_id || rssi==RAIL_RSSI_INVALID_DBM)
+		return;
+	beacons[src]++;
+	rssi_sum[src] += rssi;
+}
+
+/*******************************************************************************
+ * Records the links of a board.
+ ******************************************************************************/
+void record_links(uint8_t owner, uint32_t links, uint32_t heard_at_all){
+	if(owner>=num_of_boards)
+		return;
+	if(!known[board_id])
+		measure_links();
+	store_links(owner, links, heard_at_all);
+}
+
+/*******************************************************************************
+ * Selects the links to be broadcast in the slot of this board.
+ ******************************************************************************/
+void next_links(uint8_t *owner, uint32_t *links, uint32_t *heard_at_all){
+	if(!known[board_id])
+		measure_links();
+	int best = order[0];
+	for(int k=1;k<num_known;k++)
+		if(sends[order[k]]<sends[best])
+			best = order[k];
+	sends[best]++;
+	*owner = best;
+	*links = links_of[best];
+	*heard_at_all = audible_of[best];
+}
+
+/*******************************************************************************
+ * Completes the discovery.
+ ******************************************************************************/
+bool finish_discovery(){
+	static bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	if(!known[board_id])
+		measure_links();
+
+	app_log_info("Links measured by this board (%d beacons per board):\n", DISCOVERY_BEACONS);
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && beacons[j])
+			app_log_info("  Board %d: %d beacons, mean RSSI %ld dBm%s\n", j, beacons[j], (long)(rssi_sum[j]/beacons[j]), heard(j) ? "" : " (excluded)");
+
+	if(num_known<num_of_boards){
+		app_log_error("Error. The links of boards ");
+		for(int i=0;i<num_of_boards;i++)
+			if(!known[i])
+				app_log_error("%d ", i);
+		app_log_error("were not received. The topology remains unchanged (try 'discover' again).\n");
+		return false;
+	}
+	for(int i=0;i<num_of_boards;i++){
+		for(int j=0;j<num_of_boards;j++){
+			g[i][j] = i==j || (((links_of[i] >> j) & 1) && ((links_of[j] >> i) & 1));
+			d[i][j] = i==j || ((links_of[i] >> j) & 1); //a one-way link, if board j did not hear board i well
+			a[i][j] = i==j || ((audible_of[i] >> j) & 1) || ((audible_of[j] >> i) & 1);
+		}
+	}
+	if(!provision_graph(g, d, a))
+		return false;
+	initialize_tdma(); //the schedule of the discovered graph, as printed
+	app_log_info("Discovery complete.\n");
+	print_topology();
+	return true;
+}
@@ -0,0 +1,86 @@
+/***************************************************************************//**
+ * @file app_discovery.h
+ * @brief Header file for the discovery of the graph (the 'discover' CLI
+ * command), so that the graph does not have to be measured by hand. The boards
+ * follow a TDMA schedule with one slot per board (see
+ * {@link app_tdma#initialize_tdma_without_graph() initialize_tdma_without_graph()}),
+ * on the shared channel:
+ * - In the setup frames, the start of the discovery is flooded, as in TDMA mode.
+ * - In the next {@link DISCOVERY_BEACONS} frames, every board broadcasts a
+ *   beacon in its slot, and counts the beacons and their RSSI per sender.
+ * - In the last frames, every board broadcasts the links it measured (the
+ *   boards it heard with at least {@link DISCOVERY_MIN_BEACONS} beacons of mean
+ *   RSSI at least {@link DISCOVERY_MIN_RSSI}), and relays the links of the
+ *   other boards, until every board knows the links of all boards. The boards
+ *   which it heard at all are broadcast too.
+ *
+ * Finally, every board keeps the links measured by both of their boards, and
+ * provisions the resulting graph with its generated baton path (see
+ * app_topology.h), so that all boards adopt the same topology. The boards
+ * which heard each other over the excluded links remain {@link audible}, so
+ * that the TDMA schedule keeps them apart, and a link measured by one of its
+ * boards only is kept as a one-way link (see {@link directed_graph}), which
+ * push-sum uses.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_DISCOVERY_H
+#define APP_DISCOVERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+
+///The frames of the discovery after its setup frames: the beacons, and the exchange of the links, where a board broadcasts one board's links per frame (the links of every board reach every board within num_of_boards plus the diameter frames, and most of them are repeated).
+#define DISCOVERY_FRAMES (DISCOVERY_BEACONS + 2*num_of_boards - 1)
+
+/** Starts the discovery on this board: it clears the measurements, and
+ * computes the schedule of the discovery (which has still to be started).
+ *
+ * @date 16/10/2026
+ */
+void start_discovery();
+
+/** Records a beacon received in a frame of the discovery. Beacons outside the
+ * beacon frames are ignored.
+ *
+ * @date 16/10/2026
+ * @param src The sender of the beacon.
+ * @param frame The current frame of the schedule.
+ * @param rssi The RSSI of the beacon (in dBm).
+ */
+void record_beacon(uint8_t src, int frame, int8_t rssi);
+
+/** Records the links of a board, as received during the exchange of the links.
+ *
+ * @date 16/10/2026
+ * @param owner The board which measured the links.
+ * @param links Bit j is set if the owner heard board j well enough.
+ * @param heard_at_all Bit j is set if the owner heard board j at all.
+ */
+void record_links(uint8_t owner, uint32_t links, uint32_t heard_at_all);
+
+/** Selects the links to be broadcast in the slot of this board during the
+ * exchange of the links: the links of the board which have been sent the
+ * fewest times (the earliest received of them), starting from the links of
+ * this board.
+ *
+ * @date 16/10/2026
+ * @param owner Where the board which measured the links is stored.
+ * @param links Where the links are stored.
+ * @param heard_at_all Where the boards which the owner heard at all are stored.
+ */
+void next_links(uint8_t *owner, uint32_t *links, uint32_t *heard_at_all);
+
+/** Completes the discovery: if the links of all boards are known, the graph of
+ * the links which both of their boards measured (and the one-way links) is
+ * provisioned with its generated baton path (see
+ * {@link app_topology#provision_graph() provision_graph()}). It prints the
+ * measured links (and the new topology) to the console.
+ *
+ * @date 16/10/2026
+ * @return True if the discovered graph became the current one, false if the
+ * current topology remains unchanged.
+ */
+bool finish_discovery();
+
+#endif  // APP_DISCOVERY_H
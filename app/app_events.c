@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @file app_events.c
+ * @brief Implementation file for the queue of the events of the system.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_events.h"
+#include <stdatomic.h>
+
+///The space where the events of the queue are stored.
+static app_event_t events[EVENT_QUEUE_SIZE];
+
+///The position of the next event to be appended. It is only written by the producer.
+static volatile uint8_t head;
+
+///The position of the oldest event. It is only written by the consumer.
+static volatile uint8_t tail;
+
+/*******************************************************************************
+ * Appends an event to the queue.
+ ******************************************************************************/
+bool post_event(event_t type, uint64_t data){
+	uint8_t next = (head+1) & (EVENT_QUEUE_SIZE-1);
+	if(next==tail){
+		event_overflows++;
+		return false;
+	}
+	events[head].type = type;
+	events[head].data = data;
+	atomic_signal_fence(memory_order_release); //The event is written before it is published
+	head = next;
+	return true;
+}
+
+/*******************************************************************************
+ * Removes the oldest event from the queue.
+ ******************************************************************************/
+bool get_event(app_event_t *event){
+	if(tail==head)
+		return false;
+	atomic_signal_fence(memory_order_acquire); //The event is read after it was published
+	*event = events[tail];
+	atomic_signal_fence(memory_order_release); //The event is read before its space is released
+	tail = (tail+1) & (EVENT_QUEUE_SIZE-1);
+	return true;
+}
+
+/*******************************************************************************
+ * Returns whether the queue is not empty.
+ ******************************************************************************/
+bool events_pending(){
+	return tail!=head;
+}
+
+/*******************************************************************************
+ * Discards all the events of the queue.
+ ******************************************************************************/
+void flush_events(){
+	tail = head;
+}
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ * @file app_events.h
+ * @brief Header file for the queue of the events of the system. The interrupt
+ * handlers of RAIL (the radio events and the callbacks of the timers) post the
+ * events, and the main loop drains them in a batch per pass (see
+ * {@link app_process#handle_app_events() handle_app_events()}), in the order
+ * they occurred. The queue is a lock-free ring buffer with a single producer
+ * and a single consumer: all the interrupts of RAIL have the same priority, so
+ * they never preempt each other.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_EVENTS_H
+#define APP_EVENTS_H
+
+#include "rail_types.h"
+
+///The capacity of the queue plus one (a power of 2).
+#define EVENT_QUEUE_SIZE 16
+
+/** The types of the events.
+* - E_PACKET_RECEIVED: A new packet has been received (and held in the RX FIFO).
+* - E_PACKET_SENT: The transmission of a packet has been completed, i.e., its ACK arrived if it needs one, or it was given up (the data are the duration of its transmissions from RAIL_StartTx(), in microseconds).
+* - E_RX_ERROR: An error was encountered during the reception of a packet (the data are the RAIL events).
+* - E_TX_ERROR: An error was encountered during the transmission of a packet (the data are the RAIL events).
+* - E_CAL_ERROR: An error was encountered during the calibration of the radio (the data are the result of RAIL_Calibrate()).
+* - E_RESTART_TIMEOUT: The {@link tmr0} timer expired, and the system has to restart.
+* - E_TDMA_FRAME: A new frame of the TDMA schedule has started (the data are the frame).
+* - E_TDMA_SLOT: The TDMA slot of this board has started.
+* - E_SENSOR_READY: The measurement of the sensor has been converted (see {@link app_tools#start_temperature_measurement() start_temperature_measurement()}).
+* - E_RADIO_WAKE: The radio has to receive again, since the baton may return to the neighborhood of this board (see {@link app_power#plan_radio_sleep() plan_radio_sleep()}).
+* - E_LISTEN_WINDOW: A listen window of a sleeping board started (the data are true) or ended (the data are false), see {@link app_power#start_low_power_listen() start_low_power_listen()}.
+* - E_TX_RETRY: The backoff before a retransmission of the last message ended (see {@link app_network#retransmit_packet() retransmit_packet()}).
+* - E_ACK_SENT: This board sent an ACK (the data are the duration of its reception and transmission, in microseconds, or 0 if the ACK was not sent).
+* - E_FLOOD_RELAY: The jitter before this board relays a restart or start message ended (see {@link app_routing#schedule_flood_relay() schedule_flood_relay()}).
+* - E_GOSSIP_TIMER: The next exchange of the randomized gossip is due, or the reply to the last request did not arrive (see app_gossip.h).
+* - E_TRACKING_SAMPLE: The next sample of the sensor is due, while the board tracks the average (see app_gossip.h).
+*/
+typedef enum {
+	E_PACKET_RECEIVED,
+	E_PACKET_SENT,
+	E_RX_ERROR,
+	E_TX_ERROR,
+	E_CAL_ERROR,
+	E_RESTART_TIMEOUT,
+	E_TDMA_FRAME,
+	E_TDMA_SLOT,
+	E_SENSOR_READY,
+	E_RADIO_WAKE,
+	E_LISTEN_WINDOW,
+	E_TX_RETRY,
+	E_ACK_SENT,
+	E_FLOOD_RELAY,
+	E_GOSSIP_TIMER,
+	E_TRACKING_SAMPLE
+} event_t;
+
+///An event of the queue.
+typedef struct {
+	event_t type;
+	uint64_t data;
+} app_event_t;
+
+///The number of events which were lost because the queue was full. It is only written by the producer.
+volatile uint16_t event_overflows;
+
+/** Appends an event to the queue. It must only be called from the interrupt
+ * handlers of RAIL (the producer).
+ *
+ * @date 16/10/2026
+ * @param type The type of the event.
+ * @param data The data of the event (depending on its type).
+ * @return True if the event was appended, false if the queue was full.
+ */
+bool post_event(event_t type, uint64_t data);
+
+/** Removes the oldest event from the queue. It must only be called from the
+ * main loop (the consumer).
+ *
+ * @date 16/10/2026
+ * @param event Where the event is stored.
+ * @return True if an event was removed, false if the queue was empty.
+ */
+bool get_event(app_event_t *event);
+
+/** Returns whether the queue has events which have not been removed yet.
+ *
+ * @date 16/10/2026
+ * @return True if the queue is not empty.
+ */
+bool events_pending();
+
+/** Discards all the events of the queue. It must only be called from the main
+ * loop (the consumer).
+ *
+ * @date 16/10/2026
+ */
+void flush_events();
+
+#endif  // APP_EVENTS_H
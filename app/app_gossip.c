@@ -0,0 +1,287 @@
+/***************************************************************************//**
+ * @file app_gossip.c
+ * @brief Implementation file for the randomized gossip.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_gossip.h"
+#include <string.h>
+#include "rail.h"
+#include "app_events.h"
+#include "app_consensus.h"
+#include "app_codec.h"
+#include "app_routing.h"
+
+///Expires when the next exchange is due, or when the reply to the last request is given up.
+static RAIL_MultiTimer_t gossip_tmr;
+
+///Expires when the next sample of the sensor is due, while this board tracks the average.
+static RAIL_MultiTimer_t sample_tmr;
+
+///True while this board tracks the average (see {@link TRACKING_PERIOD_MILISECS}).
+static bool tracking;
+
+///True if this board has to stop tracking the average at its next exchange.
+static bool stop_requested;
+
+///The state of the random generator of the periods and the neighbors (xorshift32, never 0).
+static uint32_t gossip_state = 1;
+
+///True while this board waits for the reply to its request.
+static bool awaiting;
+
+///The neighbor which received the last request of this board (or -1), whose reply is applied even after the timeout.
+static int8_t partner = -1;
+
+///The state of this board which the last request carried.
+static float sent_state[NUM_OF_QUANTITIES];
+
+///The hops around this board within which every board has been below the STOP_THRESHOLD at its last exchange (see {@link GOSSIP_DONE}).
+static uint8_t quiet_hops;
+
+///The quiet hops of every neighbor, as carried by its last message.
+static uint8_t neighbor_hops[MAX_NUM_OF_BOARDS];
+
+///The consecutive requests of this board without a reply.
+static uint8_t failures;
+
+/** Returns a random number (xorshift32).
+ *
+ * @date 16/10/2026
+ * @return The random number.
+ */
+static uint32_t next_random(){
+	gossip_state ^= gossip_state << 13;
+	gossip_state ^= gossip_state >> 17;
+	gossip_state ^= gossip_state << 5;
+	return gossip_state;
+}
+
+/** The callback of the {@link gossip_tmr} timer: the exchange is handled by
+ * the main loop.
+ *
+ * @date 16/10/2026
+ * @param tmr Is not used.
+ * @param expectedTimeOfEvent Is not used.
+ * @param cbArg Is not used.
+ */
+static void gossip_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)expectedTimeOfEvent; (void)cbArg;
+	post_event(E_GOSSIP_TIMER, 0);
+}
+
+/** The callback of the {@link sample_tmr} timer: the sample is taken by the
+ * main loop, and the next one is scheduled.
+ *
+ * @date 16/10/2026
+ * @param tmr Is not used.
+ * @param expectedTimeOfEvent Is not used.
+ * @param cbArg Is not used.
+ */
+static void sample_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)expectedTimeOfEvent; (void)cbArg;
+	post_event(E_TRACKING_SAMPLE, 0);
+	RAIL_SetMultiTimer(&sample_tmr, TRACKING_SAMPLE_PERIOD_MILISECS*1000UL, RAIL_TIME_DELAY, &sample_alarm, NULL);
+}
+
+/** Schedules the next exchange of this board after a random period in
+ * [1/2, 3/2) of {@link GOSSIP_PERIOD_MILISECS} (or of
+ * {@link TRACKING_PERIOD_MILISECS}).
+ *
+ * @date 16/10/2026
+ */
+static void schedule_exchange(){
+	uint32_t mean = tracking ? TRACKING_PERIOD_MILISECS : GOSSIP_PERIOD_MILISECS;
+	uint32_t period = mean/2 + next_random()%mean;
+	RAIL_SetMultiTimer(&gossip_tmr, period*1000UL, RAIL_TIME_DELAY, &gossip_alarm, NULL);
+}
+
+/** Counts an exchange of this board, and updates its quiet hops: if the
+ * exchange changed every quantity of its state by at most the
+ * {@link STOP_THRESHOLD}, one more than the fewest quiet hops of its
+ * neighbors, otherwise 0.
+ *
+ * @date 16/10/2026
+ * @param prev_state The state of this board before the exchange.
+ * @param peer The neighbor of the exchange.
+ * @param peer_hops The quiet hops of the neighbor.
+ */
+static void count_exchange(const float *prev_state, uint8_t peer, uint8_t peer_hops){
+	if(consensus_iters<UINT8_MAX)
+		consensus_iters++;
+	failures = 0;
+	neighbor_hops[peer] = peer_hops;
+	if(consensus_state_change(prev_state)>STOP_THRESHOLD){
+		quiet_hops = 0;
+		return;
+	}
+	uint8_t hops = GOSSIP_DONE-1;
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && graph[board_id][j] && neighbor_hops[j]<hops)
+			hops = neighbor_hops[j];
+	quiet_hops = hops+1;
+}
+
+/*******************************************************************************
+ * Starts the randomized gossip on this board.
+ ******************************************************************************/
+void start_gossip(RAIL_Handle_t rail_handle, bool track){
+	uint32_t seed = 0;
+	RAIL_GetRadioEntropy(rail_handle, (uint8_t *) &seed, sizeof(seed));
+	gossip_state = (seed ^ (0x9E3779B9UL*(board_id+1))) | 1; //every board draws a different sequence
+	awaiting = false;
+	partner = -1;
+	quiet_hops = 0;
+	memset(neighbor_hops, 0, sizeof(neighbor_hops));
+	failures = 0;
+	tracking = track;
+	stop_requested = false;
+	schedule_exchange();
+	if(tracking)
+		RAIL_SetMultiTimer(&sample_tmr, TRACKING_SAMPLE_PERIOD_MILISECS*1000UL, RAIL_TIME_DELAY, &sample_alarm, NULL);
+}
+
+/*******************************************************************************
+ * Stops the randomized gossip on this board.
+ ******************************************************************************/
+void stop_gossip(){
+	RAIL_CancelMultiTimer(&gossip_tmr);
+	RAIL_CancelMultiTimer(&sample_tmr);
+	awaiting = false;
+	partner = -1;
+	tracking = false;
+}
+
+/*******************************************************************************
+ * Returns whether this board tracks the average.
+ ******************************************************************************/
+bool gossip_tracks(){
+	return tracking;
+}
+
+/*******************************************************************************
+ * Makes this board stop tracking the average at its next exchange.
+ ******************************************************************************/
+void stop_tracking(){
+	stop_requested = tracking;
+}
+
+/*******************************************************************************
+ * Handles the expiration of the timer of the gossip.
+ ******************************************************************************/
+bool gossip_timer_expired(){
+	if(!awaiting)
+		return true;
+	awaiting = false; //the partner is kept, in case its reply arrives late
+	if(failures<UINT8_MAX)
+		failures++;
+	schedule_exchange();
+	return false;
+}
+
+/*******************************************************************************
+ * Starts an exchange with a random neighbor.
+ ******************************************************************************/
+int8_t request_gossip(){
+	int neighbors = 0;
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && graph[board_id][j])
+			neighbors++;
+	if(neighbors==0){
+		failures = GOSSIP_MAX_FAILURES;
+		return -1;
+	}
+	int k = next_random()%neighbors;
+	for(int j=0;j<num_of_boards;j++){
+		if(j!=board_id && graph[board_id][j] && k--==0){
+			partner = j;
+			break;
+		}
+	}
+	memcpy(sent_state, consensus_states[board_id], sizeof(sent_state));
+	awaiting = true;
+	RAIL_SetMultiTimer(&gossip_tmr, GOSSIP_REPLY_TIMEOUT_MILISECS*1000UL, RAIL_TIME_DELAY, &gossip_alarm, NULL);
+	return partner;
+}
+
+/*******************************************************************************
+ * Returns whether this board waits for a reply.
+ ******************************************************************************/
+bool gossip_awaits_reply(){
+	return awaiting;
+}
+
+/*******************************************************************************
+ * Returns the quiet hops of this board.
+ ******************************************************************************/
+uint8_t gossip_quiet_hops(){
+	return quiet_hops;
+}
+
+/*******************************************************************************
+ * Answers the request of a neighbor.
+ ******************************************************************************/
+void answer_gossip(uint8_t src, const float *peer_state, uint8_t peer_hops, float *prev_state){
+	memcpy(prev_state, consensus_states[board_id], NUM_OF_QUANTITIES*sizeof(float));
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		consensus_states[board_id][q] = quantize_state((prev_state[q]+peer_state[q])/2);
+	count_exchange(prev_state, src, peer_hops);
+}
+
+/*******************************************************************************
+ * Completes the exchange of this board with the reply of a neighbor.
+ ******************************************************************************/
+void gossip_replied(uint8_t src, const float *peer_state, uint8_t peer_hops){
+	if(src!=partner)
+		return;
+	partner = -1;
+	if(awaiting){ //otherwise, the next exchange has been scheduled at the timeout
+		awaiting = false;
+		schedule_exchange();
+	}
+	float prev_state[NUM_OF_QUANTITIES];
+	memcpy(prev_state, consensus_states[board_id], sizeof(prev_state));
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		consensus_states[board_id][q] = quantize_state(prev_state[q]+(peer_state[q]-sent_state[q])/2);
+	count_exchange(prev_state, src, peer_hops);
+}
+
+/*******************************************************************************
+ * Completes the exchange of this board when the neighbor refused it.
+ ******************************************************************************/
+void gossip_refused(uint8_t src){
+	if(src!=partner)
+		return;
+	partner = -1;
+	if(awaiting){
+		awaiting = false;
+		schedule_exchange();
+	}
+}
+
+/*******************************************************************************
+ * Records that a neighbor has stopped.
+ ******************************************************************************/
+void gossip_stopped(uint8_t src){
+	neighbor_hops[src] = GOSSIP_DONE;
+}
+
+/*******************************************************************************
+ * Returns whether all boards are quiet.
+ ******************************************************************************/
+bool gossip_is_quiet(){
+	bool neighbor_stopped = false;
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && graph[board_id][j] && neighbor_hops[j]==GOSSIP_DONE)
+			neighbor_stopped = true;
+	if(tracking)
+		return stop_requested || neighbor_stopped;
+	return quiet_hops>routing_diameter() || neighbor_stopped;
+}
+
+/*******************************************************************************
+ * Returns whether the gossip is over for this board.
+ ******************************************************************************/
+bool gossip_is_over(){
+	return gossip_is_quiet() || failures>=GOSSIP_MAX_FAILURES || (!tracking && consensus_iters>=GOSSIP_MAX_EXCHANGES);
+}
@@ -0,0 +1,211 @@
+/***************************************************************************//**
+ * @file app_gossip.h
+ * @brief Header file for the randomized gossip (the 'gossip' CLI command), an
+ * asynchronous alternative to the baton: every board starts a pairwise
+ * exchange on its own jittered timer, with a random neighbor of the
+ * {@link graph}, and both boards average their states:
+ * - The board sends a {@link app_codec#gossip_kind_t GOSSIP_REQUEST} with its
+ *   state to the neighbor.
+ * - The neighbor sends a {@link app_codec#gossip_kind_t GOSSIP_REPLY} with its
+ *   state, and averages the two states. A neighbor which waits for the reply to
+ *   its own request sends a {@link app_codec#gossip_kind_t GOSSIP_BUSY}
+ *   instead, and the board tries again at its next exchange.
+ * - The board averages the two states when the reply arrives, or gives up
+ *   after {@link GOSSIP_REPLY_TIMEOUT_MILISECS}.
+ *
+ * No board holds a token, hence the exchanges of boards which do not hear each
+ * other proceed concurrently. The sum of the states is preserved by every
+ * exchange whose reply arrives (a reply which arrives after the timeout is
+ * still applied, until the board sends its next request). Every message also
+ * carries the quiet hops of its sender, as the states of the TDMA mode carry
+ * their quiet frames: a board whose last exchange changed its state by at most
+ * the {@link STOP_THRESHOLD} has one more quiet hop than the fewest of its
+ * neighbors (as last heard), hence k quiet hops mean that every board within k-1
+ * hops is quiet too. A board stops when its quiet hops exceed the diameter of
+ * the graph (see {@link app_routing#routing_diameter() routing_diameter()}),
+ * i.e., when all boards are quiet, and sends a
+ * {@link app_codec#gossip_kind_t GOSSIP_STOP} to its neighbors, which stop at
+ * their next exchange (and send it further), as a neighbor which terminated
+ * the algorithm does in TDMA mode. A neighbor which missed it still requests
+ * exchanges from the stopped board, which answers every request with another
+ * {@link app_codec#gossip_kind_t GOSSIP_STOP} while it sleeps, until the
+ * neighbor stops too. A board which cannot reach its neighbors
+ * stops (alone) after {@link GOSSIP_MAX_FAILURES} consecutive requests without
+ * a reply.
+ *
+ * The same exchanges also track a changing average (the 'track' CLI command),
+ * as a dynamic average consensus: the boards never become quiet, but exchange
+ * every {@link TRACKING_PERIOD_MILISECS} on average, and every board samples
+ * its sensor every {@link TRACKING_SAMPLE_PERIOD_MILISECS} and adds the change
+ * of its readings to its state (see
+ * {@link app_consensus#track_measurements() track_measurements()}). The sum of
+ * the states follows the sum of the current readings, and the exchanges keep
+ * the state of every board close to the current average, which the 'average'
+ * CLI command prints instantly. A second 'track' command stops the board, which
+ * sends the {@link app_codec#gossip_kind_t GOSSIP_STOP} to its neighbors, and
+ * the stop spreads as above.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_GOSSIP_H
+#define APP_GOSSIP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rail_types.h"
+#include "app_config.h"
+
+///The mean time between the exchanges which a board starts (in milliseconds). Every period is random in [1/2, 3/2) of it, so that the exchanges of neighbors rarely overlap. An exchange takes about 2 airtimes (the request and the reply, about 110 ms at 2.4 kbps, or 4 with their ACKs when {@link USE_ACKS} equals to 1), and the radio does not sense the channel, hence shorter periods lose more exchanges to collisions than they gain.
+#define GOSSIP_PERIOD_MILISECS 2000
+
+///The time for which a board waits for the reply to its request (in milliseconds): the airtimes of the exchange, plus the retransmissions of the request and of the reply when {@link USE_ACKS} equals to 1 (see {@link app_network#MAX_RETRANSMISSION_DELAY_MICROSECS MAX_RETRANSMISSION_DELAY_MICROSECS}).
+#define GOSSIP_REPLY_TIMEOUT_MILISECS (USE_ACKS ? 800 : 300)
+
+///The quiet hops of a board which has stopped (see the description of the file).
+#define GOSSIP_DONE 0xFF
+
+///The number of consecutive requests without a reply, after which a board stops (its neighbors have stopped already, or cannot be reached). Collisions fail several requests in a row on busy links.
+#define GOSSIP_MAX_FAILURES 10
+
+///The maximum number of exchanges of a board (see {@link app_consensus#consensus_iters consensus_iters}), after which it stops.
+#define GOSSIP_MAX_EXCHANGES 250
+
+///The mean time between the exchanges which a board starts while it tracks the average (in milliseconds), in [1/2, 3/2) of it as in {@link GOSSIP_PERIOD_MILISECS}. The states only have to follow the slow changes of the readings, hence the exchanges are fewer.
+#define TRACKING_PERIOD_MILISECS 5000
+
+///The time between the samples of the sensor of a board while it tracks the average (in milliseconds).
+#define TRACKING_SAMPLE_PERIOD_MILISECS 10000
+
+/** Starts the randomized gossip on this board, once its state has been
+ * initialized (see
+ * {@link app_consensus#initialize_consensus_setup() initialize_consensus_setup()}):
+ * it seeds the random generator from the radio, and schedules the first
+ * exchange, when the event {@link app_events#event_t E_GOSSIP_TIMER} is
+ * posted. While this board tracks the average, the event
+ * {@link app_events#event_t E_TRACKING_SAMPLE} is also posted every
+ * {@link TRACKING_SAMPLE_PERIOD_MILISECS}.
+ *
+ * @date 16/10/2026
+ * @param rail_handle A handle to the RAIL instance, for the entropy of the radio.
+ * @param track True if this board tracks the average, until it is stopped
+ * (see the description of the file).
+ */
+void start_gossip(RAIL_Handle_t rail_handle, bool track);
+
+/** Stops the randomized gossip on this board (its timers are cancelled).
+ *
+ * @date 16/10/2026
+ */
+void stop_gossip();
+
+/** Returns whether this board tracks the average (see the description of the
+ * file).
+ *
+ * @date 16/10/2026
+ * @return True while this board tracks the average.
+ */
+bool gossip_tracks();
+
+/** Makes this board stop tracking the average at its next exchange, and inform
+ * its neighbors (see {@link gossip_is_quiet()}).
+ *
+ * @date 16/10/2026
+ */
+void stop_tracking();
+
+/** Handles the expiration of the timer of the gossip: either the reply to the
+ * last request did not arrive (the request failed, and the next exchange is
+ * scheduled), or the next exchange is due.
+ *
+ * @date 16/10/2026
+ * @return True if this board has to start an exchange.
+ */
+bool gossip_timer_expired();
+
+/** Starts an exchange: it selects a random neighbor, records the state which
+ * is sent to it, and waits for its reply.
+ *
+ * @date 16/10/2026
+ * @return The neighbor, or -1 if this board has no neighbor.
+ */
+int8_t request_gossip();
+
+/** Returns whether this board waits for the reply to its request, i.e.,
+ * whether it has to refuse the requests of its neighbors.
+ *
+ * @date 16/10/2026
+ * @return True if a reply is awaited.
+ */
+bool gossip_awaits_reply();
+
+/** Returns the quiet hops of this board, which its messages carry.
+ *
+ * @date 16/10/2026
+ * @return The quiet hops.
+ */
+uint8_t gossip_quiet_hops();
+
+/** Answers the request of a neighbor: every quantity of the state of this
+ * board becomes the average of the two states.
+ *
+ * @date 16/10/2026
+ * @param src The neighbor.
+ * @param peer_state The state of the neighbor, as carried by its request.
+ * @param peer_hops The quiet hops of the neighbor.
+ * @param prev_state The array where the state of this board before the
+ * averaging is stored, which the reply carries.
+ */
+void answer_gossip(uint8_t src, const float *peer_state, uint8_t peer_hops, float *prev_state);
+
+/** Completes the exchange of this board with the reply of a neighbor: the
+ * state of this board moves by half the difference between the two states
+ * which were exchanged, so that the sum of the states is preserved. A reply
+ * from any other board is ignored.
+ *
+ * @date 16/10/2026
+ * @param src The neighbor which replied.
+ * @param peer_state The state of the neighbor before its averaging.
+ * @param peer_hops The quiet hops of the neighbor.
+ */
+void gossip_replied(uint8_t src, const float *peer_state, uint8_t peer_hops);
+
+/** Completes the exchange of this board when the neighbor refused it; the next
+ * exchange is scheduled. A refusal from any other board is ignored.
+ *
+ * @date 16/10/2026
+ * @param src The neighbor which refused.
+ */
+void gossip_refused(uint8_t src);
+
+/** Records that a neighbor has stopped (see
+ * {@link app_codec#gossip_kind_t GOSSIP_STOP}).
+ *
+ * @date 16/10/2026
+ * @param src The neighbor.
+ */
+void gossip_stopped(uint8_t src);
+
+/** Returns whether all boards are quiet, i.e., whether the quiet hops of this
+ * board exceed the diameter of the graph, or a neighbor has stopped for this
+ * reason. Only then the neighbors are informed that this board stops (a board
+ * which stops after {@link GOSSIP_MAX_FAILURES} failures or
+ * {@link GOSSIP_MAX_EXCHANGES} exchanges stops alone). While this board tracks
+ * the average, only a stop (see {@link stop_tracking()}) of this board or of a
+ * neighbor counts.
+ *
+ * @date 16/10/2026
+ * @return True if the algorithm is terminated.
+ */
+bool gossip_is_quiet();
+
+/** Returns whether this board has to stop the gossip: when all boards are
+ * quiet (see {@link gossip_is_quiet()}), or after
+ * {@link GOSSIP_MAX_FAILURES} consecutive requests without a reply or
+ * {@link GOSSIP_MAX_EXCHANGES} exchanges (the exchanges are not limited while
+ * this board tracks the average).
+ *
+ * @date 16/10/2026
+ * @return True if the gossip is over for this board.
+ */
+bool gossip_is_over();
+
+#endif  // APP_GOSSIP_H
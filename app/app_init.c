@@ -15,6 +15,8 @@
 #include "app_config.h"
 #include "app_network.h"
 #include "app_process.h"
+#include "app_topology.h"
+#include "app_power.h"
 
 
 /** Checks phy settings to avoid errors at packet sending.
@@ -42,14 +44,18 @@ static void validation_check() {
 							| SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM3 \
 							| SL_POWER_MANAGER_EVENT_TRANSITION_LEAVING_EM3)
 
-/** The callback function after an EM transition.
+/** The callback function after an EM transition. It accounts the transition
+ * in the energy estimate, and indicates the new EM state with the LEDs (if
+ * {@link USE_EM_TRANSITION_LEDS} equals to 1).
  *
  * @date 01/02/2023
  * @param from The previous EM state of the current board.
  * @param to The new EM state of the current board.
  */
 static void em_callback(sl_power_manager_em_t from, sl_power_manager_em_t to){
-	(void)from;
+	account_em_transition(from, to);
+	if(USE_EM_TRANSITION_LEDS!=1)
+		return;
 	if(to==2){ //EM2
 		sl_led_turn_off(&sl_led_led0);
 		sl_led_turn_off(&sl_led_led1);
@@ -79,21 +85,23 @@ static sl_power_manager_em_transition_event_info_t event_info = {
 RAIL_Handle_t app_init() {
 	validation_check();
 
+	bool provisioned = load_topology(); //Load the identity of this board and the topology of the system, before anything depends on them
+
 	RAIL_Handle_t rail_handle = sl_rail_util_get_handle(SL_RAIL_UTIL_HANDLE_INST0); // Get RAIL handle, used later by the application
 	set_up_tx_fifo(rail_handle); //Prepare a FIFO structure utilized by the tx mechanism
+	set_up_auto_ack(rail_handle); //Acknowledge the messages to a single board, and retransmit them if their ACK is lost
 
-	if(USE_EM_TRANSITION_LEDS==1){
+	if(USE_EM_TRANSITION_LEDS==1)
 		sl_led_turn_on(&sl_led_led0); //Turn on LED 0, until it's time to sleep
-		sl_power_manager_subscribe_em_transition_event(&event_handle, &event_info);
-	}
+	sl_power_manager_subscribe_em_transition_event(&event_handle, &event_info); //The transitions are accounted in the energy estimate
 
-	RAIL_InitPowerManager(); //Initialize the power manager API, which will let the board sleep
-	sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+	RAIL_InitPowerManager(); //Initialize the power manager API, which will let the board sleep. RAIL keeps the board in EM1 while the radio is active, and allows EM2 while it is turned off.
 
 	RAIL_ConfigMultiTimer(true); //Initialize the multitimer API, which will provide as many timers as needed.
 
 	initialize_app(rail_handle); //Initialize the application's variables.
 
 	app_log_info("Embedded Distributed Averaging System (EDAS) - Temperature\n");  // CLI info message
+	app_log_info("Board %d of %d (%s topology).\n", board_id, num_of_boards, provisioned ? "provisioned" : "default");
 	return rail_handle;
 }
@@ -16,6 +16,7 @@
  * @returns A handle to the RAIL instance that will be used by the application.
  *
  * It ensures the followings:
+ * - Load the identity of the board and the topology (see app_topology.h).
  * - Start RAIL reception.
  * - Set the LEDs, depending on the EM state and the user's configuration.
  * - Initialize the application, the timers and the EM transition mechanism.
@@ -10,6 +10,9 @@
 #include "app_assert.h"
 #include "app_log.h"
 #include "app_process.h"
+#include "app_tools.h"
+#include "app_events.h"
+#include "app_power.h"
 
 ///TX FIFO
 static union {
@@ -19,15 +22,78 @@ static union {
 ///RX FIFO
 uint8_t rx_fifo[RAIL_FIFO_SIZE];
 
+///The time when the last transmission was started (in the RAIL time of this board).
+static RAIL_Time_t tx_started;
+
+///The channel which the radio was last tuned to, so that it is prepared again only for another channel.
+static uint16_t tuned_channel = 0xFFFF;
+
+///A message sent by {@link send_packet()}, encoded, which is kept until it has been acknowledged.
+typedef struct {
+	uint8_t data[MAX_PACKET_LENGTH]; ///< The packet.
+	uint8_t length;                  ///< The length of the packet.
+	uint16_t channel;                ///< The channel of the destination.
+	bool needs_ack;                  ///< True if the message has to be acknowledged (see {@link needs_ack()}).
+} queued_packet_t;
+
+///The messages to be transmitted, in the order they were sent. The first one is being transmitted.
+static queued_packet_t tx_queue[TX_QUEUE_LENGTH];
+
+///The position of the first message in {@link tx_queue}.
+static uint8_t tx_queue_head;
+
+///The number of messages in {@link tx_queue}.
+static uint8_t tx_queue_count;
+
+///The destination of the message which is being transmitted.
+static uint8_t tx_dst;
+
+///The sequence number of the message which is being transmitted, which its ACK has to carry.
+static uint8_t tx_seq;
+
+///The number of retransmissions of the message which is being transmitted.
+static uint8_t tx_retries;
+
+///The total duration of the transmissions of the message which is being transmitted (in microseconds), reported by E_PACKET_SENT.
+static RAIL_Time_t tx_airtime;
+
+///True while the radio waits for the ACK of the message which is being transmitted.
+static volatile bool awaiting_ack;
+
+///True if the transmission of the first message waits until this board has sent an ACK (see {@link resume_deferred_packet()}).
+static bool tx_deferred;
+
+///True while this board sends an ACK, from the reception of the acknowledged message until RAIL_EVENTS_TXACK_COMPLETION.
+static volatile bool ack_in_progress;
+
+///The time when the message which is being acknowledged was received (in the RAIL time of this board).
+static RAIL_Time_t ack_started;
+
+///The sequence number of the last message sent to every board (and, in the last element, broadcast).
+static uint8_t next_seq[MAX_NUM_OF_BOARDS+1];
+
+///The sequence number of the last acknowledged message received from every board.
+static uint8_t last_seq[MAX_NUM_OF_BOARDS];
+
+///True for the boards in {@link last_seq} whose messages have been received, since their last restart or start message.
+static bool seq_known[MAX_NUM_OF_BOARDS];
+
+///The state of the random generator of the backoff (xorshift32, never 0).
+static uint32_t backoff_state = 1;
+
+///Expires when the backoff before a retransmission ends.
+static RAIL_MultiTimer_t retry_tmr;
+
 
 /** Prints in the console the payload of the received packet in hex format.
  *
  * @date 10/01/2023
  * @param rx_buffer A buffer with the payload of the received packet.
+ * @param length The length of the payload.
  */
-static void printf_rx_packet(const uint8_t * const rx_buffer){
+static void printf_rx_packet(const uint8_t * const rx_buffer, uint16_t length){
 	app_log_info("Packet has been received: ");
-	for (uint16_t i = 0; i < TX_PAYLOAD_LENGTH; i++)
+	for (uint16_t i = 0; i < length; i++)
 		app_log_info("0x%02X, ", rx_buffer[i]);
 	app_log_info("\n");
 }
@@ -36,10 +102,11 @@ static void printf_rx_packet(const uint8_t * const rx_buffer){
  *
  * @date 10/01/2023
  * @param tx_buffer A buffer with the payload of the transmitted packet.
+ * @param length The length of the payload.
  */
-static void printf_tx_packet(const uint8_t * const tx_buffer){
+static void printf_tx_packet(const uint8_t * const tx_buffer, uint16_t length){
 	app_log_info("Packet has been transmitted: ");
-	for (uint16_t i = 0; i < TX_PAYLOAD_LENGTH; i++)
+	for (uint16_t i = 0; i < length; i++)
 		app_log_info("0x%02X, ", tx_buffer[i]);
 	app_log_info("\n");
 }
@@ -56,6 +123,87 @@ static void printf_tx_packet(const uint8_t * const tx_buffer){
 			  RAIL_FIFO_SIZE);
  }
 
+/** Returns the channel where a board receives its messages.
+ *
+ * @date 16/10/2026
+ * @param board The board (or {@link BROADCAST_ADDRESS}).
+ * @return The RX channel of the board.
+ */
+static uint16_t channel_of(uint16_t board){
+	return USE_SHARED_CHANNEL || USE_ADDRESS_FILTER ? SHARED_CHANNEL : board;
+}
+
+/** Returns whether a message has to be acknowledged by its receiver: the
+ * states, batons & gossip messages which are not broadcast, if
+ * {@link USE_ACKS} equals to 1.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ * @return True if the message needs an ACK.
+ */
+static bool needs_ack(const packet_t *packet){
+	return USE_ACKS && (packet->type==MSG_CONSENSUS_STATE || packet->type==MSG_BATON || packet->type==MSG_GOSSIP) && packet->dst!=BROADCAST_ADDRESS;
+}
+
+/** Returns the number of slots of the backoff before a retransmission: a random
+ * number in [0, 2^retry).
+ *
+ * @date 16/10/2026
+ * @param retry The retransmission (from 1).
+ * @return The number of slots.
+ */
+static uint32_t backoff_slots(uint8_t retry){
+	backoff_state ^= backoff_state << 13;
+	backoff_state ^= backoff_state >> 17;
+	backoff_state ^= backoff_state << 5;
+	return backoff_state & ((1UL << retry) - 1);
+}
+
+/** The callback of the {@link retry_tmr} timer: the last message is
+ * retransmitted by the main loop, or given up (as if it was sent) after
+ * {@link MAX_TX_RETRIES} retransmissions.
+ *
+ * @date 16/10/2026
+ * @param tmr Is not used.
+ * @param expectedTimeOfEvent Is not used.
+ * @param cbArg Is not used.
+ */
+static void retry_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)expectedTimeOfEvent; (void)cbArg;
+	if(tx_retries<MAX_TX_RETRIES)
+		post_event(E_TX_RETRY, 0);
+	else {
+		link_stats.failures++;
+		post_event(E_PACKET_SENT, tx_airtime);
+	}
+}
+
+/** Schedules the retransmission of the last message, after a random backoff
+ * (or its failure, immediately, if it has been retransmitted enough times).
+ *
+ * @date 16/10/2026
+ */
+static void schedule_retry(){
+	uint32_t delay = tx_retries<MAX_TX_RETRIES ? backoff_slots(tx_retries+1)*TX_BACKOFF_SLOT_MICROSECS : 0;
+	RAIL_SetMultiTimer(&retry_tmr, delay, RAIL_TIME_DELAY, &retry_alarm, NULL);
+}
+
+/** Handles the ACK which was awaited (or its absence), in the RAIL callback.
+ *
+ * @date 16/10/2026
+ * @param acknowledged True if the ACK of the last message arrived, false if the
+ * ACK timeout expired or another packet arrived instead.
+ */
+static void handle_ack(bool acknowledged){
+	if(!awaiting_ack) //e.g., the board re-initialized meanwhile
+		return;
+	awaiting_ack = false;
+	if(acknowledged)
+		post_event(E_PACKET_SENT, tx_airtime);
+	else
+		schedule_retry();
+}
+
 /** This function prepares the packet for tx, and loads it in the RAIL TX FIFO.
  *
  * @date 10/01/2023
@@ -66,37 +214,203 @@ static void printf_tx_packet(const uint8_t * const tx_buffer){
 static void prepare_package(RAIL_Handle_t rail_handle, uint8_t *out_data, uint16_t length){
 	uint16_t bytes_writen_in_fifo = 0;
 	bytes_writen_in_fifo = RAIL_WriteTxFifo(rail_handle, out_data, length, true);
-	app_assert(bytes_writen_in_fifo == TX_PAYLOAD_LENGTH,
+	app_assert(bytes_writen_in_fifo == length,
 			  "RAIL_WriteTxFifo() failed to write in fifo (%d bytes instead of %d bytes)\n",
 			  bytes_writen_in_fifo,
-			  TX_PAYLOAD_LENGTH);
+			  length);
+}
+
+/** This function transmits the first message of {@link tx_queue}, unless this
+ * board is sending an ACK. If the transmission cannot be started, it is
+ * retried after a backoff.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for TX FIFO writing.
+ */
+static void start_transmission(RAIL_Handle_t rail_handle){
+	tx_deferred = ack_in_progress; //The radio is busy until RAIL_EVENTS_TXACK_COMPLETION, which posts E_ACK_SENT
+	if(tx_deferred)
+		return;
+	queued_packet_t *packet = &tx_queue[tx_queue_head];
+	RAIL_Status_t rail_status;
+	if(packet->channel!=tuned_channel) //A board which receives on its own channel retunes to the channel of the destination
+		RAIL_PrepareChannel(rail_handle, packet->channel);
+	tuned_channel = packet->channel;
+	prepare_package(rail_handle, packet->data, packet->length);
+	cancel_radio_sleep(); //The radio receives after the transmission anyway
+	tx_started = RAIL_GetTime();
+	awaiting_ack = packet->needs_ack;
+	rail_status = RAIL_StartTx(rail_handle, packet->channel, packet->needs_ack ? RAIL_TX_OPTION_WAIT_FOR_ACK : RAIL_TX_OPTIONS_DEFAULT, NULL);
+//	printf_tx_packet(packet->data, packet->length); //Uncomment for easier debugging
+
+	if (rail_status != RAIL_STATUS_NO_ERROR){
+		app_log_warning("RAIL_StartTx() result:%d ", rail_status);
+		awaiting_ack = false;
+		schedule_retry();
+	}
+
+	if(false) //just to suppress the warning of unused static function
+		printf_tx_packet(packet->data, packet->length);
+}
+
+/** This function starts the transmission of the first message of
+ * {@link tx_queue}, for the first time.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for TX FIFO writing.
+ */
+static void start_next_packet(RAIL_Handle_t rail_handle){
+	const queued_packet_t *packet = &tx_queue[tx_queue_head];
+	packet_t header;
+	decode_packet(packet->data, packet->length, &header);
+	tx_dst = header.dst;
+	tx_seq = header.seq;
+	tx_retries = 0;
+	tx_airtime = 0;
+	start_transmission(rail_handle);
+}
+
+/******************************************************************************
+ * Configures the auto-ACK of the radio.
+ *****************************************************************************/
+void set_up_auto_ack(RAIL_Handle_t rail_handle){
+	uint32_t seed = 0;
+	RAIL_GetRadioEntropy(rail_handle, (uint8_t *) &seed, sizeof(seed));
+	backoff_state = (seed ^ board_id) | 1;
+	if(!USE_ACKS)
+		return;
+	RAIL_AutoAckConfig_t config = {
+		.enable = true,
+		.ackTimeout = ACK_TIMEOUT_MICROSECS,
+		.rxTransitions = { RAIL_RF_STATE_RX, RAIL_RF_STATE_RX }, //The radio receives after an ACK was sent,
+		.txTransitions = { RAIL_RF_STATE_RX, RAIL_RF_STATE_RX }  //and after an ACK was received (or not).
+	};
+	RAIL_Status_t rail_status = RAIL_ConfigAutoAck(rail_handle, &config);
+	if(rail_status!=RAIL_STATUS_NO_ERROR)
+		app_log_warning("RAIL_ConfigAutoAck() result:%d\n", rail_status);
+}
+
+/******************************************************************************
+ * Configures the address filter of the radio.
+ *****************************************************************************/
+void set_up_address_filter(RAIL_Handle_t rail_handle){
+	if(!FILTERS_ADDRESSES)
+		return;
+	static const uint8_t offsets[ADDRCONFIG_MAX_ADDRESS_FIELDS] = { PKTIDX_DST, 0 }; //A single field: the destination (counted from the length field)
+	static const uint8_t sizes[ADDRCONFIG_MAX_ADDRESS_FIELDS] = { 1, 0 };
+	const RAIL_AddrConfig_t config = { .offsets = offsets, .sizes = sizes, .matchTable = ADDRCONFIG_MATCH_TABLE_SINGLE_FIELD };
+	const uint8_t own = board_id, broadcast = BROADCAST_ADDRESS;
+	RAIL_Status_t rail_status = RAIL_ConfigAddressFilter(rail_handle, &config);
+	if(rail_status==RAIL_STATUS_NO_ERROR)
+		rail_status = RAIL_SetAddressFilterAddress(rail_handle, 0, 0, &own, true);
+	if(rail_status==RAIL_STATUS_NO_ERROR)
+		rail_status = RAIL_SetAddressFilterAddress(rail_handle, 0, 1, &broadcast, true);
+	if(rail_status!=RAIL_STATUS_NO_ERROR)
+		app_log_warning("The address filter could not be configured (RAIL status %d).\n", rail_status);
+	else
+		RAIL_EnableAddressFilter(rail_handle, true);
 }
 
 /******************************************************************************
  * This function prepares the packet for transmission, and also transmits it.
  *****************************************************************************/
 void send_packet(RAIL_Handle_t rail_handle ,uint16_t destination){
-	RAIL_Status_t rail_status;
-	RAIL_PrepareChannel(rail_handle,  destination);
+	if(tx_queue_count==TX_QUEUE_LENGTH){
+		app_log_error("Error. The TX queue is full, the message is dropped.\n");
+		return;
+	}
+	queued_packet_t *packet = &tx_queue[(tx_queue_head+tx_queue_count)%TX_QUEUE_LENGTH];
+	tx_packet.seq = ++next_seq[destination<MAX_NUM_OF_BOARDS ? destination : MAX_NUM_OF_BOARDS];
+	packet->channel = channel_of(destination);
+	packet->length = encode_packet(&tx_packet, packet->data);
+	packet->needs_ack = needs_ack(&tx_packet);
+	if(tx_queue_count++==0) //Otherwise, it waits for the messages before it (see transmit_next_packet())
+		start_next_packet(rail_handle);
+ }
+
+/******************************************************************************
+ * This function transmits the next message, once the first one has been sent.
+ *****************************************************************************/
+void transmit_next_packet(RAIL_Handle_t rail_handle){
+	if(tx_queue_count==0)
+		return;
+	tx_queue_head = (tx_queue_head+1)%TX_QUEUE_LENGTH;
+	if(--tx_queue_count>0)
+		start_next_packet(rail_handle);
+}
 
-	prepare_package(rail_handle, tx_packet, sizeof(tx_packet));
-	rail_status = RAIL_StartTx(rail_handle, destination, RAIL_TX_OPTIONS_DEFAULT, NULL);
-//	printf_tx_packet(tx_packet); //Uncomment for easier debugging
+/******************************************************************************
+ * This function retransmits the last message.
+ *****************************************************************************/
+void retransmit_packet(RAIL_Handle_t rail_handle){
+	if(tx_queue_count==0) //The message was dropped meanwhile (see cancel_retransmission())
+		return;
+	tx_retries++;
+	link_stats.retransmissions++;
+	start_transmission(rail_handle);
+}
 
-	if (rail_status != RAIL_STATUS_NO_ERROR)
-		app_log_warning("RAIL_StartTx() result:%d ", rail_status);
+/******************************************************************************
+ * This function transmits the last message, if its transmission was deferred.
+ *****************************************************************************/
+void resume_deferred_packet(RAIL_Handle_t rail_handle){
+	if(tx_deferred && tx_queue_count>0)
+		start_transmission(rail_handle);
+}
 
-	if(false) //just to suppress the warning of unused static function
-		printf_tx_packet(tx_packet);
- }
+/******************************************************************************
+ * This function stops the retransmissions of the last message.
+ *****************************************************************************/
+void cancel_retransmission(){
+	RAIL_CancelMultiTimer(&retry_tmr);
+	awaiting_ack = false;
+	tx_deferred = false;
+	tx_queue_count = 0;
+}
+
+/******************************************************************************
+ * This function prints the counters of the link layer.
+ *****************************************************************************/
+void print_link_stats(){
+	app_log_info("Link layer: %lu retransmissions, %lu messages given up, %lu duplicates dropped.\n",
+			(unsigned long) link_stats.retransmissions, (unsigned long) link_stats.failures, (unsigned long) link_stats.duplicates);
+}
 
 /******************************************************************************
  * This function opens the channel of the current board for receiving.
  *****************************************************************************/
 void start_receiving (RAIL_Handle_t rail_handle){
-	RAIL_Status_t rail_status = RAIL_StartRx (rail_handle, BOARD_ID, NULL);
+	tuned_channel = channel_of(board_id);
+	RAIL_Status_t rail_status = RAIL_StartRx (rail_handle, tuned_channel, NULL);
 	if(rail_status!=0)
 		app_log_warning("RAIL_StartRx() result:%d\n", rail_status);
+	account_radio(true);
+}
+
+/******************************************************************************
+ * This function schedules a receive window in the channel of the current board.
+ *****************************************************************************/
+void schedule_receiving(RAIL_Handle_t rail_handle, RAIL_Time_t start, RAIL_Time_t duration){
+	RAIL_ScheduleRxConfig_t config = {
+		.start = start,
+		.startMode = RAIL_TIME_ABSOLUTE,
+		.end = duration,
+		.endMode = RAIL_TIME_DELAY,
+		.rxTransitionEndSchedule = 0, //A received packet does not end the window,
+		.hardWindowEnd = 0            //and a packet which started is received after the end of the window.
+	};
+	tuned_channel = channel_of(board_id);
+	RAIL_Status_t rail_status = RAIL_ScheduleRx(rail_handle, tuned_channel, &config, NULL);
+	if(rail_status!=RAIL_STATUS_NO_ERROR)
+		app_log_warning("RAIL_ScheduleRx() result:%d\n", rail_status);
+}
+
+/******************************************************************************
+ * This function turns off the radio.
+ *****************************************************************************/
+void stop_receiving(RAIL_Handle_t rail_handle){
+	RAIL_Idle(rail_handle, RAIL_IDLE, true);
+	account_radio(false);
 }
 
 /** This function helps to unpack the received packet, points to the payload,
@@ -128,52 +442,140 @@ void handle_received_packet (RAIL_Handle_t rail_handle){
 	while (rx_packet_handle != RAIL_RX_PACKET_HANDLE_INVALID) {
 		uint8_t *start_of_packet = 0;
 		uint16_t packet_size = unpack_packet(rx_fifo, &packet_info, &start_of_packet);
-		if(packet_size!=TX_PAYLOAD_LENGTH){
-			app_log_error("Error. Invalid length (%d) of the received packet's payload.\n", packet_size);
+		packet_t packet;
+		if(!decode_packet(start_of_packet, packet_size, &packet)){
+			app_log_error("Error. Invalid packet (%d bytes) was received.\n", packet_size);
+			RAIL_ReleaseRxPacket(rail_handle, rx_packet_handle);
 			rx_packet_handle = RAIL_GetRxPacketInfo(rail_handle, RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE, &packet_info);
 			continue;
 		}
 
+		RAIL_RxPacketDetails_t packet_details;
+		rx_packet_time = 0;
+		rx_packet_rssi = RAIL_RSSI_INVALID_DBM;
+		if(RAIL_GetRxPacketDetailsAlt(rail_handle, rx_packet_handle, &packet_details)==RAIL_STATUS_NO_ERROR){
+			rx_packet_rssi = packet_details.rssi;
+			packet_details.timeReceived.totalPacketBytes = packet_size + 2; //the payload and its 16-bit CRC
+			if(RAIL_GetRxTimePreambleStartAlt(rail_handle, &packet_details)==RAIL_STATUS_NO_ERROR)
+				rx_packet_time = packet_details.timeReceived.packetTime;
+		}
+
 		rail_status = RAIL_ReleaseRxPacket(rail_handle, rx_packet_handle);
 		if (rail_status != RAIL_STATUS_NO_ERROR)
 			app_log_warning("RAIL_ReleaseRxPacket() result:%d", rail_status);
 
-//		printf_rx_packet(start_of_packet); //Uncomment for easier debugging
-		if(start_of_packet[2]==BOARD_ID)  //Necessary check, to ensure that the message was transmitted for me.
-			handle_rx_packet_payload(start_of_packet);
+		if((packet.type==MSG_RESTART || packet.type==MSG_START_TASK) && packet.src<MAX_NUM_OF_BOARDS) //Its sender may have rebooted, and numbers its messages from the start again
+			seq_known[packet.src] = false;
+		if(needs_ack(&packet) && packet.dst==board_id && packet.src<MAX_NUM_OF_BOARDS){ //It was acknowledged, hence its sender retransmits it only if the ACK was lost
+			if(seq_known[packet.src] && last_seq[packet.src]==packet.seq){
+				link_stats.duplicates++;
+				rx_packet_handle = RAIL_GetRxPacketInfo(rail_handle, RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE, &packet_info);
+				continue;
+			}
+			seq_known[packet.src] = true;
+			last_seq[packet.src] = packet.seq;
+		}
+
+//		printf_rx_packet(start_of_packet, packet_size); //Uncomment for easier debugging
+		if(packet.dst==board_id || packet.dst==BROADCAST_ADDRESS)  //Necessary check, to ensure that the message was transmitted for me.
+			handle_rx_packet_payload(&packet);
+		else
+			handle_overheard_packet(rail_handle, &packet);
+		if(!is_asleep()) //The sender is awake (a message which woke up this board counts too)
+			note_awake_board(packet.src);
 
 		rx_packet_handle = RAIL_GetRxPacketInfo(rail_handle, RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE, &packet_info);
 
 		if(false) //just to suppress the warning of unused static function
-			printf_rx_packet(start_of_packet);
+			printf_rx_packet(start_of_packet, packet_size);
 	}
 }
 
+/** Checks a received packet in the RAIL callback, before it is held (see
+ * {@link USE_ACKS}): an ACK completes the message which waits for it, and a
+ * message for this board which needs an ACK gets its ACK (with its sequence
+ * number), while the auto-ACK of any other packet is cancelled.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance used for receiving packets.
+ * @return True if the packet has to be held for the main loop, false if it is
+ * an ACK (which is dropped).
+ */
+static bool check_received_packet(RAIL_Handle_t rail_handle){
+	if(!USE_ACKS)
+		return true;
+	RAIL_RxPacketInfo_t packet_info;
+	RAIL_RxPacketDetails_t packet_details;
+	uint8_t buffer[MAX_PACKET_LENGTH];
+	packet_t packet;
+	RAIL_RxPacketHandle_t rx_packet_handle = RAIL_GetRxPacketInfo(rail_handle, RAIL_RX_PACKET_HANDLE_NEWEST, &packet_info);
+	if(rx_packet_handle==RAIL_RX_PACKET_HANDLE_INVALID){
+		RAIL_CancelAutoAck(rail_handle);
+		return true;
+	}
+	bool valid = packet_info.packetBytes<=MAX_PACKET_LENGTH;
+	if(valid){
+		RAIL_CopyRxPacket(buffer, &packet_info);
+		valid = decode_packet(buffer, packet_info.packetBytes, &packet);
+	}
+	bool is_ack = RAIL_GetRxPacketDetailsAlt(rail_handle, rx_packet_handle, &packet_details)==RAIL_STATUS_NO_ERROR && packet_details.isAck;
+	if(is_ack) //Any packet which arrives while the ACK is awaited ends the wait, and it is not acknowledged itself
+		handle_ack(valid && packet.type==MSG_ACK && packet.src==tx_dst && packet.dst==board_id && packet.seq==tx_seq);
+	if(is_ack || !valid || packet.dst!=board_id || !needs_ack(&packet)){
+		RAIL_CancelAutoAck(rail_handle);
+		return !valid || packet.type!=MSG_ACK; //The ACK of another board, or one which came too late, is dropped
+	}
+	packet_t ack = { .type = MSG_ACK, .src = board_id, .dst = packet.src, .seq = packet.seq };
+	uint8_t length = encode_packet(&ack, buffer);
+	RAIL_WriteAutoAckFifo(rail_handle, buffer, length);
+	ack_in_progress = true;
+	ack_started = RAIL_GetTime();
+	return true;
+}
+
 /******************************************************************************
  * RAIL callback, called if a RAIL event occurs.
  *****************************************************************************/
 void sl_rail_util_on_event(RAIL_Handle_t rail_handle, RAIL_Events_t events){
-	error_code = events;
-
 	if(events & RAIL_EVENTS_RX_COMPLETION) { //Handle Rx events
 		if (events & RAIL_EVENT_RX_PACKET_RECEIVED) { //Keep the packet in the radio buffer, download it later at the state machine
-			RAIL_HoldRxPacket(rail_handle);
-			packet_received = true;
+			if(check_received_packet(rail_handle)){
+				RAIL_HoldRxPacket(rail_handle);
+				post_event(E_PACKET_RECEIVED, 0);
+			}
 		}
-		else  //Handle Rx error
-			rx_error = true;
+		else if(events & RAIL_EVENT_RX_SCHEDULED_RX_MISSED) //A listen window could not be started
+			post_event(E_LISTEN_WINDOW, false);
+		else if(!(events & RAIL_EVENT_RX_ADDRESS_FILTERED)) //Handle Rx error (a frame for another board, dropped by the address filter of USE_ADDRESS_FILTER, is not one)
+			post_event(E_RX_ERROR, events);
 	}
 
+	if(events & RAIL_EVENT_SCHEDULED_RX_STARTED) //A listen window started
+		post_event(E_LISTEN_WINDOW, true);
+	if(events & RAIL_EVENT_RX_SCHEDULED_RX_END) //A listen window ended
+		post_event(E_LISTEN_WINDOW, false);
+
 	if(events & RAIL_EVENTS_TX_COMPLETION) { // Handle Tx events
-		if(events & RAIL_EVENT_TX_PACKET_SENT)
-			packet_sent = true;
+		if(events & RAIL_EVENT_TX_PACKET_SENT){
+			tx_airtime += RAIL_GetTime()-tx_started;
+			if(!awaiting_ack) //Otherwise, the message is sent when its ACK arrives
+				post_event(E_PACKET_SENT, tx_airtime);
+		}
 		else  // Handle Tx error
-			tx_error = true;
+			post_event(E_TX_ERROR, events);
+	}
+
+	if(events & RAIL_EVENT_RX_ACK_TIMEOUT) //The ACK of the last message did not arrive
+		handle_ack(false);
+
+	if(events & RAIL_EVENTS_TXACK_COMPLETION) { //This board has sent an ACK (or could not send it)
+		ack_in_progress = false;
+		post_event(E_ACK_SENT, (events & RAIL_EVENT_TXACK_PACKET_SENT) ? RAIL_GetTime()-ack_started : 0);
 	}
 
 	if(events & RAIL_EVENT_CAL_NEEDED) { // Perform all calibrations when needed
-		calibration_status = RAIL_Calibrate(rail_handle, NULL, RAIL_CAL_ALL_PENDING);
+		RAIL_Status_t calibration_status = RAIL_Calibrate(rail_handle, NULL, RAIL_CAL_ALL_PENDING);
 		if(calibration_status != RAIL_STATUS_NO_ERROR)
-			cal_error = true;
+			post_event(E_CAL_ERROR, calibration_status);
 	}
 }
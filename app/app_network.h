@@ -9,15 +9,50 @@
 
 #include "rail_types.h"
 #include "app_config.h"
+#include "app_codec.h"
 
-///The size of the payload (i.e., bytes with useful information) in the exchanged packets. It should get values between 16 or greater
-#define TX_PAYLOAD_LENGTH 16
+///The destination of a message which is broadcast to all neighbors (only when {@link USE_SHARED_CHANNEL} equals to 1).
+#define BROADCAST_ADDRESS 0xFF
+
+///True if the radio drops the messages for other boards by their destination (see {@link USE_ADDRESS_FILTER}).
+#define FILTERS_ADDRESSES (USE_ADDRESS_FILTER && !USE_SHARED_CHANNEL)
 
 /// The size of the TX & RX FIFOs.
 #define RAIL_FIFO_SIZE (256U)
 
-///A buffer with the payload of the transmitted packet.
-uint8_t tx_packet[TX_PAYLOAD_LENGTH];
+///The time for which the sender of a message waits for its ACK after the transmission (see {@link USE_ACKS}), in microseconds: until the ACK starts arriving, i.e., until its preamble & sync word are received (about 23 ms at 2.4 kbps). RAIL allows at most 65535 us.
+#define ACK_TIMEOUT_MICROSECS 30000
+
+///The maximum number of retransmissions of a message whose ACK does not arrive (see {@link USE_ACKS}). Then the message is given up as if it was sent, and a lost baton is recovered by the restart of the system.
+#define MAX_TX_RETRIES 3
+
+///The slot of the random backoff before a retransmission, in microseconds: the k-th retransmission waits for a random number of slots in [0, 2^k), so that two boards whose messages collided are unlikely to collide again.
+#define TX_BACKOFF_SLOT_MICROSECS 10000
+
+///The longest delay which the retransmissions add to a message (in microseconds), besides their airtime: an ACK timeout per retransmission, and the longest backoff of every retransmission (2^k-1 slots).
+#define MAX_RETRANSMISSION_DELAY_MICROSECS (MAX_TX_RETRIES*ACK_TIMEOUT_MICROSECS + ((1UL<<(MAX_TX_RETRIES+1))-2-MAX_TX_RETRIES)*TX_BACKOFF_SLOT_MICROSECS)
+
+///The maximum number of messages which wait for their transmission (see {@link send_packet()}): while a message is retransmitted, the baton may return to the board before its ACK does.
+#define TX_QUEUE_LENGTH 4
+
+///The counters of the link layer of this board since it was powered up (see {@link USE_ACKS}), printed by the 'energy' CLI command.
+typedef struct {
+	uint32_t retransmissions; ///< The retransmissions of messages whose ACK did not arrive (or which could not be transmitted).
+	uint32_t failures;        ///< The messages which were given up after {@link MAX_TX_RETRIES} retransmissions.
+	uint32_t duplicates;      ///< The retransmitted messages which were received again (since their ACK was lost) and dropped.
+} link_stats_t;
+
+///The counters of the link layer of this board.
+link_stats_t link_stats;
+
+///The message to be transmitted by {@link send_packet()}.
+packet_t tx_packet;
+
+///The time (in the RAIL time of this board) when the preamble of the packet being handled by {@link app_process#handle_rx_packet_payload() handle_rx_packet_payload()} started on the air.
+RAIL_Time_t rx_packet_time;
+
+///The RSSI (in dBm) of the packet being handled by {@link app_process#handle_rx_packet_payload() handle_rx_packet_payload()}, or RAIL_RSSI_INVALID_DBM if it is unknown.
+int8_t rx_packet_rssi;
 
 /** Set up the rail TX FIFO for later usage.
  *
@@ -26,30 +61,132 @@ uint8_t tx_packet[TX_PAYLOAD_LENGTH];
  */
 void set_up_tx_fifo(RAIL_Handle_t rail_handle);
 
-/** This function prepares a packet with the payload stored in {@link tx_packet}
- * buffer, and transmits it.
+/** Configures the auto-ACK of the radio, if {@link USE_ACKS} equals to 1, and
+ * seeds the random backoff of the retransmissions.
+ *
+ * @date 16/10/2026
+ * @param rail_handle A handle to the RAIL instance to be updated.
+ */
+void set_up_auto_ack(RAIL_Handle_t rail_handle);
+
+/** Configures the address filter of the radio, if {@link FILTERS_ADDRESSES}
+ * is true, so that it receives only the messages whose destination (see
+ * app_codec.h) is this board or {@link BROADCAST_ADDRESS}. It is called
+ * whenever the board initializes, since its identity may have been
+ * provisioned meanwhile.
+ *
+ * @date 16/10/2026
+ * @param rail_handle A handle to the RAIL instance to be updated.
+ */
+void set_up_address_filter(RAIL_Handle_t rail_handle);
+
+/** This function encodes the message stored in {@link tx_packet} (see
+ * {@link app_codec.h}), and transmits it. A message of type MSG_CONSENSUS_STATE
+ * or MSG_BATON gets the next sequence number of its destination, and if it is
+ * not broadcast (and {@link USE_ACKS} equals to 1), it is retransmitted until
+ * its ACK arrives (see {@link retransmit_packet()}). The event E_PACKET_SENT
+ * is posted when the message has been acknowledged (or given up), or when it
+ * has been transmitted if it needs no ACK. The messages are transmitted one at
+ * a time, in the order they were sent, so a message sent meanwhile waits in a
+ * queue of {@link TX_QUEUE_LENGTH} messages (see {@link transmit_next_packet()}),
+ * and every message posts its own E_PACKET_SENT. While this board sends the ACK
+ * of a received message, the transmission is deferred until the ACK has been
+ * sent (see {@link resume_deferred_packet()}).
  *
  * @date 10/01/2023
  * @param rail_handle The RAIL instance to be used for TX FIFO writing.
- * @param destination The channel that will be used to transmit the message.
+ * @param destination The board which will receive the message (or
+ * {@link BROADCAST_ADDRESS}). It also determines the channel of the
+ * transmission, if every board receives on its own channel (see
+ * {@link USE_ADDRESS_FILTER}).
  */
 void send_packet(RAIL_Handle_t rail_handle, uint16_t destination);
   
-/** This function opens this board's channel for receiving.
+/** This function removes the message which has been sent (the event
+ * E_PACKET_SENT), or lost (the event E_TX_ERROR), from the queue, and transmits the next one, if any.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for TX FIFO writing.
+ */
+void transmit_next_packet(RAIL_Handle_t rail_handle);
+
+/** This function retransmits the last message, after its ACK did not arrive
+ * (the event E_TX_RETRY).
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for TX FIFO writing.
+ */
+void retransmit_packet(RAIL_Handle_t rail_handle);
+
+/** This function transmits the last message, if its transmission was deferred
+ * while this board sent an ACK (the event E_ACK_SENT).
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for TX FIFO writing.
+ */
+void resume_deferred_packet(RAIL_Handle_t rail_handle);
+
+/** This function stops the retransmissions of the last message, whose ACK (or
+ * its retransmission) is no longer awaited, and drops the messages which wait
+ * in the queue, e.g., when the board re-initializes.
+ *
+ * @date 16/10/2026
+ */
+void cancel_retransmission();
+
+/** This function prints the counters of the link layer ({@link link_stats}) to
+ * the console.
+ *
+ * @date 16/10/2026
+ */
+void print_link_stats();
+
+/** This function opens this board's channel (or the shared channel, if
+ * {@link USE_SHARED_CHANNEL} or {@link USE_ADDRESS_FILTER} equals to 1) for
+ * receiving.
  *
  * @date 10/01/2023
  * @param rail_handle The RAIL instance to be used for receiving packets.
  */
 void start_receiving (RAIL_Handle_t rail_handle);
+
+/** This function schedules a receive window in this board's channel (or the
+ * shared channel, see {@link start_receiving()}). The radio is
+ * turned off until the window starts and after it ends (the events
+ * RAIL_EVENT_SCHEDULED_RX_STARTED and RAIL_EVENT_RX_SCHEDULED_RX_END), unless
+ * a packet is being received. Calling {@link start_receiving()} or
+ * {@link stop_receiving()} cancels the window.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance to be used for receiving packets.
+ * @param start The start of the window (in the RAIL time of this board).
+ * @param duration The duration of the window, in microseconds.
+ */
+void schedule_receiving(RAIL_Handle_t rail_handle, RAIL_Time_t start, RAIL_Time_t duration);
+
+/** This function turns off the radio (until {@link start_receiving()} or
+ * {@link send_packet()} is called), so that the board can drop to EM2.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ */
+void stop_receiving(RAIL_Handle_t rail_handle);
   
-/** This function receives the packet, processes it and frees the RX FIFO.
+/** This function receives the packet, decodes it (dropping invalid packets),
+ * processes it and frees the RX FIFO. The packets for other boards are passed
+ * to {@link app_process#handle_overheard_packet() handle_overheard_packet()}.
+ * A retransmitted message which was received already (its sequence number is
+ * the last one from its sender) is dropped.
  *
  * @date 10/01/2023
  * @param rail_handle The RAIL instance used for receiving packets.
  */
 void handle_received_packet (RAIL_Handle_t rail_handle);
 
-/** The RAIL callback, which is called if a RAIL event occurs.
+/** The RAIL callback, which is called if a RAIL event occurs. A received packet
+ * is checked before it is held: an ACK completes the message which waits for
+ * it, and the auto-ACK is cancelled unless the packet is a message for this
+ * board which needs an ACK.
  *
  * @date 10/01/2023
  * @param rail_handle The RAIL handle associated with the RAIL event
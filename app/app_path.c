@@ -0,0 +1,160 @@
+/***************************************************************************//**
+ * @file app_path.c
+ * @brief Implementation file for the generation of the baton path from the graph.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include "app_path.h"
+#include <string.h>
+
+///The edges of the current walk: used[i][j] is true if the walk passes from board i to board j.
+static bool used[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+
+/** Extends a walk along the shortest route of unused edges from its last
+ * board to the nearest unvisited board, or to a given board.
+ *
+ * @date 16/10/2026
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param visited The visited boards (the board at the end of the route becomes visited).
+ * @param target The board where the route ends, or -1 for the nearest unvisited board.
+ * @param path The walk.
+ * @param len The length of the walk, which is increased by the route (the
+ * target itself is not appended if it is the first board of the walk).
+ * @return True if a route exists (and fits in the path), false otherwise.
+ */
+static bool extend_walk(uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool *visited, int target, int8_t *path, uint8_t *len){
+	int8_t parent[MAX_NUM_OF_BOARDS];
+	uint8_t queue[MAX_NUM_OF_BOARDS], head = 0, tail = 0;
+	int from = path[*len-1], found = -1;
+	memset(parent, -1, sizeof(parent));
+	parent[from] = from;
+	queue[tail++] = from;
+	while(head<tail && found<0){ //BFS over the unused edges
+		int cur = queue[head++];
+		for(int next=0;next<boards;next++){
+			if(next==cur || !g[cur][next] || used[cur][next])
+				continue;
+			if(next==target || (target<0 && !visited[next])){
+				parent[next] = cur;
+				found = next;
+				break;
+			}
+			if(parent[next]<0){
+				parent[next] = cur;
+				queue[tail++] = next;
+			}
+		}
+	}
+	if(found<0)
+		return false;
+
+	int8_t route[MAX_NUM_OF_BOARDS]; //the boards of the route, from its end backwards
+	int hops = 0;
+	bool closes = found==path[0]; //the first board of the walk is not repeated
+	for(int b=found;b!=from;b=parent[b]){
+		route[hops++] = b;
+		used[parent[b]][b] = true;
+	}
+	if(*len + hops - closes > MAX_LENGTH_OF_BATON_PATH)
+		return false;
+	for(int i=hops-1;i>=closes;i--)
+		path[(*len)++] = route[i];
+	visited[found] = true;
+	return true;
+}
+
+/** Builds a closed walk which visits every board, starting from a board.
+ *
+ * @date 16/10/2026
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param start The first board of the walk.
+ * @param path The walk.
+ * @return The length of the walk, or 0 if the walk could not be closed.
+ */
+static uint8_t walk_from(uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], int start, int8_t *path){
+	bool visited[MAX_NUM_OF_BOARDS] = { false };
+	uint8_t len = 0;
+	int left = boards-1;
+	memset(used, 0, sizeof(used));
+	path[len++] = start;
+	visited[start] = true;
+	while(left>0){
+		int cur = path[len-1], best = -1, best_degree = 0;
+		for(int next=0;next<boards;next++){ //the unvisited neighbor with the fewest unvisited neighbors, which is hard to reach later
+			if(next==cur || !g[cur][next] || visited[next] || used[cur][next])
+				continue;
+			int degree = 0;
+			for(int k=0;k<boards;k++)
+				degree += k!=next && g[next][k] && !visited[k];
+			if(best<0 || degree<best_degree){
+				best = next;
+				best_degree = degree;
+			}
+		}
+		if(best>=0){
+			if(len==MAX_LENGTH_OF_BATON_PATH)
+				return 0;
+			used[cur][best] = true;
+			visited[best] = true;
+			path[len++] = best;
+		}
+		else if(!extend_walk(boards, g, visited, -1, path, &len))
+			return 0;
+		left--;
+	}
+	return extend_walk(boards, g, visited, start, path, &len) ? len : 0;
+}
+
+/** Builds the Euler tour of a DFS tree of the graph (from board 0), which
+ * passes every edge of the tree once in every direction.
+ *
+ * @date 16/10/2026
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param path The tour.
+ * @return The length of the tour, or 0 if the graph is not connected.
+ */
+static uint8_t euler_tour(uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], int8_t *path){
+	bool visited[MAX_NUM_OF_BOARDS] = { false };
+	int8_t stack[MAX_NUM_OF_BOARDS];
+	int depth = 0, count = 1;
+	uint8_t len = 0;
+	stack[depth++] = 0;
+	visited[0] = true;
+	path[len++] = 0;
+	while(depth>0){
+		int cur = stack[depth-1], next = 0;
+		while(next<boards && (visited[next] || !g[cur][next]))
+			next++;
+		if(next<boards){ //down to a new child
+			visited[next] = true;
+			count++;
+			stack[depth++] = next;
+		}
+		else if(--depth>0)
+			next = stack[depth-1]; //back to the parent
+		else
+			break;
+		path[len++] = next;
+	}
+	return count==boards ? len-1 : 0; //the tour ends back at board 0, which is not repeated
+}
+
+/*******************************************************************************
+ * Generates a baton path from a graph.
+ ******************************************************************************/
+uint8_t generate_baton_path(uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], int8_t *path){
+	int8_t walk[MAX_LENGTH_OF_BATON_PATH];
+	uint8_t len = euler_tour(boards, g, path);
+	if(!len)
+		return 0;
+	for(int start=0;start<boards;start++){
+		uint8_t walk_len = walk_from(boards, g, start, walk);
+		if(walk_len && walk_len<len){
+			len = walk_len;
+			memcpy(path, walk, len);
+		}
+	}
+	return len;
+}
@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @file app_path.h
+ * @brief Header file for the generation of the baton path from the graph, so
+ * that it does not have to be written by hand (see {@link USE_AUTO_BATON_PATH}
+ * and the 'provision' CLI command).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_PATH_H
+#define APP_PATH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+
+/** Generates a short baton path which obeys the rules of {@link baton_path}
+ * from a graph. The path is a closed walk which passes every edge at most once
+ * in every direction, hence the next board of the baton is determined by the
+ * previous one (RULE 4). A walk is built from every board: it moves to the
+ * unvisited neighbor with the fewest unvisited neighbors, or along the shortest
+ * route of unused edges to the nearest unvisited board, and finally returns to
+ * its first board. The shortest walk is kept, or the Euler tour of a DFS tree
+ * (twice the edges of the tree) if no walk can be closed. The result depends
+ * only on the graph, so every board generates the same path.
+ *
+ * @date 16/10/2026
+ * @param boards The total number of boards.
+ * @param g The graph (see {@link graph}).
+ * @param path The array where the path is stored, of {@link MAX_LENGTH_OF_BATON_PATH} elements.
+ * @return The length of the path, or 0 if the graph is not connected.
+ */
+uint8_t generate_baton_path(uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], int8_t *path);
+
+#endif  // APP_PATH_H
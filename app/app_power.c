@@ -0,0 +1,384 @@
+/***************************************************************************//**
+ * @file app_power.c
+ * @brief Implementation file for the energy management of the board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_power.h"
+#include "rail.h"
+#include "sl_sleeptimer.h"
+#include "app_log.h"
+#include "app_config.h"
+#include "app_network.h"
+#include "app_events.h"
+
+///The counters of the board since it was powered on. The times are in sleeptimer ticks, except from the transmissions.
+typedef struct {
+	uint64_t ticks;                             ///< The time.
+	uint64_t em_ticks[SL_POWER_MANAGER_EM3];    ///< The time spent in EM0, EM1 and EM2.
+	uint64_t radio_off_ticks;                   ///< The time the radio was turned off.
+	uint64_t tx_microsecs;                      ///< The time spent transmitting, in microseconds.
+} energy_counters_t;
+
+///A measured period of the board (a run, or the idle period after it): the counters at its start and at its end.
+typedef struct {
+	energy_counters_t start;                    ///< The counters at the start of the period.
+	energy_counters_t end;                      ///< The counters at the end of the period (once it has ended).
+	bool measuring;                             ///< True while the period has not ended.
+	bool measured;                              ///< True if such a period has been started since the board was powered on.
+} energy_period_t;
+
+///The counters of the board, until the last EM transition (for the energy modes) and until the radio was last turned on (for the radio).
+static energy_counters_t counters;
+
+///The current run of the board (or the last one).
+static energy_period_t run;
+
+///The current idle period of the board (or the last one), i.e., from the end of a run until the start of the next one.
+static energy_period_t idle;
+
+///The current energy mode of the MCU.
+static sl_power_manager_em_t current_em;
+
+///The tick of the last EM transition.
+static uint64_t em_since;
+
+///True while the radio is turned off.
+static bool radio_off;
+
+///The tick when the radio was turned off.
+static uint64_t radio_off_since;
+
+///The shortest transmission of this board (0 until one has been measured), in microseconds.
+static RAIL_Time_t shortest_tx;
+
+///Turns the radio on at the end of a radio sleep window.
+static RAIL_MultiTimer_t radio_tmr;
+
+///True while a sleeping board receives in periodic listen windows (see {@link start_low_power_listen()}).
+static bool listening;
+
+///The start of the next listen window (in the RAIL time of this board).
+static RAIL_Time_t next_window;
+
+///The boards which have been heard since this board last went to sleep, i.e., which are awake (see {@link begin_wake_train()}).
+static bool awake_boards[MAX_NUM_OF_BOARDS];
+
+///True while a start (or restart) message is repeated as a wake-up train, until {@link train_end}.
+static bool train;
+
+///The end of the current wake-up train (in the RAIL time of this board).
+static RAIL_Time_t train_end;
+
+/** Converts sleeptimer ticks to microseconds.
+ *
+ * @date 16/10/2026
+ * @param ticks The ticks.
+ * @return The microseconds.
+ */
+static uint64_t ticks_to_microsecs(uint64_t ticks){
+	return ticks*1000000ULL/sl_sleeptimer_get_timer_frequency();
+}
+
+/** Maps an energy mode to its counter in {@link energy_counters_t} (EM3 and below are counted as EM2).
+ *
+ * @date 16/10/2026
+ * @param em The energy mode.
+ * @return The index of the counter.
+ */
+static int em_index(sl_power_manager_em_t em){
+	return em<SL_POWER_MANAGER_EM2 ? (int) em : (int) SL_POWER_MANAGER_EM2;
+}
+
+/** Reads the counters of the board until now.
+ *
+ * @date 16/10/2026
+ * @param now The counters.
+ */
+static void read_counters(energy_counters_t *now){
+	*now = counters;
+	now->ticks = sl_sleeptimer_get_tick_count64();
+	now->em_ticks[em_index(current_em)] += now->ticks-em_since;
+	if(radio_off)
+		now->radio_off_ticks += now->ticks-radio_off_since;
+}
+
+/** Starts a new period.
+ *
+ * @date 16/10/2026
+ * @param period The period.
+ */
+static void start_period(energy_period_t *period){
+	read_counters(&period->start);
+	period->measuring = true;
+	period->measured = true;
+}
+
+/** Ends a period, so that it is reported until the next one starts. It does
+ * nothing if the period has already ended.
+ *
+ * @date 16/10/2026
+ * @param period The period.
+ */
+static void stop_period(energy_period_t *period){
+	if(!period->measuring)
+		return;
+	read_counters(&period->end);
+	period->measuring = false;
+}
+
+/** Computes the energy estimate of a period (until now, if it has not ended).
+ *
+ * @date 16/10/2026
+ * @param period The period.
+ * @param estimate The estimate.
+ * @return False if no such period has been started.
+ */
+static bool estimate_period(const energy_period_t *period, energy_estimate_t *estimate){
+	if(!period->measured)
+		return false;
+	energy_counters_t end = period->end;
+	if(period->measuring)
+		read_counters(&end);
+	const energy_counters_t *start = &period->start;
+
+	estimate->duration = ticks_to_microsecs(end.ticks-start->ticks);
+	for(int i=0;i<SL_POWER_MANAGER_EM3;i++)
+		estimate->em[i] = ticks_to_microsecs(end.em_ticks[i]-start->em_ticks[i]);
+	estimate->radio_off = ticks_to_microsecs(end.radio_off_ticks-start->radio_off_ticks);
+	uint64_t tx = end.tx_microsecs-start->tx_microsecs;
+	estimate->tx = tx<estimate->duration-estimate->radio_off ? tx : estimate->duration-estimate->radio_off;
+	estimate->rx = estimate->duration-estimate->radio_off-estimate->tx;
+	estimate->charge_uc = ((float) estimate->em[SL_POWER_MANAGER_EM0]*CURRENT_EM0_MICROAMPS
+			+ (float) estimate->em[SL_POWER_MANAGER_EM1]*CURRENT_EM1_MICROAMPS
+			+ (float) estimate->em[SL_POWER_MANAGER_EM2]*CURRENT_EM2_MICROAMPS
+			+ (float) estimate->rx*CURRENT_RX_MICROAMPS
+			+ (float) estimate->tx*CURRENT_TX_MICROAMPS)/1e6f; //uA x us = pC
+	return true;
+}
+
+/** Prints the energy estimate of a period to the console.
+ *
+ * @date 16/10/2026
+ * @param name The name of the period.
+ * @param period The period.
+ */
+static void print_period(const char *name, const energy_period_t *period){
+	energy_estimate_t estimate;
+	if(!estimate_period(period, &estimate)){
+		app_log_info("No %s has been measured yet.\n", name);
+		return;
+	}
+	app_log_info("%s %s: %.3f s.\n", period->measuring ? "Current" : "Last", name, estimate.duration/1e6);
+	app_log_info("  EM0: %10.3f ms\n  EM1: %10.3f ms\n  EM2: %10.3f ms\n",
+			estimate.em[SL_POWER_MANAGER_EM0]/1e3, estimate.em[SL_POWER_MANAGER_EM1]/1e3, estimate.em[SL_POWER_MANAGER_EM2]/1e3);
+	app_log_info("  Radio RX: %10.3f ms, TX: %10.3f ms, off: %10.3f ms\n", estimate.rx/1e3, estimate.tx/1e3, estimate.radio_off/1e3);
+	app_log_info("  Estimated charge: %.3f mC (average current %.3f mA)\n", estimate.charge_uc/1e3,
+			estimate.duration>0 ? estimate.charge_uc/(estimate.duration/1e3) : 0);
+}
+
+/*******************************************************************************
+ * Starts the energy estimate of a new run, which ends the idle period.
+ ******************************************************************************/
+void start_energy_estimate(){
+	stop_period(&idle);
+	start_period(&run);
+}
+
+/*******************************************************************************
+ * Stops the energy estimate of the current run, and starts the idle period.
+ ******************************************************************************/
+void stop_energy_estimate(){
+	stop_period(&run);
+	start_period(&idle);
+}
+
+/*******************************************************************************
+ * Accounts a transition between two energy modes.
+ ******************************************************************************/
+void account_em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to){
+	(void)from;
+	uint64_t now = sl_sleeptimer_get_tick_count64();
+	counters.em_ticks[em_index(current_em)] += now-em_since;
+	em_since = now;
+	current_em = to;
+}
+
+/*******************************************************************************
+ * Accounts that the radio was turned on or off.
+ ******************************************************************************/
+void account_radio(bool on){
+	uint64_t now = sl_sleeptimer_get_tick_count64();
+	if(on && radio_off)
+		counters.radio_off_ticks += now-radio_off_since;
+	else if(!on && !radio_off)
+		radio_off_since = now;
+	radio_off = !on;
+}
+
+/*******************************************************************************
+ * Accounts a completed transmission.
+ ******************************************************************************/
+void account_transmission(RAIL_Time_t duration){
+	counters.tx_microsecs += duration;
+	if(shortest_tx==0 || duration<shortest_tx)
+		shortest_tx = duration;
+}
+
+/*******************************************************************************
+ * Accounts an ACK sent by this board.
+ ******************************************************************************/
+void account_ack(RAIL_Time_t duration){
+	counters.tx_microsecs += duration;
+}
+
+/*******************************************************************************
+ * Computes the energy estimate of the current (or the last) run.
+ ******************************************************************************/
+bool get_energy_estimate(energy_estimate_t *estimate){
+	return estimate_period(&run, estimate);
+}
+
+/*******************************************************************************
+ * Computes the energy estimate of the current (or the last) idle period.
+ ******************************************************************************/
+bool get_idle_estimate(energy_estimate_t *estimate){
+	return estimate_period(&idle, estimate);
+}
+
+/*******************************************************************************
+ * Prints the energy estimates of the current (or the last) run and idle period.
+ ******************************************************************************/
+void print_energy_estimate(){
+	print_period("run", &run);
+	print_period("idle period", &idle);
+}
+
+/** The callback function of the radio timer, at the end of a radio sleep
+ * window. It posts the event {@link app_events#event_t E_RADIO_WAKE}, so that
+ * the main loop turns the radio on.
+ *
+ * @date 16/10/2026
+ * @param tmr Is not used.
+ * @param expectedTimeOfEvent Is not used.
+ * @param cbArg Is not used.
+ */
+static void radio_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)expectedTimeOfEvent; (void)cbArg;
+	post_event(E_RADIO_WAKE, 0);
+}
+
+/*******************************************************************************
+ * Turns off the radio until the baton can return to the neighborhood.
+ ******************************************************************************/
+void plan_radio_sleep(RAIL_Handle_t rail_handle, uint8_t src, uint8_t dst, RAIL_Time_t rx_time){
+	if(!USE_RADIO_SLEEP || shortest_tx==0 || radio_off)
+		return;
+	int steps = -1; //the fewest steps of the baton until it can be heard again
+	for(int k=0;k<length_of_baton_path;k++){ //the same pair may appear at several positions of the path
+		if(baton_path[k]!=src || baton_path[(k+1)%length_of_baton_path]!=dst)
+			continue;
+		int s = 0;
+		for(int j=(k+1)%length_of_baton_path; s<length_of_baton_path; j=(j+1)%length_of_baton_path, s++)
+			if(baton_path[j]==board_id || directed_graph[board_id][baton_path[j]])
+				break;
+		if(steps<0 || s<steps)
+			steps = s;
+	}
+	if(steps<=0)
+		return;
+	RAIL_Time_t wake_time = rx_time + steps*shortest_tx - RADIO_WAKEUP_GUARD_MICROSECS;
+	if((int32_t)(wake_time-RAIL_GetTime()) < MIN_RADIO_SLEEP_MICROSECS)
+		return;
+	RAIL_SetMultiTimer(&radio_tmr, wake_time, RAIL_TIME_ABSOLUTE, &radio_alarm, NULL);
+	stop_receiving(rail_handle);
+}
+
+/*******************************************************************************
+ * Cancels the end of a radio sleep window.
+ ******************************************************************************/
+void cancel_radio_sleep(){
+	RAIL_CancelMultiTimer(&radio_tmr);
+}
+
+/*******************************************************************************
+ * Starts receiving in periodic listen windows, while the board sleeps.
+ ******************************************************************************/
+void start_low_power_listen(RAIL_Handle_t rail_handle){
+	if(!USE_LOW_POWER_LISTEN || USE_TDMA)
+		return;
+	listening = true;
+	train = false;
+	for(int j=0;j<MAX_NUM_OF_BOARDS;j++) //The neighbors may go to sleep too
+		awake_boards[j] = false;
+	stop_receiving(rail_handle);
+	next_window = RAIL_GetTime() + LISTEN_INTERVAL_MILISECS*1000;
+	schedule_receiving(rail_handle, next_window, LISTEN_WINDOW_MILISECS*1000);
+}
+
+/*******************************************************************************
+ * Receives continuously again, after the board woke up.
+ ******************************************************************************/
+void stop_low_power_listen(RAIL_Handle_t rail_handle){
+	if(!listening)
+		return;
+	listening = false;
+	start_receiving(rail_handle); //It also cancels the next listen window
+}
+
+/*******************************************************************************
+ * Returns whether the board receives in periodic listen windows.
+ ******************************************************************************/
+bool is_listening(){
+	return listening;
+}
+
+/*******************************************************************************
+ * Handles the start or the end of a listen window.
+ ******************************************************************************/
+void handle_listen_window(RAIL_Handle_t rail_handle, bool opened){
+	if(!listening) //A window which ended after the board woke up
+		return;
+	account_radio(opened);
+	if(opened)
+		return;
+	RAIL_Time_t now = RAIL_GetTime();
+	do //The windows keep their period, unless the board was too busy to schedule the next one in time
+		next_window += LISTEN_INTERVAL_MILISECS*1000;
+	while((int32_t)(next_window-now) <= 0);
+	schedule_receiving(rail_handle, next_window, LISTEN_WINDOW_MILISECS*1000);
+}
+
+/*******************************************************************************
+ * Records that a board is awake.
+ ******************************************************************************/
+void note_awake_board(uint8_t board){
+	if(board<MAX_NUM_OF_BOARDS)
+		awake_boards[board] = true;
+}
+
+/*******************************************************************************
+ * Starts a wake-up train, if the destination may be sleeping.
+ ******************************************************************************/
+void begin_wake_train(uint16_t destination){
+	if(!USE_LOW_POWER_LISTEN || USE_TDMA || train)
+		return;
+	bool sleeping = false;
+	for(int j=0;j<num_of_boards;j++)
+		if(j!=board_id && graph[board_id][j] && !awake_boards[j] && (destination==BROADCAST_ADDRESS || destination==j))
+			sleeping = true;
+	if(!sleeping)
+		return;
+	train = true;
+	train_end = RAIL_GetTime() + (LISTEN_INTERVAL_MILISECS+LISTEN_WINDOW_MILISECS)*1000;
+}
+
+/*******************************************************************************
+ * Decides whether the message of the wake-up train has to be repeated.
+ ******************************************************************************/
+bool wake_train_continues(){
+	if(train && (int32_t)(RAIL_GetTime()-train_end) < 0)
+		return true;
+	train = false;
+	return false;
+}
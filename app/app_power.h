@@ -0,0 +1,224 @@
+/***************************************************************************//**
+ * @file app_power.h
+ * @brief Header file for the energy management of the board: the estimate of
+ * the energy spent during a run and during the idle period after it (from the
+ * time spent in every energy mode and the time of the radio), the radio sleep
+ * windows, where the radio is turned off (and the MCU drops to EM2) while the
+ * baton is too far away to reach the neighborhood of this board (see
+ * {@link USE_RADIO_SLEEP}), and the periodic listen windows of a sleeping
+ * board, together with the wake-up trains which reach them (see
+ * {@link USE_LOW_POWER_LISTEN}).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_POWER_H
+#define APP_POWER_H
+
+#include "rail_types.h"
+#include "sl_power_manager.h"
+
+///The time before the earliest return of the baton to the neighborhood of this board, when the radio receives again, in microseconds. It covers the wake-up from EM2, the start of the radio and the drift between the timers of the boards.
+#define RADIO_WAKEUP_GUARD_MICROSECS 5000
+
+///The shortest radio sleep window, in microseconds. A shorter one is skipped, since it saves less than the wake-up costs.
+#define MIN_RADIO_SLEEP_MICROSECS 10000
+
+///The typical current of the EFR32MG12 in EM0 (69 uA/MHz at 38.4 MHz), in microamperes.
+#define CURRENT_EM0_MICROAMPS 2650
+
+///The typical current of the EFR32MG12 in EM1 (35 uA/MHz at 38.4 MHz), in microamperes.
+#define CURRENT_EM1_MICROAMPS 1350
+
+///The typical current of the EFR32MG12 in EM2 (full RAM retention, RTCC running from the LFXO), in microamperes.
+#define CURRENT_EM2_MICROAMPS 3
+
+///The typical additional current of the radio while receiving, in microamperes.
+#define CURRENT_RX_MICROAMPS 8700
+
+///The typical additional current of the radio while transmitting (at the 10 dBm of SL_RAIL_UTIL_PA_POWER_DECI_DBM), in microamperes.
+#define CURRENT_TX_MICROAMPS 17000
+
+///The energy estimate of a run, i.e., from {@link app_tools#wake_up() wake_up()} until {@link app_tools#sleep() sleep()}, or of an idle period, i.e., from {@link app_tools#sleep() sleep()} until {@link app_tools#wake_up() wake_up()}. All times are in microseconds.
+typedef struct {
+	uint64_t duration;                         ///< The duration of the run.
+	uint64_t em[SL_POWER_MANAGER_EM3];         ///< The time spent in EM0, EM1 and EM2.
+	uint64_t rx;                               ///< The time the radio was receiving.
+	uint64_t tx;                               ///< The time the radio was transmitting.
+	uint64_t radio_off;                        ///< The time the radio was turned off.
+	float charge_uc;                           ///< The estimated charge, in microcoulombs.
+} energy_estimate_t;
+
+/** Starts the energy estimate of a new run (see {@link app_tools#wake_up() wake_up()}),
+ * and stops the one of the idle period.
+ *
+ * @date 16/10/2026
+ */
+void start_energy_estimate();
+
+/** Stops the energy estimate of the current run (see {@link app_tools#sleep() sleep()}),
+ * so that it is reported until the next run starts, and starts the one of the
+ * idle period. The first idle period starts when the board goes to sleep for
+ * the first time.
+ *
+ * @date 16/10/2026
+ */
+void stop_energy_estimate();
+
+/** Accounts a transition between two energy modes. It is called by the
+ * callback of the EM transition events of the PowerManager, hence it does not
+ * use the time of RAIL (which is synchronized during these transitions).
+ *
+ * @date 16/10/2026
+ * @param from The previous energy mode.
+ * @param to The new energy mode.
+ */
+void account_em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to);
+
+/** Accounts that the radio was turned on or off (see
+ * {@link app_network#start_receiving() start_receiving()} and
+ * {@link app_network#stop_receiving() stop_receiving()}).
+ *
+ * @date 16/10/2026
+ * @param on True if the radio receives from now on, false if it is off.
+ */
+void account_radio(bool on);
+
+/** Accounts a completed transmission. Its duration (from RAIL_StartTx() until
+ * the packet was sent) is also the shortest time for the baton to make a step,
+ * which bounds the radio sleep windows.
+ *
+ * @date 16/10/2026
+ * @param duration The duration of the transmission, in microseconds.
+ */
+void account_transmission(RAIL_Time_t duration);
+
+/** Accounts an ACK sent by this board (see {@link USE_ACKS}), as a
+ * transmission which does not bound the radio sleep windows.
+ *
+ * @date 16/10/2026
+ * @param duration The duration from the reception of the acknowledged message
+ * until the ACK was sent (an upper bound of its transmission), in microseconds.
+ */
+void account_ack(RAIL_Time_t duration);
+
+/** Computes the energy estimate of the current run (until now), or of the last
+ * one if the board sleeps.
+ *
+ * @date 16/10/2026
+ * @param estimate The estimate.
+ * @return False if no run has been started since the board was powered on.
+ */
+bool get_energy_estimate(energy_estimate_t *estimate);
+
+/** Computes the energy estimate of the current idle period (until now), or of
+ * the last one if the board is awake.
+ *
+ * @date 16/10/2026
+ * @param estimate The estimate.
+ * @return False if the board has not slept since it was powered on.
+ */
+bool get_idle_estimate(energy_estimate_t *estimate);
+
+/** Prints the energy estimates of the current (or the last) run and idle
+ * period to the console.
+ *
+ * @date 16/10/2026
+ */
+void print_energy_estimate();
+
+/** Turns off the radio until the baton can return to the neighborhood of this
+ * board, after the baton was overheard between two other boards. The baton
+ * needs at least one transmission per step, hence it reaches the first board
+ * of its path which is this board or a neighbor after the steps of the boards
+ * which cannot be heard, times the shortest transmission of this board. The
+ * radio is turned on again (with the event
+ * {@link app_events#event_t E_RADIO_WAKE}) {@link RADIO_WAKEUP_GUARD_MICROSECS}
+ * before that time. It does nothing if {@link USE_RADIO_SLEEP} equals to 0,
+ * if no transmission has been measured yet, or if the window would be shorter
+ * than {@link MIN_RADIO_SLEEP_MICROSECS}.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ * @param src The board which released the baton.
+ * @param dst The board which received the baton.
+ * @param rx_time The time (in the RAIL time of this board) when the preamble
+ * of the overheard baton started on the air.
+ */
+void plan_radio_sleep(RAIL_Handle_t rail_handle, uint8_t src, uint8_t dst, RAIL_Time_t rx_time);
+
+/** Cancels the end of a radio sleep window (e.g., when this board transmits,
+ * after which the radio receives anyway, or when it is re-initialized).
+ *
+ * @date 16/10/2026
+ */
+void cancel_radio_sleep();
+
+/** Turns off the radio of a sleeping board, and schedules its first listen
+ * window {@link LISTEN_INTERVAL_MILISECS} later. Every window lasts
+ * {@link LISTEN_WINDOW_MILISECS}, and its end (the event
+ * {@link app_events#event_t E_LISTEN_WINDOW}) schedules the next one. It does
+ * nothing if {@link USE_LOW_POWER_LISTEN} equals to 0, or in TDMA mode.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ */
+void start_low_power_listen(RAIL_Handle_t rail_handle);
+
+/** Cancels the listen windows, after the board woke up (e.g., by a start
+ * message or the CLI), and receives continuously again.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ */
+void stop_low_power_listen(RAIL_Handle_t rail_handle);
+
+/** Returns whether the board receives in periodic listen windows.
+ *
+ * @date 16/10/2026
+ * @return True between {@link start_low_power_listen()} and
+ * {@link stop_low_power_listen()}.
+ */
+bool is_listening();
+
+/** Handles the start or the end of a listen window (the event
+ * {@link app_events#event_t E_LISTEN_WINDOW}): it accounts the time of the
+ * radio, and schedules the next window at the end of one.
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ * @param opened True if the window started, false if it ended (or was missed).
+ */
+void handle_listen_window(RAIL_Handle_t rail_handle, bool opened);
+
+/** Records that a board is awake, since a message of it was handled while this
+ * board is awake. Such a board needs no wake-up train, until this board goes
+ * to sleep again.
+ *
+ * @date 16/10/2026
+ * @param board The board.
+ */
+void note_awake_board(uint8_t board);
+
+/** Starts a wake-up train before a start (or restart) message is sent, if the
+ * destination (or any neighbor, for a broadcast) may be sleeping: the message
+ * is then repeated for {@link LISTEN_INTERVAL_MILISECS} plus
+ * {@link LISTEN_WINDOW_MILISECS}, which covers a whole listen window of every
+ * sleeping neighbor (see {@link wake_train_continues()}). It does nothing if
+ * {@link USE_LOW_POWER_LISTEN} equals to 0, in TDMA mode, or if a train is
+ * already being sent.
+ *
+ * @date 16/10/2026
+ * @param destination The destination of the message (or
+ * {@link app_network#BROADCAST_ADDRESS BROADCAST_ADDRESS}).
+ */
+void begin_wake_train(uint16_t destination);
+
+/** Decides whether the message of the current wake-up train has to be sent
+ * once more. It is called after every transmission of the message, and ends
+ * the train when it returns false.
+ *
+ * @date 16/10/2026
+ * @return True if the train has not lasted long enough yet.
+ */
+bool wake_train_continues();
+
+#endif  // APP_POWER_H
@@ -4,29 +4,34 @@
  * @author Georgios Apostolakis
  ******************************************************************************/
 #include "app_process.h"
-#include <math.h>
+#include <string.h>
 #include "rail.h"
 #include "app_log.h"
 #include "app_network.h"
 #include "app_stack.h"
 #include "app_tools.h"
 #include "app_consensus.h"
+#include "app_tdma.h"
+#include "app_discovery.h"
+#include "app_events.h"
+#include "app_trace.h"
+#include "app_power.h"
+#include "app_routing.h"
+#include "app_gossip.h"
 
 // -----------------------------------------------------------------------------
 //                   Definitions of Constants and Typedefs
 // -----------------------------------------------------------------------------
 /** The various states from the state machine of the application.
 * - S_RESTART_COMPLETED: When the board enters this state, it has completed a re-initialization and is going to start the average consensus task from the beginning.
-* - S_START_AVG_CONSENSUS: The first state of the average consensus task, where the algorithm is initialized.
-* - S_SEND_AVG_CONSENSUS_MSGS: The board enters this state during the average consensus task, and sends its state to all the commuting boards (according to the system's graph).
+* - S_START_AVG_CONSENSUS: The first state of the average consensus task (or of the randomized gossip), where the algorithm is initialized.
+* - S_SEND_AVG_CONSENSUS_MSGS: The board enters this state during the average consensus task, and sends its state to all the commuting boards (according to the system's graph), with the baton to its next holder.
 * - S_UPDATE_AVG_CONSENSUS_STATE: The board enters this state during the average consensus task, and updates its state.
 * - S_INIT_AND_SLEEP: The last state of the board before it sleeps, where it initializes itself.
 * - S_PACKET_TX: A generic state where the board transmits a message (whose exact type depends on the {@link tx_operation_to_achieve} variable.
-* - S_PACKET_RECEIVED: A generic state which handles the received packets.
-* - S_PACKET_SENT: A generic state which makes some necessary actions after a transmission has been completed.
-* - S_RX_PACKET_ERROR: A generic state which handles the case of an error to the reception of a packet.
-* - S_TX_PACKET_ERROR: A generic state which handles the case of an error to the transmission of a packet.
-* - S_CALIBRATION_ERROR: A generic state which handles the case of an error to the calibration of this board.
+* - S_TDMA_NEW_FRAME: A new frame of the TDMA schedule has started (only if {@link USE_TDMA} equals to 1, or during the discovery of the graph), and the board updates its state with the states received during the previous frame (or completes the discovery).
+* - S_TDMA_MY_SLOT: The TDMA slot of this board has started (only if {@link USE_TDMA} equals to 1, or during the discovery of the graph), and the board broadcasts the start message (during the setup frames) or its state (or a message of the discovery).
+* - S_FLOOD_RELAYED: The board has relayed a flooded control message (see app_routing.h), and returns to the state where it was waiting.
 * - S_IDLE: A generic state where the board performs no action (necessary while, e.g., waits for a transmission to be completed).
 */
 typedef enum {
@@ -36,11 +41,9 @@ typedef enum {
 	S_UPDATE_AVG_CONSENSUS_STATE,
 	S_INIT_AND_SLEEP,
 	S_PACKET_TX,
-	S_PACKET_RECEIVED,
-	S_PACKET_SENT,
-	S_RX_PACKET_ERROR,
-	S_TX_PACKET_ERROR,
-	S_CALIBRATION_ERROR,
+	S_TDMA_NEW_FRAME,
+	S_TDMA_MY_SLOT,
+	S_FLOOD_RELAYED,
 	S_IDLE
 } state_t;
 
@@ -49,36 +52,39 @@ typedef enum {
 * - O_GLB_START_TASK: Send a message of type {@link message_t MSG_START_TASK}.
 * - O_GLB_SEND_STATE: Send a message of type {@link message_t MSG_CONSENSUS_STATE}.
 * - O_GIVE_BATON: Send a message of type {@link message_t MSG_BATON}.
+* - O_GLB_SEND_LINKS: Send a message of type {@link message_t MSG_LINKS}.
+* - O_FLOOD_RELAY: Relay the message of type {@link message_t MSG_RESTART} or {@link message_t MSG_START_TASK} which is being flooded (see app_routing.h) to the neighbors which are farther from its origin.
+* - O_GOSSIP_REQUEST: Send a message of type {@link message_t MSG_GOSSIP}, which requests an exchange of the randomized gossip from a random neighbor.
+* - O_GOSSIP_REPLY: Send a message of type {@link message_t MSG_GOSSIP}, which accepts (or refuses) the exchange requested by a neighbor.
+* - O_GLB_GOSSIP_STOP: Send a message of type {@link message_t MSG_GOSSIP}, which informs the neighbors that this board stops the randomized gossip.
 */
 typedef enum {
 	O_GLB_RESTART,
 	O_GLB_START_TASK,
 	O_GLB_SEND_STATE,
-	O_GIVE_BATON
+	O_GIVE_BATON,
+	O_GLB_SEND_LINKS,
+	O_FLOOD_RELAY,
+	O_GOSSIP_REQUEST,
+	O_GOSSIP_REPLY,
+	O_GLB_GOSSIP_STOP
 } tx_operation_t;
 
 /** The various (independent) tasks to be performed by the application.
 * - T_NONE: No specific task except from answering incoming requests & handling incoming messages.
 * - T_CONSENSUS: Contribute to the execution of distributed Average Consensus.
+* - T_DISCOVERY: Contribute to the discovery of the graph (see app_discovery.h).
+* - T_GOSSIP: Contribute to the execution of the randomized gossip, i.e., Average Consensus without the baton (see app_gossip.h).
+* - T_TRACKING: Contribute to the tracking of the average, i.e., the randomized gossip over the changing readings of the boards, until it is stopped (see app_gossip.h).
 */
 typedef enum {
 	T_NONE,
-	T_CONSENSUS
+	T_CONSENSUS,
+	T_DISCOVERY,
+	T_GOSSIP,
+	T_TRACKING
 } task_t;
 
-/** The various types of messages exchanged between the boards.
- * - MSG_RESTART: A message indicating that the system is restarting at the moment.
- * - MSG_START_TASK: A message indicating that the system is starting a new task at the moment.
- * - MSG_CONSENSUS_STATE: A message with another board's current state.
- * - MSG_BATON: A message with the baton.
- */
-typedef enum {
-	MSG_RESTART,
-	MSG_START_TASK,
-	MSG_CONSENSUS_STATE,
-	MSG_BATON
-} message_t;
-
 /// This constant at a specific index of some messages indicates that the distributed system is currently transitioning to sleep state.
 #define SEND_SYSTEM_TO_SLEEP -1
 
@@ -91,21 +97,78 @@ static volatile state_t state = S_INIT_AND_SLEEP;
 ///Indicates the current task of the board.
 static task_t current_task;
 
+///The number of transmissions of a global message (e.g., {@link tx_operation_t O_GLB_SEND_STATE}): a single broadcast on the shared channel, or one per possible destination.
+#define NUM_OF_GLOBAL_MSGS (USE_SHARED_CHANNEL ? 1 : num_of_boards)
+
+///True while the board follows a TDMA schedule instead of the baton: in TDMA mode, or during the discovery of the graph.
+#define FOLLOWS_SCHEDULE (USE_TDMA || current_task==T_DISCOVERY)
+
+///True while the board takes part in the exchanges of the randomized gossip: in the gossip, or while it tracks the average.
+#define GOSSIPS (current_task==T_GOSSIP || current_task==T_TRACKING)
+
 ///Determines the exact kind of transmission which will be performed when the board is in the {@link state_t S_PACKET_TX} state. It does not need initialization.
 static tx_operation_t tx_operation_to_achieve;
 
 ///Counts the number of pending messages for transmission, and is mainly used when the {@link state_t S_PACKET_TX} state has to repetitively send many messages. It does not need initialization.
 static int num_of_pending_msgs_for_tx;
 
+///True if the next baton released by this board carries its state, i.e., if the board sends its state for a new iteration. The next holder of the baton (and, on the shared channel, every neighbor, which overhears it) needs no separate {@link tx_operation_t O_GLB_SEND_STATE} message.
+static bool baton_carries_state;
+
 ///Indicates how many batons are required to pass from this board in order for the baton to complete a full cycle and return to the beginning (see the baton_path variable).
 static int batons_per_cycle;
 
-///Counts the number of boards whose current state compared to the previous one gives a value under the STOP_THRESHOLD. When this variable is equal to NUM_OF_BOARDS, the system can stop the execution of the algorithm and sleep.
+///The position of this board in the {@link baton_path} where it received the baton last (or where it starts the task), which determines the steps of the baton until it returns (see {@link steps_to_return()}). It is -1 if this board is not on the path.
+static int baton_position;
+
+///Counts the number of boards whose current state compared to the previous one gives a value under the STOP_THRESHOLD. When this variable is equal to num_of_boards, the system can stop the execution of the algorithm and sleep.
 static int8_t boards_completed_their_task;
 
 ///This variable becomes true when this board believes that the execution of average consensus can be terminated, according to its own current & previous state.
 static bool consensus_is_over;
 
+///In TDMA mode, becomes true when this board has broadcast the start message, so that it is relayed once.
+static bool start_relayed;
+
+///The type of the control message whose flood this board takes part in ({@link message_t MSG_RESTART} or {@link message_t MSG_START_TASK}), or -1 if none (see {@link USE_FLOODING}).
+static int8_t flood_type;
+
+///The origin of the flood, i.e., the board which sent the control message first. It is this board when it sends a control message without relaying a flood.
+static uint8_t flood_origin;
+
+///The neighbors of this board which are known to have received the flooded message: bit j is set if a copy of the message was received from board j. A copy sent by this board may be lost, hence it proves nothing.
+static uint32_t flood_informed;
+
+///Becomes true when the jitter before the relay of the flood ends, and the relay waits for the main loop.
+static bool flood_relay_due;
+
+///True while this board relays a flood, until it enters the {@link state_t S_FLOOD_RELAYED} state. Meanwhile, a received baton waits, since its states would be mixed with the states of the relay.
+static bool flood_relaying;
+
+///In TDMA mode, the number of consecutive frames for which the neighborhood of every board (including this one) has been below the STOP_THRESHOLD, as last received (see {@link app_codec#packet_t quiet_frames}).
+static uint8_t quiet_frames[MAX_NUM_OF_BOARDS];
+
+///Becomes true when the next exchange of the randomized gossip is due, and the exchange waits for the main loop.
+static bool gossip_due;
+
+///The neighbor which received the last request of this board in the randomized gossip.
+static int8_t gossip_partner;
+
+///The neighbor whose request of an exchange waits for the reply of this board (or -1). Another request which arrives meanwhile is dropped, and its sender gives up.
+static int8_t gossip_requester;
+
+///The state of the {@link gossip_requester}, as carried by its request.
+static float requester_state[NUM_OF_QUANTITIES];
+
+///The quiet hops of the {@link gossip_requester}, as carried by its request.
+static uint8_t requester_hops;
+
+///True after this board stopped the randomized gossip (or the tracking of the average) and informed its neighbors, until it wakes up for another task. While it sleeps, it answers the request of a neighbor which missed its GOSSIP_STOP with another one, since a stopped board never replies.
+static bool gossip_stop_sent;
+
+///Becomes true when the next sample of the sensor is due while the board tracks the average, and the sample waits for the conversion of the sensor and the main loop.
+static bool sample_due;
+
 // -----------------------------------------------------------------------------
 //                        Static Function Declaration
 // -----------------------------------------------------------------------------
@@ -120,21 +183,72 @@ static bool consensus_is_over;
  */
 static bool packet_transmission (RAIL_Handle_t rail_handle, volatile tx_operation_t oper);
 
+/** The function decides whether this board agrees for the algorithm to be
+ * terminated, after an update of its state: when every quantity of its state
+ * changed by at most the {@link STOP_THRESHOLD}. If {@link CONSENSUS_UPDATE} equals to
+ * {@link CONSENSUS_FINITE_TIME}, this is checked only after the exact average
+ * has been computed, at the next update (which does not change the state,
+ * unless messages were lost).
+ *
+ * @date 16/10/2026
+ * @param prev_state The state of this board before the update.
+ * @return True if the state of this board is final.
+ */
+static bool state_is_final(const float *prev_state);
+
+/** The function makes this board take part in the flood of a control message
+ * (see app_routing.h). When the message is received for the first time, the
+ * relay of the message is scheduled, unless no neighbor is farther from its
+ * origin. Every copy of the message marks its sender as informed, so that the
+ * message is not sent to it again.
+ *
+ * @date 16/10/2026
+ * @param packet The received restart or start message.
+ * @param first True if the message is received for the first time.
+ */
+static void join_flood(const packet_t *packet, bool first);
+
+/** The function decides whether this board has to send a control message to
+ * its neighbors when the baton reaches it, and ends its part in the flood of
+ * the message: a relay which has not been sent yet is cancelled, since the
+ * message is sent now instead.
+ *
+ * @date 16/10/2026
+ * @param type The type of the control message.
+ * @return True if every neighbor of this board is known to have received the
+ * flooded message, so that it does not have to be sent again (the baton is
+ * ignored by a sleeping board).
+ */
+static bool flood_reached_neighbors(message_t type);
+
+/** The function counts the steps of the baton from the {@link baton_position}
+ * of this board until the baton returns to it, i.e., until the next position
+ * of this board in the {@link baton_path}.
+ *
+ * @date 16/10/2026
+ * @return The steps of the baton until it returns to this board, or 0 if this
+ * board is not on the path.
+ */
+static int steps_to_return();
+
 /** The function handles the unexpected events which affect the normal sequence
  * of the states (e.g., timer alarms, interrupts, cli commands).
  *
  * @date 02/02/2023
  * @param rail_handle The RAIL instance to be used for TX - RX.
+ * @return True if any event was handled.
  */
-void handle_app_events(RAIL_Handle_t rail_handle);
+bool handle_app_events(RAIL_Handle_t rail_handle);
 
 /**
  * The function implements the state machine of this application.
  *
  * @date 02/02/2023
  * @param rail_handle The RAIL instance to be used for TX - RX.
+ * @return False if the current state waits for an event (e.g., the baton),
+ * true if it made progress.
  */
-void execute_app_state(RAIL_Handle_t rail_handle);
+bool execute_app_state(RAIL_Handle_t rail_handle);
 
 // -----------------------------------------------------------------------------
 //                          Function Implementation
@@ -143,31 +257,97 @@ void execute_app_state(RAIL_Handle_t rail_handle);
  * The 'main' function of this application, called infinitely.
  ******************************************************************************/
 void app_process_action(RAIL_Handle_t rail_handle){
-	handle_app_events(rail_handle);
-	execute_app_state(rail_handle);
+	bool handled = handle_app_events(rail_handle);
+	bool progress = execute_app_state(rail_handle);
+	allow_mcu_sleep(!handled && !progress); //Otherwise, the next pass may have work to do without an interrupt
 }
 
 /*******************************************************************************
   * Handles the unexpected events that affect the normal sequence of the states.
 *******************************************************************************/
-void handle_app_events(RAIL_Handle_t rail_handle){ //Handles 1 event per call. More than 1 may cause extreme edge cases that will crash the application.
-	if (packet_received) { //EVENT WITH PRIOR. 1 - RECEIVED A NEW PACKET - HANDLE IT IMMEDIATELY
-		packet_received = false;
-		push(state);
-		state = S_PACKET_RECEIVED;
-	} else if (packet_sent) { //EVENT WITH PRIOR. 2 - COMPLETED TX OF A PACKET - NOT NECESSARY TO BE IDLE ANYMORE
-		packet_sent = false;
-		state = S_PACKET_SENT;
-	} else if (rx_error) {  //EVENT WITH PRIOR. 3 - RECEIVED PACKET WITH ERRORS - FIND A WAY TO HANDLE THE SITUATION
-		rx_error = false;
-		state = S_RX_PACKET_ERROR;
-	} else if (tx_error) { //EVENT WITH PRIOR. 4 - TRANSMITTED PACKET WITH ERRORS - FIND A WAY TO HANDLE THE SITUATION
-		tx_error = false;
-		state = S_TX_PACKET_ERROR;
-	} else if (cal_error) { //EVENT WITH PRIOR. 5 - ERROR ON CALIBRATION OF THE BOARD - FIND A WAY TO HANDLE THE SITUATION
-		cal_error = false;
-		state = S_CALIBRATION_ERROR;
-	} else if(baton && boards_completed_their_task==SEND_SYSTEM_TO_SLEEP && baton_cntr%batons_per_cycle==0){ //EVENT WITH PRIOR. 6 - THIS IS THE LAST BATON RECEIVED BY THE CURRENT BOARD - TRANSMIT THE BATON AND GO TO SLEEP
+bool handle_app_events(RAIL_Handle_t rail_handle){
+	app_event_t event;
+	uint16_t overflows = event_overflows;
+	bool handled = false;
+	while(get_event(&event)){ //All the events of the interrupts are handled in the order they occurred, in a single pass
+		handled = true;
+		switch(event.type){
+		case E_PACKET_RECEIVED: //RECEIVED A NEW PACKET - HANDLE IT IMMEDIATELY (together with any other held one)
+			handle_received_packet(rail_handle);
+			break;
+		case E_PACKET_SENT: //COMPLETED TX OF A PACKET - NOT NECESSARY TO BE IDLE ANYMORE
+			account_transmission((RAIL_Time_t) event.data);
+			if(is_listening()) //A sleeping board which repeated its stop receives in listen windows again
+				start_low_power_listen(rail_handle);
+			else
+				start_receiving(rail_handle);
+			transmit_next_packet(rail_handle);
+			state = pop();
+			break;
+		case E_RX_ERROR: //RECEIVED PACKET WITH ERRORS (e.g., A COLLISION) - THE PACKET IS LOST, AS IF IT WAS NEVER RECEIVED, AND THE BOARD CONTINUES FROM ITS CURRENT STATE
+			app_log_warning("Radio RX Error occurred\nEvents: %llX\n", (unsigned long long)event.data);
+			break;
+		case E_TX_ERROR: //TRANSMITTED PACKET WITH ERRORS - FIND A WAY TO HANDLE THE SITUATION
+			app_log_error("Radio TX Error occurred\nEvents: %llX\n", (unsigned long long)event.data);
+			transmit_next_packet(rail_handle); //The message is lost, the next one is not
+			state = S_IDLE;
+			break;
+		case E_CAL_ERROR: //ERROR ON CALIBRATION OF THE BOARD - FIND A WAY TO HANDLE THE SITUATION
+			app_log_error("Radio Calibration Error occurred\nRAIL_Calibrate() result:%d\n", (int) event.data);
+			state = S_IDLE;
+			break;
+		case E_RESTART_TIMEOUT: //THE BATON WAS LOST - THE SYSTEM HAS TO RESTART
+			prepare_restart();
+			break;
+		case E_TDMA_FRAME: //Handled below, when the board is idle
+			tdma_frame = (int32_t) event.data;
+			tdma_frame_started = true;
+			break;
+		case E_TDMA_SLOT:
+			tdma_slot_started = true;
+			break;
+		case E_SENSOR_READY: //The result of the sensor is read by the state which waits for it
+			break;
+		case E_RADIO_WAKE: //THE BATON MAY RETURN TO THE NEIGHBORHOOD - RECEIVE AGAIN
+			start_receiving(rail_handle);
+			break;
+		case E_LISTEN_WINDOW: //A LISTEN WINDOW OF THE SLEEPING BOARD STARTED OR ENDED
+			handle_listen_window(rail_handle, (bool) event.data);
+			break;
+		case E_TX_RETRY: //THE ACK OF THE LAST MESSAGE DID NOT ARRIVE - RETRANSMIT IT
+			retransmit_packet(rail_handle);
+			break;
+		case E_ACK_SENT: //THIS BOARD SENT AN ACK - THE RADIO CAN TRANSMIT AGAIN
+			account_ack((RAIL_Time_t) event.data);
+			resume_deferred_packet(rail_handle);
+			break;
+		case E_FLOOD_RELAY: //Handled below, when the board does not hold the baton
+			flood_relay_due = flood_type>=0;
+			break;
+		case E_GOSSIP_TIMER: //Handled below, when the board is idle
+			gossip_due = GOSSIPS && gossip_timer_expired();
+			break;
+		case E_TRACKING_SAMPLE: //The sensor converts meanwhile, and its result is read below, when the board is idle
+			if(current_task==T_TRACKING){
+				start_temperature_measurement();
+				sample_due = true;
+			}
+			break;
+		}
+	}
+	if(event_overflows!=overflows)
+		app_log_warning("The event queue is full. %d events were lost.\n", event_overflows-overflows);
+	if(is_listening() && !is_asleep()){ //THE BOARD WOKE UP (by a message or the CLI) - RECEIVE CONTINUOUSLY
+		stop_low_power_listen(rail_handle);
+		handled = true;
+	}
+	if(gossip_stop_sent && !is_asleep() && !GOSSIPS) //The board woke up for another task
+		gossip_stop_sent = false;
+
+	//Handles 1 of the following events per call. More than 1 may cause extreme edge cases that will crash the application.
+	if(flood_relaying && !restart_command){ //The relay of a flood completes first (a restart re-initializes the board anyway)
+		return handled;
+	} else if(baton && boards_completed_their_task==SEND_SYSTEM_TO_SLEEP && baton_cntr%batons_per_cycle==0){ //EVENT WITH PRIOR. 1 - THIS IS THE LAST BATON RECEIVED BY THE CURRENT BOARD - TRANSMIT THE BATON AND GO TO SLEEP
 		clear(); //Clear any remaining states in the stack
 		temperature = MIN_TEMPERATURE - 1; //Initialize any remaining variables
 		current_task = T_NONE;
@@ -176,10 +356,11 @@ void handle_app_events(RAIL_Handle_t rail_handle){ //Handles 1 event per call. M
 		push(S_INIT_AND_SLEEP);
 		tx_operation_to_achieve = O_GIVE_BATON;
 		state = S_PACKET_TX;
+		keep_consensus_result();
 		app_log_info("\n\n=====================================================\n");
-		app_log_info("Estimated average temperature: %.2f degrees Celsius.\n", consensus_states[BOARD_ID]);
+		print_consensus_estimates();
 		app_log_info("=====================================================\n\n\n");
-	} else if(restart_command && baton){ //EVENT WITH PRIOR. 7 - THIS BOARD HAS TO RE-INITIALIZE SINCE THE WHOLE SYSTEM IS RESTARTING - RE-INITIALIZE IMMEDIATELY.
+	} else if(restart_command && baton){ //EVENT WITH PRIOR. 2 - THIS BOARD HAS TO RE-INITIALIZE SINCE THE WHOLE SYSTEM IS RESTARTING - RE-INITIALIZE IMMEDIATELY.
 		app_log_info("=========================================================\n");
 		app_log_info("Restarting...\n");
 		app_log_info("=========================================================\n");
@@ -187,87 +368,247 @@ void handle_app_events(RAIL_Handle_t rail_handle){ //Handles 1 event per call. M
 		int8_t hold_dst_of_baton = dst_of_baton;
 		int8_t hold_start_brd = starting_board;
 		int hold_restart_id = restart_id;
+		bool reached = flood_reached_neighbors(MSG_RESTART);
+		uint8_t hold_flood_origin = flood_origin;
 		initialize_app(rail_handle);
 		starting_board = hold_start_brd;
 		dst_of_baton = hold_dst_of_baton;
 		baton_cntr = 1;
 		baton = true;
 		restart_id = hold_restart_id;
+		flood_origin = hold_flood_origin;
 
-		num_of_pending_msgs_for_tx = NUM_OF_BOARDS;
+		num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
 		state = S_PACKET_TX;
-		tx_operation_to_achieve = O_GLB_RESTART;
+		tx_operation_to_achieve = reached ? O_GIVE_BATON : O_GLB_RESTART; //The neighbors received the flood of the restart already
 		push(S_RESTART_COMPLETED);
-	} else if(baton && (baton_cntr-1)%batons_per_cycle!=0){ //EVENT WITH PRIOR. 8 - NO ACTION SHOULD BE PERFORMED ON THIS BATON - BYPASS THE BATON BY RELEASING IT IMMEDIATELY.
+	} else if(baton && (baton_cntr-1)%batons_per_cycle!=0){ //EVENT WITH PRIOR. 3 - NO ACTION SHOULD BE PERFORMED ON THIS BATON - BYPASS THE BATON BY RELEASING IT IMMEDIATELY.
 			push(state);
 			tx_operation_to_achieve = O_GIVE_BATON;
 			state = S_PACKET_TX;
-	} else if(average_command && baton){ //EVENT WITH PRIOR. 9 - THE WHOLE SYSTEM IS STARTING THE EXECUTION OF THE DISTRIBUTED AVERAGE CONSENSUS ALGORITHM - START THE AVERAGE CONSENSUS ALGORITHM ON THE CURRENT BOARD.
+	} else if(average_command && baton && !USE_TDMA){ //EVENT WITH PRIOR. 4 - THE WHOLE SYSTEM IS STARTING THE EXECUTION OF THE DISTRIBUTED AVERAGE CONSENSUS ALGORITHM - START THE AVERAGE CONSENSUS ALGORITHM ON THE CURRENT BOARD.
 		app_log_info("Starting the execution of Distributed Average Consensus.\n");
+		start_temperature_measurement(); //The sensor converts while the start messages are sent
 		average_command = false;
-		num_of_pending_msgs_for_tx = NUM_OF_BOARDS;
+		num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
 		current_task = T_CONSENSUS;
 		state = S_PACKET_TX;
-		tx_operation_to_achieve = O_GLB_START_TASK;
+		tx_operation_to_achieve = flood_reached_neighbors(MSG_START_TASK) ? O_GIVE_BATON : O_GLB_START_TASK; //The neighbors received the flood of the start already
 		push(S_START_AVG_CONSENSUS);
-	}
+	} else if(USE_TDMA && state==S_IDLE && average_command){ //EVENT WITH PRIOR. 5 - THE WHOLE SYSTEM IS STARTING THE EXECUTION OF THE DISTRIBUTED AVERAGE CONSENSUS ALGORITHM IN TDMA MODE - JOIN THE SCHEDULE.
+		app_log_info("Starting the execution of Distributed Average Consensus (TDMA).\n");
+		start_temperature_measurement();
+		average_command = false;
+		current_task = T_CONSENSUS;
+		state = S_START_AVG_CONSENSUS;
+		if(starting_board==board_id){ //Start the schedule and announce it immediately. The other boards relay it in their slot of the setup frames.
+			baton = false;
+			start_tdma_now();
+			start_relayed = true;
+			num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+			state = S_PACKET_TX;
+			tx_operation_to_achieve = O_GLB_START_TASK;
+			push(S_START_AVG_CONSENSUS);
+		}
+	} else if(state==S_IDLE && discovery_command){ //EVENT WITH PRIOR. 6 - THE WHOLE SYSTEM IS DISCOVERING ITS GRAPH - JOIN THE SCHEDULE OF THE DISCOVERY.
+		app_log_info("Starting the discovery of the graph.\n");
+		discovery_command = false;
+		current_task = T_DISCOVERY;
+		if(starting_board==board_id){ //Start the schedule and announce it immediately. The other boards relay it with their beacons.
+			start_discovery();
+			start_tdma_now();
+			num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+			state = S_PACKET_TX;
+			tx_operation_to_achieve = O_GLB_START_TASK;
+			push(S_IDLE);
+		}
+	} else if(FOLLOWS_SCHEDULE && state==S_IDLE && tdma_frame_started){ //EVENT WITH PRIOR. 7 - A NEW FRAME OF THE TDMA SCHEDULE HAS STARTED - UPDATE THE STATE.
+		tdma_frame_started = false;
+		state = S_TDMA_NEW_FRAME;
+	} else if(FOLLOWS_SCHEDULE && state==S_IDLE && tdma_slot_started){ //EVENT WITH PRIOR. 8 - THE TDMA SLOT OF THIS BOARD HAS STARTED - BROADCAST.
+		tdma_slot_started = false;
+		state = S_TDMA_MY_SLOT;
+	} else if(flood_relay_due && !flood_relaying && !baton && state!=S_PACKET_TX){ //EVENT WITH PRIOR. 9 - THE JITTER BEFORE THE RELAY OF A FLOOD ENDED - RELAY THE CONTROL MESSAGE, AND CONTINUE WAITING.
+		flood_relay_due = false;
+		flood_relaying = true;
+		push(state);
+		push(S_FLOOD_RELAYED);
+		num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+		state = S_PACKET_TX;
+		tx_operation_to_achieve = O_FLOOD_RELAY;
+	} else if((gossip_command || tracking_command) && state==S_IDLE && isempty()){ //EVENT WITH PRIOR. 10 - THE WHOLE SYSTEM IS STARTING THE RANDOMIZED GOSSIP (OR THE TRACKING OF THE AVERAGE) - ANNOUNCE IT TO THE NEIGHBORS, AND JOIN IT.
+		app_log_info(tracking_command ? "Starting the tracking of the average.\n" : "Starting the execution of Randomized Gossip.\n");
+		start_temperature_measurement(); //The sensor converts while the start messages are sent
+		current_task = tracking_command ? T_TRACKING : T_GOSSIP;
+		gossip_command = false;
+		tracking_command = false;
+		num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+		state = S_PACKET_TX;
+		tx_operation_to_achieve = O_GLB_START_TASK; //Every board announces the start once, when it joins
+		push(S_START_AVG_CONSENSUS);
+	} else if((GOSSIPS || gossip_stop_sent) && gossip_requester>=0 && state==S_IDLE && isempty()){ //EVENT WITH PRIOR. 11 - A NEIGHBOR REQUESTED AN EXCHANGE OF THE RANDOMIZED GOSSIP - REPLY TO IT (OR REPEAT THE STOP OF THIS BOARD, IF IT MISSED IT).
+		push(S_IDLE);
+		state = S_PACKET_TX;
+		tx_operation_to_achieve = O_GOSSIP_REPLY;
+	} else if(GOSSIPS && gossip_due && state==S_IDLE && isempty()){ //EVENT WITH PRIOR. 12 - THE NEXT EXCHANGE OF THE RANDOMIZED GOSSIP IS DUE - REQUEST IT FROM A RANDOM NEIGHBOR, OR STOP.
+		gossip_due = false;
+		if(gossip_is_over() || (gossip_partner = request_gossip())<0){
+			state = S_INIT_AND_SLEEP;
+			if(gossip_is_quiet()){ //After informing the neighbors that the algorithm is terminated, sleep
+				gossip_stop_sent = true;
+				push(S_INIT_AND_SLEEP);
+				num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+				state = S_PACKET_TX;
+				tx_operation_to_achieve = O_GLB_GOSSIP_STOP;
+			}
+			keep_consensus_result();
+			app_log_info("\n\n=====================================================\n");
+			print_consensus_estimates();
+			app_log_info("=====================================================\n\n\n");
+		}
+		else {
+			push(S_IDLE);
+			state = S_PACKET_TX;
+			tx_operation_to_achieve = O_GOSSIP_REQUEST;
+		}
+	} else if(current_task==T_TRACKING && sample_due && temperature_is_ready() && state==S_IDLE && isempty()){ //EVENT WITH PRIOR. 13 - THE NEXT SAMPLE OF THE SENSOR HAS BEEN CONVERTED WHILE TRACKING THE AVERAGE - ADD THE CHANGE OF THE READINGS TO THE STATE.
+		sample_due = false;
+		measure_temperature();
+		track_measurements();
+	} else //No event of the above
+		return handled;
+	return true;
 }
 
 /*******************************************************************************
  * The state machine of this application.
  ******************************************************************************/
-void execute_app_state(RAIL_Handle_t rail_handle){
+bool execute_app_state(RAIL_Handle_t rail_handle){
+	bool progress = true;
 	switch (state) {
 	case S_RESTART_COMPLETED: //When the board enters this state, it has completed a re-initialization and is going to start the average consensus task from the beginning.
-		if(starting_board==BOARD_ID)
+		if(starting_board==board_id)
 			average_command = true;
 		state = S_IDLE;
 		break;
 	case S_START_AVG_CONSENSUS: //The first state of the average consensus task, where the algorithm is initialized.
-		if(baton){
+		if((baton || USE_TDMA || GOSSIPS) && temperature_is_ready()){ //Otherwise, the sensor is still converting, and its result is read in a later pass
 			measure_temperature();
 			initialize_consensus_setup();
-			state = S_SEND_AVG_CONSENSUS_MSGS;
+			state = USE_TDMA || GOSSIPS ? S_IDLE : S_SEND_AVG_CONSENSUS_MSGS; //In TDMA mode, the states are sent in the slots of this board (and in the gossip, in its exchanges)
+			if(GOSSIPS)
+				start_gossip(rail_handle, current_task==T_TRACKING);
+			for(int j=0;j<num_of_boards && USE_TDMA;j++){ //Until the state of a neighbor is received, the state of this board is used instead
+				quiet_frames[j] = 0;
+				if(j!=board_id)
+					memcpy(consensus_states[j], consensus_states[board_id], sizeof(consensus_states[j]));
+			}
 			app_log_info("Initialization complete!\n");
 		}
+		else
+			progress = false;
 		break;
 	case S_SEND_AVG_CONSENSUS_MSGS:{ //The board enters this state during the average consensus task, and sends its state to all the commuting boards (according to the {@link ../config/app_config.h#graph graph}).
 		if(baton){
-				app_log_info("=========================================================\n");
-			app_log_info("Iteration %d:\n", consensus_iters+1);
-			app_log_info("   - Now sending my state to my neighbors.\n");
+			trace(TRACE_ITERATION_STARTED, consensus_iters+1, 0, 0);
 			push(S_UPDATE_AVG_CONSENSUS_STATE);
-			num_of_pending_msgs_for_tx = NUM_OF_BOARDS;
+			baton_carries_state = true;
+			num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
 			state = S_PACKET_TX;
-			tx_operation_to_achieve = O_GLB_SEND_STATE;
+			tx_operation_to_achieve = USE_SHARED_CHANNEL ? O_GIVE_BATON : O_GLB_SEND_STATE; //On the shared channel, every neighbor overhears the state with the baton
 		}
-
+		else
+			progress = false;
 		break;}
 	case S_UPDATE_AVG_CONSENSUS_STATE:{ //The board enters this state during the average consensus task, and updates its state.
 		if(baton){
-			float prev_state = consensus_states[BOARD_ID];
+			float prev_state[NUM_OF_QUANTITIES];
+			memcpy(prev_state, consensus_states[board_id], sizeof(prev_state));
 			update_consensus_state();
-			app_log_info("   - Now updating my state, to %f.\n", consensus_states[BOARD_ID]);
+			trace(TRACE_STATE_UPDATED, 0, 0, consensus_states[board_id][QUANTITY_TEMPERATURE]);
 			push(S_SEND_AVG_CONSENSUS_MSGS);
 			state = S_PACKET_TX;
 			tx_operation_to_achieve = O_GIVE_BATON;
-			if(fabs(prev_state-consensus_states[BOARD_ID])<=STOP_THRESHOLD && !consensus_is_over){
-				app_log_info("     This board has reached to a value below the threshold, and it agrees for the algorithm to be terminated.\n");
+			bool below = state_is_final(prev_state);
+			if(below && !consensus_is_over){
+				trace(TRACE_BELOW_THRESHOLD, 0, 0, 0);
 				consensus_is_over = true;
 				boards_completed_their_task++;
 			}
-			else if(fabs(prev_state-consensus_states[BOARD_ID])>STOP_THRESHOLD && consensus_is_over && boards_completed_their_task!=SEND_SYSTEM_TO_SLEEP){
-				app_log_info("     This board is no longer below the threshold, and it does NOT agree for the algorithm to be terminated.\n");
+			else if(!below && consensus_is_over && boards_completed_their_task!=SEND_SYSTEM_TO_SLEEP){
+				trace(TRACE_ABOVE_THRESHOLD, 0, 0, 0);
 				consensus_is_over = false;
 				boards_completed_their_task--;
 			}
 		}
+		else
+			progress = false;
+		break;}
+	case S_TDMA_NEW_FRAME:{ //A new frame of the TDMA schedule has started, and the board updates its state with the states received during the previous frame.
+		state = S_IDLE;
+		if(current_task==T_DISCOVERY && tdma_frame>=DISCOVERY_FRAMES){ //The links of all boards have been exchanged
+			finish_discovery();
+			state = S_INIT_AND_SLEEP;
+			break;
+		}
+		if(current_task!=T_CONSENSUS || tdma_frame<=0 || consensus_is_over) //The initial states are broadcast in frame 0, hence the first update takes place at the start of frame 1
+			break;
+		float prev_state[NUM_OF_QUANTITIES];
+		memcpy(prev_state, consensus_states[board_id], sizeof(prev_state));
+		update_consensus_state();
+		uint8_t quiet = tdma_diameter; //A board is quiet for k frames if all boards in a distance up to k-1 have been below the threshold
+		for(int j=0;j<num_of_boards;j++)
+			if(j!=board_id && graph[board_id][j] && quiet_frames[j]<quiet)
+				quiet = quiet_frames[j];
+		quiet_frames[board_id] = state_is_final(prev_state) ? quiet+1 : 0;
+		trace(TRACE_FRAME_UPDATE, consensus_iters, quiet_frames[board_id], consensus_states[board_id][QUANTITY_TEMPERATURE]);
+		if(quiet_frames[board_id]>tdma_diameter || consensus_iters>=TDMA_MAX_FRAMES){
+			trace(TRACE_TERMINATED, 0, 0, 0);
+			consensus_is_over = true;
+		}
 		break;}
+	case S_TDMA_MY_SLOT: //The TDMA slot of this board has started, and the board broadcasts the start message (during the setup frames) or its state.
+		state = S_IDLE;
+		if(current_task==T_NONE || !tdma_slot_is_open()) //It is too late to transmit without interfering with the next slot
+			break;
+		if(current_task==T_DISCOVERY){ //A beacon in every frame until the links are measured (which also carries the start of the discovery), then the links of a board
+			push(S_IDLE);
+			num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+			state = S_PACKET_TX;
+			tx_operation_to_achieve = tdma_frame<DISCOVERY_BEACONS ? O_GLB_START_TASK : O_GLB_SEND_LINKS;
+			break;
+		}
+		if(tdma_frame<0){ //A setup frame, where the start message is carried one hop further
+			if(!start_relayed){
+				start_relayed = true;
+				push(S_IDLE);
+				num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+				state = S_PACKET_TX;
+				tx_operation_to_achieve = O_GLB_START_TASK;
+			}
+			break;
+		}
+		if(consensus_is_over)
+			quiet_frames[board_id] = TDMA_DONE;
+		push(consensus_is_over ? S_INIT_AND_SLEEP : S_IDLE); //After informing the neighbors that the algorithm is terminated, sleep
+		num_of_pending_msgs_for_tx = NUM_OF_GLOBAL_MSGS;
+		state = S_PACKET_TX;
+		tx_operation_to_achieve = O_GLB_SEND_STATE;
+		break;
 	case S_INIT_AND_SLEEP: //The last state of the board before it sleeps, where it initializes itself.
+		if(USE_TDMA && current_task==T_CONSENSUS){ //In TDMA mode, the result is printed after the last transmission, in order not to delay it
+			keep_consensus_result();
+			app_log_info("\n\n=====================================================\n");
+			print_consensus_estimates();
+			app_log_info("=====================================================\n\n\n");
+		}
+		reset_restart_timeout(); //The next run starts with the wake-up of the boards
 		initialize_app(rail_handle);
 		app_log_info("Now going to sleep...\n");
 		state = S_IDLE;
 		sleep();
+		start_low_power_listen(rail_handle); //Until a neighbor starts the next task, the radio only receives in short windows (if enabled)
+		dump_trace(); //The board is idle, hence the console is no longer needed for the iterations
 		break;
 	case S_PACKET_TX:{ //A generic state where the board transmits a message (whose exact type depends on the {@link tx_operation_to_achieve} variable.
 		bool msg_sent = packet_transmission(rail_handle, tx_operation_to_achieve); //this method actually builds & transmits the packet
@@ -276,18 +617,31 @@ void execute_app_state(RAIL_Handle_t rail_handle){
 		case O_GLB_START_TASK: //After starting a task or sending state messages, release baton immediately so that the rest of the neighbors do the same job too.
 		case O_GLB_RESTART:
 		case O_GLB_SEND_STATE:
+		case O_GLB_SEND_LINKS:
+		case O_FLOOD_RELAY:
+		case O_GLB_GOSSIP_STOP:
+			if(msg_sent && wake_train_continues()){ //Repeat the start (or restart) message, until it falls in a listen window of every sleeping neighbor
+				push(S_PACKET_TX);
+				break;
+			}
 			num_of_pending_msgs_for_tx--;
+			if((FOLLOWS_SCHEDULE || GOSSIPS || tx_operation_to_achieve==O_FLOOD_RELAY) && num_of_pending_msgs_for_tx==0) //There is no baton to release, the next transmission takes place at the next slot or exchange (or the relay is over)
+				break;
 			push(S_PACKET_TX);
 			if(num_of_pending_msgs_for_tx==0)
 				tx_operation_to_achieve = O_GIVE_BATON;
 			break;
 		case O_GIVE_BATON:{
 			baton=false;
-			if(starting_board==BOARD_ID)
-				RAIL_SetMultiTimer(&tmr0, RESTART_TIMEOUT_MILISECS*1000, RAIL_TIME_DELAY, &enable_alarm, NULL);
-			app_log_info("                              Released BATON %d! %d boards have reached to a result under the threshold.\n", baton_cntr, boards_completed_their_task<0?NUM_OF_BOARDS:boards_completed_their_task);
+			baton_carries_state = false;
+			if(starting_board==board_id && baton_position>=0) //A board which is not on the path never gets the baton back
+				arm_restart_timer(steps_to_return());
+			trace(TRACE_BATON_RELEASED, baton_cntr, boards_completed_their_task<0?num_of_boards:boards_completed_their_task, 0);
 			boards_completed_their_task = 0;
 			break;}
+		case O_GOSSIP_REQUEST: //The reply is awaited in the idle state
+		case O_GOSSIP_REPLY:
+			break;
 		}
 
 		if(msg_sent) //if a message was actually transmitted, wait until transmission is completed
@@ -295,91 +649,152 @@ void execute_app_state(RAIL_Handle_t rail_handle){
 		else //no transmission is being executed, continue immediately to the next state
 			state = pop();
 		break;}
-	case S_PACKET_RECEIVED: //A generic state to handle the received packets
-		handle_received_packet (rail_handle);
-		state = pop();
-		break;
-	case S_PACKET_SENT: //A generic state to handle the board after a transmission has been completed
-		start_receiving(rail_handle);
+	case S_FLOOD_RELAYED: //The board has relayed a flooded control message, and returns to the state where it was waiting.
+		flood_relaying = false;
 		state = pop();
 		break;
-	case S_RX_PACKET_ERROR:  //A generic state to handle cases of an error to the reception of a packet.
-		app_log_error("Radio RX Error occurred\nEvents: %llX\n", error_code);
-		state = S_IDLE;
-		break;
-	case S_TX_PACKET_ERROR:  //A generic state to handle cases of an error to the transmission of a packet.
-		app_log_error("Radio TX Error occurred\nEvents: %llX\n", error_code);
-		state = S_IDLE;
-		break;
-	case S_CALIBRATION_ERROR: //A generic state to handle cases of an error during the calibration of this board.
-		app_log_error("Radio Calibration Error occurred\nEvents: %llX\nRAIL_Calibrate() result:%d\n", error_code, calibration_status);
-		state = S_IDLE;
-		break;
 	case S_IDLE: //A generic state where the board performs no action (necessary while, e.g., waits for a transmission to be completed).
+		progress = false;
 		break;
 	default:     //Unexpected state, should never reach here
 		app_log_error("Unexpected state occurred: %d\n", state);
 		state = S_IDLE;
 		break;
 	}
+	return progress;
 }
 
 /*******************************************************************************
  * Handles a received RX message by performing the necessary actions.
  ******************************************************************************/
- void handle_rx_packet_payload(const uint8_t * const rx_buffer){
-	switch(rx_buffer[MSGIDX_TYPE]){
+ void handle_rx_packet_payload(const packet_t *packet){
+	bool discovery = packet->type==MSG_LINKS || (packet->type==MSG_START_TASK && packet->task==T_DISCOVERY);
+	if(packet->src>=num_of_boards || (packet->dst==BROADCAST_ADDRESS && !directed_graph[board_id][packet->src] && !discovery))
+		return; //a message from an unknown board, or a broadcast from a board which this board does not receive (according to the graph and its one-way links, unless the graph is being discovered), is ignored
+
+	switch(packet->type){
 	case MSG_RESTART:{ //A message indicating that the system is restarting at the moment.
-		if(rx_buffer[MSGIDX_RESTART_ID]>restart_id){
+		if(packet->restart_id>restart_id){
 			wake_up();
 			restart_command = true;
-			restart_id = rx_buffer[MSGIDX_RESTART_ID];
+			restart_id = packet->restart_id;
+			join_flood(packet, true);
 		}
+		else if(packet->restart_id==restart_id)
+			join_flood(packet, false);
 		break;}
 	case MSG_START_TASK:{ //A message indicating that the system is starting a new task at the moment.
 		wake_up();
-		if(rx_buffer[MSGIDX_TASK]!=current_task && rx_buffer[MSGIDX_TASK]==T_CONSENSUS)
+		if(packet->task==T_DISCOVERY){ //A beacon of the discovery, which also starts the discovery on this board
+			if(current_task==T_DISCOVERY)
+				record_beacon(packet->src, tdma_frame, rx_packet_rssi);
+			else if(current_task==T_NONE && !discovery_command && packet->tdma){
+				discovery_command = true;
+				start_discovery();
+				synchronize_tdma(packet, rx_packet_time);
+			}
+		}
+		else if(packet->task==T_GOSSIP || packet->task==T_TRACKING){ //Every board joins the gossip (or the tracking) once, and announces it to its own neighbors
+			if(current_task==T_NONE && !average_command && !gossip_command && !tracking_command){
+				gossip_command = packet->task==T_GOSSIP;
+				tracking_command = packet->task==T_TRACKING;
+			}
+		}
+		else if(packet->task!=current_task && packet->task==T_CONSENSUS){
+			if(!USE_TDMA && baton_position<0) //This board is not on the baton path, hence it cannot take part in the task of the baton
+				break;
+			join_flood(packet, !average_command);
 			average_command = true;
+			start_temperature_measurement(); //The result will be ready when this board starts the task
+			if(USE_TDMA && packet->tdma)
+				synchronize_tdma(packet, rx_packet_time);
+		}
 		break;}
 	case MSG_CONSENSUS_STATE:{ //A message with another board's current state.
-		if(app_is_ok_to_sleep()) //if the board is sleeping, do nothing
+		if(is_asleep()) //if the board is sleeping, do nothing
 			break;
-		uint8_t buffer[4] = { rx_buffer[3], rx_buffer[4], rx_buffer[5], rx_buffer[6] };
-		float num = *((float*) buffer);
-		consensus_states[rx_buffer[MSGIDX_SRC_BOARD]] = num;
+		read_consensus_state(packet);
+		if(USE_TDMA && packet->tdma){
+			quiet_frames[packet->src] = packet->quiet_frames;
+			if(packet->quiet_frames==TDMA_DONE && current_task==T_CONSENSUS) //A neighbor has terminated the algorithm
+				consensus_is_over = true;
+		}
 		break;}
 	case MSG_BATON:{  //A message with the baton.
-		if(app_is_ok_to_sleep()) //if the board is sleeping, do nothing
+		if(is_asleep()) //if the board is sleeping, do nothing
 			break;
 		dst_of_baton = -1;
-		if(baton_path[LENGTH_OF_BATON_PATH-1]==rx_buffer[MSGIDX_SRC_BOARD] && baton_path[0]==BOARD_ID)
+		int position = -1;
+		if(baton_path[length_of_baton_path-1]==packet->src && baton_path[0]==board_id){
 			dst_of_baton = baton_path[1];
-		else if(baton_path[LENGTH_OF_BATON_PATH-2]==rx_buffer[MSGIDX_SRC_BOARD] && baton_path[LENGTH_OF_BATON_PATH-1]==BOARD_ID)
+			position = 0;
+		}
+		else if(baton_path[length_of_baton_path-2]==packet->src && baton_path[length_of_baton_path-1]==board_id){
 			dst_of_baton = baton_path[0];
+			position = length_of_baton_path-1;
+		}
 		else {
-			for(int i=1;i<LENGTH_OF_BATON_PATH-1;i++){
-				if(baton_path[i]==BOARD_ID && baton_path[i-1]==rx_buffer[MSGIDX_SRC_BOARD]){
+			for(int i=1;i<length_of_baton_path-1;i++){
+				if(baton_path[i]==board_id && baton_path[i-1]==packet->src){
 					dst_of_baton = baton_path[i+1];
+					position = i;
 					break;
 				}
 			}
 		}
 		if(dst_of_baton<0) //Shouldn't have received the baton from this board
 			break;
+		if(packet->has_state)
+			read_consensus_state(packet);
 
-		if(starting_board==BOARD_ID)
-			RAIL_CancelMultiTimer(&tmr0);
+		if(starting_board==board_id) //The baton returned, after the steps from the position where this board released it
+			baton_returned((position-baton_position+length_of_baton_path-1)%length_of_baton_path+1);
+		baton_position = position;
 		baton=true;
 		baton_cntr++;
 
-		boards_completed_their_task = rx_buffer[MSGIDX_BOARDS_OVER];
-		if(boards_completed_their_task>=NUM_OF_BOARDS && starting_board==BOARD_ID && (baton_cntr-1)%batons_per_cycle==0) //marks that the next is the last cycle of the baton, and the boards can sleep when they are not going to receive the baton again
+		boards_completed_their_task = packet->boards_over;
+		if(boards_completed_their_task>=num_of_boards && starting_board==board_id && (baton_cntr-1)%batons_per_cycle==0) //marks that the next is the last cycle of the baton, and the boards can sleep when they are not going to receive the baton again
 			boards_completed_their_task = SEND_SYSTEM_TO_SLEEP; //the boards can now sleep
-		app_log_info("                              Received BATON %d! %d boards have reached to a result under the threshold.\n", baton_cntr, boards_completed_their_task<0?NUM_OF_BOARDS:boards_completed_their_task);
+		trace(TRACE_BATON_RECEIVED, baton_cntr, boards_completed_their_task<0?num_of_boards:boards_completed_their_task, 0);
+		break;}
+	case MSG_LINKS:{ //A message with the links which a board measured during the discovery of the graph.
+		if(current_task==T_DISCOVERY)
+			record_links(packet->owner, packet->links, packet->audible);
+		break;}
+	case MSG_ACK: //ACKs are handled by the link layer (see app_network.c), and never reach the application.
+		break;
+	case MSG_GOSSIP:{ //A message of an exchange of the randomized gossip.
+		if(is_asleep() && gossip_stop_sent && packet->gossip==GOSSIP_REQUEST && gossip_requester<0){ //A neighbor which missed the stop of this board
+			gossip_requester = packet->src;
+			break;
+		}
+		if(is_asleep() || !GOSSIPS)
+			break;
+		if(packet->gossip==GOSSIP_REQUEST && gossip_requester<0){
+			gossip_requester = packet->src;
+			memcpy(requester_state, packet->state, sizeof(requester_state));
+			requester_hops = packet->quiet_frames;
+		}
+		else if(packet->gossip==GOSSIP_REPLY)
+			gossip_replied(packet->src, packet->state, packet->quiet_frames);
+		else if(packet->gossip==GOSSIP_BUSY)
+			gossip_refused(packet->src);
+		else if(packet->gossip==GOSSIP_STOP)
+			gossip_stopped(packet->src);
 		break;}
 	}
 }
 
+/*******************************************************************************
+ * Handles a message which was overheard (i.e., transmitted for another board).
+ ******************************************************************************/
+void handle_overheard_packet(RAIL_Handle_t rail_handle, const packet_t *packet){
+	if(packet->type==MSG_BATON && packet->has_state && packet->src<num_of_boards && directed_graph[board_id][packet->src] && !is_asleep())
+		read_consensus_state(packet); //the state of a neighbor (or of a board received over a one-way link), as if it was broadcast
+	if(packet->type==MSG_BATON && !USE_TDMA && current_task==T_CONSENSUS && !baton && !is_asleep() && rx_packet_time!=0)
+		plan_radio_sleep(rail_handle, packet->src, packet->dst, rx_packet_time); //the baton moves away from this board
+}
 
 /*******************************************************************************
  * Transmits a packet to another board.
@@ -389,49 +804,98 @@ bool packet_transmission (RAIL_Handle_t rail_handle, volatile tx_operation_t ope
 
 	switch (oper) {
 	case O_GLB_RESTART:{ //Send a message of type MSG_RESTART.
-		int send_addr = NUM_OF_BOARDS - num_of_pending_msgs_for_tx;
-		tx_packet[MSGIDX_TYPE]=MSG_RESTART;
-		tx_packet[MSGIDX_SRC_BOARD]=BOARD_ID;
-		tx_packet[MSGIDX_DST_BOARD] = send_addr;
-		tx_packet[MSGIDX_RESTART_ID] = restart_id;
-		if(send_addr!=BOARD_ID && graph[BOARD_ID][send_addr]){
-			send_packet(rail_handle, tx_packet[MSGIDX_DST_BOARD]);
+		int send_addr = USE_SHARED_CHANNEL ? BROADCAST_ADDRESS : num_of_boards - num_of_pending_msgs_for_tx;
+		tx_packet = (packet_t){ .type = MSG_RESTART, .src = board_id, .dst = send_addr, .restart_id = restart_id, .origin = flood_origin };
+		if(send_addr==BROADCAST_ADDRESS || (send_addr!=board_id && graph[board_id][send_addr])){
+			begin_wake_train(send_addr);
+			send_packet(rail_handle, tx_packet.dst);
 			ret = true;
 		}
 		break;}
 	case O_GLB_START_TASK:{ //Send a message of type MSG_START_TASK.
-		int send_addr = NUM_OF_BOARDS - num_of_pending_msgs_for_tx;
-		tx_packet[MSGIDX_TYPE]=MSG_START_TASK;
-		tx_packet[MSGIDX_SRC_BOARD]=BOARD_ID;
-		tx_packet[MSGIDX_DST_BOARD] = send_addr;
-		tx_packet[MSGIDX_TASK] = current_task;
-		if(send_addr!=BOARD_ID && graph[BOARD_ID][send_addr]){
-			send_packet(rail_handle, tx_packet[MSGIDX_DST_BOARD]);
+		int send_addr = USE_SHARED_CHANNEL ? BROADCAST_ADDRESS : num_of_boards - num_of_pending_msgs_for_tx;
+		tx_packet = (packet_t){ .type = MSG_START_TASK, .src = board_id, .dst = send_addr, .task = current_task, .origin = flood_origin };
+		if(FOLLOWS_SCHEDULE) //the receivers join the schedule
+			write_tdma_timestamps(&tx_packet);
+		if(send_addr==BROADCAST_ADDRESS || (send_addr!=board_id && graph[board_id][send_addr])){
+			begin_wake_train(send_addr);
+			send_packet(rail_handle, tx_packet.dst);
 			ret = true;
 		}
 		break;}
 	case O_GLB_SEND_STATE:{ ////Send a message of type MSG_CONSENSUS_STATE.
-		int send_addr = NUM_OF_BOARDS - num_of_pending_msgs_for_tx;
-		tx_packet[MSGIDX_TYPE] = MSG_CONSENSUS_STATE;
-		tx_packet[MSGIDX_SRC_BOARD] = BOARD_ID;
-		tx_packet[MSGIDX_DST_BOARD] = send_addr;
-
-		uint8_t *conv = (uint8_t*) &consensus_states[BOARD_ID]; //convert the 4-byte float to a uint8_t array of length 4.
-		tx_packet[3] = conv[0];
-		tx_packet[4] = conv[1];
-		tx_packet[5] = conv[2];
-		tx_packet[6] = conv[3];
-		if(send_addr!=BOARD_ID && graph[BOARD_ID][send_addr]){
-			send_packet(rail_handle, tx_packet[MSGIDX_DST_BOARD]);
+		int send_addr = USE_SHARED_CHANNEL ? BROADCAST_ADDRESS : num_of_boards - num_of_pending_msgs_for_tx;
+		tx_packet = (packet_t){ .type = MSG_CONSENSUS_STATE, .src = board_id, .dst = send_addr };
+		write_consensus_state(&tx_packet);
+		if(USE_TDMA){
+			tx_packet.tdma = true;
+			tx_packet.quiet_frames = quiet_frames[board_id];
+		}
+		if(send_addr==BROADCAST_ADDRESS || (sends_state_to(send_addr) && !(baton_carries_state && send_addr==dst_of_baton))){ //the next holder of the baton receives the state with it
+			send_packet(rail_handle, tx_packet.dst);
 			ret = true;
 		}
 		break;}
 	case O_GIVE_BATON:{  //Release the baton.
-		tx_packet[MSGIDX_TYPE]=MSG_BATON;
-		tx_packet[MSGIDX_SRC_BOARD]=BOARD_ID;
-		tx_packet[MSGIDX_DST_BOARD]= dst_of_baton;
-		tx_packet[MSGIDX_BOARDS_OVER] = boards_completed_their_task;
-		send_packet(rail_handle, tx_packet[MSGIDX_DST_BOARD]);
+		tx_packet = (packet_t){ .type = MSG_BATON, .src = board_id, .dst = dst_of_baton, .boards_over = boards_completed_their_task,
+			.has_state = baton_carries_state };
+		if(baton_carries_state)
+			write_consensus_state(&tx_packet);
+		send_packet(rail_handle, tx_packet.dst);
+		ret = true;
+		break;}
+	case O_FLOOD_RELAY:{ //Relay the flooded message of type MSG_RESTART or MSG_START_TASK.
+		int send_addr = USE_SHARED_CHANNEL ? BROADCAST_ADDRESS : num_of_boards - num_of_pending_msgs_for_tx;
+		tx_packet = (packet_t){ .type = (message_t) flood_type, .src = board_id, .dst = send_addr, .restart_id = restart_id, .task = T_CONSENSUS, .origin = flood_origin };
+		bool needed = false; //only to the neighbors farther from the origin, which have not received a copy (the others are reached by boards closer to the origin)
+		for(int j=0;j<num_of_boards;j++)
+			if((send_addr==BROADCAST_ADDRESS || send_addr==j) && is_downstream(flood_origin, j) && !((flood_informed >> j) & 1))
+				needed = true;
+		if(needed){
+			begin_wake_train(send_addr);
+			send_packet(rail_handle, tx_packet.dst);
+			ret = true;
+		}
+		break;}
+	case O_GOSSIP_REQUEST:{ //Send a message of type MSG_GOSSIP, which requests an exchange from the selected neighbor.
+		tx_packet = (packet_t){ .type = MSG_GOSSIP, .src = board_id, .dst = gossip_partner, .gossip = GOSSIP_REQUEST, .quiet_frames = gossip_quiet_hops() };
+		memcpy(tx_packet.state, consensus_states[board_id], sizeof(tx_packet.state));
+		send_packet(rail_handle, tx_packet.dst);
+		ret = true;
+		break;}
+	case O_GOSSIP_REPLY:{ //Send a message of type MSG_GOSSIP, which accepts the exchange (unless this board waits for the reply to its own request).
+		if(!GOSSIPS){ //This board has stopped, hence it repeats its stop to the requester, which stops too
+			tx_packet = (packet_t){ .type = MSG_GOSSIP, .src = board_id, .dst = gossip_requester, .gossip = GOSSIP_STOP, .quiet_frames = GOSSIP_DONE };
+			memcpy(tx_packet.state, consensus_states[board_id], sizeof(tx_packet.state));
+			gossip_requester = -1;
+			send_packet(rail_handle, tx_packet.dst);
+			ret = true;
+			break;
+		}
+		bool busy = gossip_awaits_reply();
+		tx_packet = (packet_t){ .type = MSG_GOSSIP, .src = board_id, .dst = gossip_requester, .gossip = busy ? GOSSIP_BUSY : GOSSIP_REPLY };
+		if(busy)
+			memcpy(tx_packet.state, consensus_states[board_id], sizeof(tx_packet.state));
+		else
+			answer_gossip(gossip_requester, requester_state, requester_hops, tx_packet.state);
+		tx_packet.quiet_frames = gossip_quiet_hops(); //after the averaging
+		gossip_requester = -1;
+		send_packet(rail_handle, tx_packet.dst);
+		ret = true;
+		break;}
+	case O_GLB_GOSSIP_STOP:{ //Send a message of type MSG_GOSSIP, which informs the neighbors that this board stops.
+		int send_addr = USE_SHARED_CHANNEL ? BROADCAST_ADDRESS : num_of_boards - num_of_pending_msgs_for_tx;
+		tx_packet = (packet_t){ .type = MSG_GOSSIP, .src = board_id, .dst = send_addr, .gossip = GOSSIP_STOP, .quiet_frames = GOSSIP_DONE };
+		memcpy(tx_packet.state, consensus_states[board_id], sizeof(tx_packet.state));
+		if(send_addr==BROADCAST_ADDRESS || (send_addr!=board_id && graph[board_id][send_addr])){
+			send_packet(rail_handle, tx_packet.dst);
+			ret = true;
+		}
+		break;}
+	case O_GLB_SEND_LINKS:{ //Send a message of type MSG_LINKS (the discovery takes place on the shared channel).
+		tx_packet = (packet_t){ .type = MSG_LINKS, .src = board_id, .dst = BROADCAST_ADDRESS };
+		next_links(&tx_packet.owner, &tx_packet.links, &tx_packet.audible);
+		send_packet(rail_handle, tx_packet.dst);
 		ret = true;
 		break;}
 	default: //Should never reach here
@@ -441,38 +905,106 @@ bool packet_transmission (RAIL_Handle_t rail_handle, volatile tx_operation_t ope
 	return ret;
 }
 
+/*******************************************************************************
+ * Decides whether the state of this board is final.
+ ******************************************************************************/
+bool state_is_final(const float *prev_state){
+	if(CONSENSUS_UPDATE==CONSENSUS_FINITE_TIME && consensus_iters<=finite_time_iters) //The update after the exact average verifies that the neighbors computed the same one
+		return false;
+	return consensus_state_change(prev_state)<=STOP_THRESHOLD;
+}
+
+/*******************************************************************************
+ * Makes this board take part in the flood of a control message.
+ ******************************************************************************/
+void join_flood(const packet_t *packet, bool first){
+	if(!USE_FLOODING || USE_TDMA || USE_LOW_POWER_LISTEN || (!first && flood_type!=(int8_t) packet->type))
+		return;
+	if(first){
+		flood_type = packet->type;
+		flood_origin = packet->origin;
+		flood_informed = 0;
+		flood_relay_due = false;
+		if(relays_flood(packet->origin))
+			schedule_flood_relay();
+		else
+			cancel_flood_relay();
+	}
+	flood_informed |= 1UL << packet->src;
+}
+
+/*******************************************************************************
+ * Decides whether this board has to send a control message with the baton.
+ ******************************************************************************/
+bool flood_reached_neighbors(message_t type){
+	bool reached = flood_type==(int8_t) type;
+	for(int j=0;j<num_of_boards && reached;j++)
+		if(j!=board_id && graph[board_id][j] && !((flood_informed >> j) & 1))
+			reached = false;
+	if(flood_type!=(int8_t) type) //This board sends the message first, or without a flood
+		flood_origin = board_id;
+	cancel_flood_relay();
+	flood_type = -1;
+	flood_relay_due = false;
+	return reached;
+}
+
+/*******************************************************************************
+ * Counts the steps of the baton until it returns to this board.
+ ******************************************************************************/
+int steps_to_return(){
+	if(baton_position<0)
+		return 0;
+	for(int steps=1;steps<=length_of_baton_path;steps++)
+		if(baton_path[(baton_position+steps)%length_of_baton_path]==board_id)
+			return steps;
+	return 0;
+}
+
 /*******************************************************************************
  * Initializes the current board.
  ******************************************************************************/
 void initialize_app(RAIL_Handle_t rail_handle){
-	start_receiving(rail_handle); //start receiving in this board's channel.
+	cancel_radio_sleep(); //Stop any radio sleep window,
+	set_up_address_filter(rail_handle); //accept the messages to the (possibly new) identity of this board,
+	start_receiving(rail_handle); //and start receiving in this board's channel.
 	initialize_tools(); //initialize the tools provided by the app_tools.h module.
 	clear(); //Delete any existing states in the stack.
 	RAIL_CancelMultiTimer(&tmr0); //Stop the tmr0 timer (which counts for a timeout).
+	cancel_retransmission(); //Stop retransmitting the last message.
+	initialize_tdma(); //Stop any TDMA schedule, and compute the one of the current topology.
 
-	//Variables related to the board's status
-	calibration_status = 0;
-	error_code = 0;
-
-    // Flags to update state machine from interrupts
-    packet_received = false;
-    packet_sent = false;
-    rx_error = false;
-    tx_error = false;
-    cal_error = false;
+	flush_events(); //Discard the events of the interrupts which are still pending
 
     //Baton - related variables
 	baton = false;
+	baton_carries_state = false;
 	batons_per_cycle = 0;
 	baton_cntr = 0;
 
-	for(int i=0; i<LENGTH_OF_BATON_PATH; i++)
-		if(baton_path[i]==BOARD_ID)
+	for(int i=0; i<length_of_baton_path; i++)
+		if(baton_path[i]==board_id)
 			batons_per_cycle++;
+	baton_position = 0;
+	while(baton_position<length_of_baton_path && baton_path[baton_position]!=board_id) //The first position, where the task starts (see prepare_restart())
+		baton_position++;
+	if(baton_position==length_of_baton_path) //This board is not on the path, hence it never receives the baton
+		baton_position = -1;
 	current_task = T_NONE;
 
 	//Other variables
 	boards_completed_their_task = 0;
 	consensus_is_over = false;
+	start_relayed = false;
 	starting_board = -1;
+	cancel_flood_relay();
+	flood_type = -1;
+	flood_origin = board_id;
+	flood_informed = 0;
+	flood_relay_due = false;
+	flood_relaying = false;
+	stop_gossip();
+	gossip_due = false;
+	gossip_requester = -1;
+	sample_due = false;
 }
@@ -7,25 +7,11 @@
 #define APP_PROCESS_H
 
 #include "rail_types.h"
+#include "app_codec.h"
 
 // -----------------------------------------------------------------------------
 //                                Global Variables
 // -----------------------------------------------------------------------------
-/** Contains the status of RAIL Calibration */
-volatile RAIL_Status_t calibration_status;
-/**In case of a RX/TX error, it contains the code of the error.*/
-volatile uint64_t error_code;
-/**Becomes true when a new packet has been received.*/
-volatile bool packet_received;
-/**Become true when the transmission of a packet has been completed.*/
-volatile bool packet_sent ;
-/**Becomes true when an error was encountered during the reception of a new packet.*/
-volatile bool rx_error ;
-/**Becomes true when an error was encountered during the transmission of a new packet.*/
-volatile bool tx_error ;
-/**Becomes true when an error was encountered during the calibration of this board.*/
-volatile bool cal_error;
-
 /**Stores the board which started the execution of the distributed Average Consensus algorithm.*/
 int8_t starting_board;
 
@@ -51,12 +37,23 @@ int baton_cntr;
  */
 void app_process_action(RAIL_Handle_t rail_handle);
 
-/** The function handles the payload of a received message.
+/** The function handles a received message.
  *
  * @date 02/02/2023
- * @param rx_buffer The buffer with the payload of the received message.
+ * @param packet The decoded message.
+ */
+void handle_rx_packet_payload(const packet_t *packet);
+
+/** The function handles a message which was transmitted for another board, but
+ * was overheard on the shared channel. When it is the baton moving away from
+ * the neighborhood of this board, the radio is turned off until it can return
+ * (see {@link app_power#plan_radio_sleep() plan_radio_sleep()}).
+ *
+ * @date 16/10/2026
+ * @param rail_handle The RAIL instance of the radio.
+ * @param packet The decoded overheard message.
  */
-void handle_rx_packet_payload(const uint8_t * const rx_buffer);
+void handle_overheard_packet(RAIL_Handle_t rail_handle, const packet_t *packet);
 
 /** Initializes the variables of this application and prepares it for execution.
  *
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+ * @file app_routing.c
+ * @brief Implementation file for the multi-hop layer of the system.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_routing.h"
+#include "rail.h"
+#include "app_log.h"
+#include "app_events.h"
+
+///The hop distance between every two boards (or {@link UNREACHABLE}).
+static uint8_t hops[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+
+///The next hop of this board towards every board (or -1).
+static int8_t next_hops[MAX_NUM_OF_BOARDS];
+
+///The diameter of the graph.
+static uint8_t diameter;
+
+///The state of the random generator of the jitter (xorshift32, never 0).
+static uint32_t jitter_state = 1;
+
+///Expires when the jitter before the relay of a flood ends.
+static RAIL_MultiTimer_t flood_tmr;
+
+/** Computes the hop distances from a board to every board, with a
+ * breadth-first search.
+ *
+ * @date 16/10/2026
+ * @param s The board.
+ * @return The number of boards which are reachable from the board.
+ */
+static int search_from(int s){
+	uint8_t queue[MAX_NUM_OF_BOARDS];
+	int head = 0, tail = 0;
+	for(int i=0;i<num_of_boards;i++)
+		hops[s][i] = UNREACHABLE;
+	hops[s][s] = 0;
+	queue[tail++] = s;
+	while(head<tail){
+		int cur = queue[head++];
+		for(int i=0;i<num_of_boards;i++){
+			if(graph[cur][i] && hops[s][i]==UNREACHABLE){
+				hops[s][i] = hops[s][cur]+1;
+				queue[tail++] = i;
+			}
+		}
+		if(hops[s][cur]>diameter)
+			diameter = hops[s][cur];
+	}
+	return tail;
+}
+
+/** The callback of the {@link flood_tmr} timer: the flood is relayed by the
+ * main loop.
+ *
+ * @date 16/10/2026
+ * @param tmr Is not used.
+ * @param expectedTimeOfEvent Is not used.
+ * @param cbArg Is not used.
+ */
+static void flood_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)expectedTimeOfEvent; (void)cbArg;
+	post_event(E_FLOOD_RELAY, 0);
+}
+
+/*******************************************************************************
+ * Computes the routing table from the graph.
+ ******************************************************************************/
+void initialize_routing(){
+	bool connected = true;
+	diameter = 0;
+	for(int s=0;s<num_of_boards;s++)
+		connected = search_from(s)==num_of_boards && connected;
+	if(!connected)
+		diameter = num_of_boards;
+	for(int i=0;i<num_of_boards;i++){
+		next_hops[i] = -1;
+		for(int j=0;j<num_of_boards && i!=board_id && hops[board_id][i]!=UNREACHABLE;j++){
+			if(j!=board_id && graph[board_id][j] && hops[j][i]+1==hops[board_id][i]){
+				next_hops[i] = j;
+				break;
+			}
+		}
+	}
+	jitter_state = 0x9E3779B9UL*(board_id+1); //every board draws a different sequence
+}
+
+/*******************************************************************************
+ * Returns the number of hops between two boards.
+ ******************************************************************************/
+uint8_t hop_distance(uint8_t from, uint8_t to){
+	return from<num_of_boards && to<num_of_boards ? hops[from][to] : UNREACHABLE;
+}
+
+/*******************************************************************************
+ * Returns the next hop of this board towards another board.
+ ******************************************************************************/
+int8_t next_hop(uint8_t to){
+	return to<num_of_boards ? next_hops[to] : -1;
+}
+
+/*******************************************************************************
+ * Returns the diameter of the graph.
+ ******************************************************************************/
+uint8_t routing_diameter(){
+	return diameter;
+}
+
+/*******************************************************************************
+ * Returns whether a neighbor is downstream of this board in a flood.
+ ******************************************************************************/
+bool is_downstream(uint8_t origin, uint8_t neighbor){
+	return neighbor!=board_id && graph[board_id][neighbor] && hop_distance(origin, neighbor)!=UNREACHABLE
+			&& hop_distance(origin, neighbor)>hop_distance(origin, board_id);
+}
+
+/*******************************************************************************
+ * Returns whether this board has to relay a flood.
+ ******************************************************************************/
+bool relays_flood(uint8_t origin){
+	for(int j=0;j<num_of_boards;j++)
+		if(is_downstream(origin, j))
+			return true;
+	return false;
+}
+
+/*******************************************************************************
+ * Schedules the relay of a flood after a random jitter.
+ ******************************************************************************/
+void schedule_flood_relay(){
+	jitter_state ^= jitter_state << 13;
+	jitter_state ^= jitter_state >> 17;
+	jitter_state ^= jitter_state << 5;
+	uint32_t slots = jitter_state & ((1UL << FLOOD_JITTER_BITS) - 1);
+	RAIL_SetMultiTimer(&flood_tmr, slots*FLOOD_SLOT_MICROSECS, RAIL_TIME_DELAY, &flood_alarm, NULL);
+}
+
+/*******************************************************************************
+ * Cancels the relay of a flood.
+ ******************************************************************************/
+void cancel_flood_relay(){
+	RAIL_CancelMultiTimer(&flood_tmr);
+}
+
+/*******************************************************************************
+ * Prints the routing table of this board.
+ ******************************************************************************/
+void print_routes(){
+	app_log_info("  Routes:       ");
+	for(int i=0;i<num_of_boards;i++){
+		if(i==board_id)
+			continue;
+		if(next_hops[i]<0)
+			app_log_info("%d:- ", i);
+		else
+			app_log_info("%d:%d(%d) ", i, next_hops[i], hops[board_id][i]);
+	}
+	app_log_info("(destination:next hop(hops), diameter %d)\n", diameter);
+}
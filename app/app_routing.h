@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ * @file app_routing.h
+ * @brief Header file for the multi-hop layer of the system: a routing table
+ * derived from the graph (the hop distance between every two boards, and the
+ * next hop of this board towards every board), and the flood of the control
+ * messages (see {@link USE_FLOODING}). A restart or start message travels
+ * outwards from the board which started it (its origin): every board relays it
+ * once, after a random jitter, and only if some neighbor is farther from the
+ * origin than itself (a board receives the first copy from a board closer to
+ * the origin, so copies from the other boards are duplicates, which the
+ * application drops). The message reaches every board within diameter-many
+ * hops, in parallel with the baton, instead of being sent by every board when
+ * the baton reaches it.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_ROUTING_H
+#define APP_ROUTING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+
+///The hop distance between two boards which are not connected in the graph.
+#define UNREACHABLE 0xFF
+
+///The slot of the jitter before a relay of the flood: the airtime of a restart or start message at 2.4 kbps (50 ms), plus a margin, so that boards which relay in different slots do not collide.
+#define FLOOD_SLOT_MICROSECS 60000
+
+///The jitter before a relay of the flood is a random number of slots in [0, 2^FLOOD_JITTER_BITS).
+#define FLOOD_JITTER_BITS 3
+
+/** Computes the routing table from the {@link graph}, with a breadth-first
+ * search from every board. It is called whenever the topology is applied
+ * (before the timers of RAIL are configured, at boot).
+ *
+ * @date 16/10/2026
+ */
+void initialize_routing();
+
+/** Returns the number of hops between two boards.
+ *
+ * @date 16/10/2026
+ * @param from The first board.
+ * @param to The second board.
+ * @return The number of hops, or {@link UNREACHABLE}.
+ */
+uint8_t hop_distance(uint8_t from, uint8_t to);
+
+/** Returns the neighbor of this board on a shortest route to another board
+ * (the one with the smallest identity, if several exist).
+ *
+ * @date 16/10/2026
+ * @param to The other board.
+ * @return The next hop, or -1 if the other board is this one or unreachable.
+ */
+int8_t next_hop(uint8_t to);
+
+/** Returns the diameter of the graph, i.e., the number of hops for a flood to
+ * reach every board. A disconnected graph gets a diameter of
+ * {@link num_of_boards}.
+ *
+ * @date 16/10/2026
+ * @return The diameter of the graph.
+ */
+uint8_t routing_diameter();
+
+/** Returns whether a neighbor of this board is farther than it from the origin
+ * of a flood, i.e., whether it has to receive the flood from this board (or
+ * another board at the same distance).
+ *
+ * @date 16/10/2026
+ * @param origin The origin of the flood.
+ * @param neighbor The neighbor.
+ * @return True if the neighbor is downstream of this board.
+ */
+bool is_downstream(uint8_t origin, uint8_t neighbor);
+
+/** Returns whether this board has to relay a flood, i.e., whether it has a
+ * neighbor downstream (see {@link is_downstream()}).
+ *
+ * @date 16/10/2026
+ * @param origin The origin of the flood.
+ * @return True if the flood has to be relayed by this board.
+ */
+bool relays_flood(uint8_t origin);
+
+/** Schedules the relay of a flood after a random jitter of up to
+ * 2^{@link FLOOD_JITTER_BITS} slots, when the event
+ * {@link app_events#event_t E_FLOOD_RELAY} is posted.
+ *
+ * @date 16/10/2026
+ */
+void schedule_flood_relay();
+
+/** Cancels the relay of a flood, if it is still scheduled.
+ *
+ * @date 16/10/2026
+ */
+void cancel_flood_relay();
+
+/** Prints the routing table of this board (the next hop and the hops towards
+ * every board) to the console.
+ *
+ * @date 16/10/2026
+ */
+void print_routes();
+
+#endif  // APP_ROUTING_H
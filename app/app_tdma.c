@@ -0,0 +1,174 @@
+/***************************************************************************//**
+ * @file app_tdma.c
+ * @brief Implementation file for the TDMA schedule of the system.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_tdma.h"
+#include "rail.h"
+#include "app_tools.h"
+#include "app_events.h"
+#include "app_routing.h"
+
+///Triggers the events of the schedule (the start of every frame, and the slot of this board).
+static RAIL_MultiTimer_t tdma_tmr;
+
+///The start of frame 0, in the RAIL time of this board.
+static RAIL_Time_t tdma_epoch;
+
+///The frame of the next event of the schedule.
+static int next_frame;
+
+///The time when the transmission of the current slot of this board should start, in the RAIL time of this board.
+static RAIL_Time_t slot_time;
+
+///True if the next event of the schedule is the slot of this board, false if it is the start of {@link next_frame}.
+static bool next_is_slot;
+
+///The duration of a frame in microseconds.
+#define TDMA_FRAME_MICROSECS ((uint32_t) tdma_num_of_slots*TDMA_SLOT_MILISECS*1000)
+
+/** Returns whether a board hears another one while a neighbor of it (in the
+ * {@link graph}) transmits, i.e., whether the two boards are at distance up to
+ * 2, where the second hop may be a link which is only {@link audible}. Without
+ * discovered links, this is the distance up to 2 in the graph.
+ *
+ * @date 16/10/2026
+ * @param i The first board.
+ * @param j The second board.
+ * @return True if the two boards would interfere when transmitting in the same slot.
+ */
+static bool interfere(int i, int j){
+	for(int k=0;k<num_of_boards;k++)
+		if((graph[i][k] && audible[k][j]) || (audible[i][k] && graph[k][j]))
+			return true;
+	return false;
+}
+
+/** Returns the time of the next event of the schedule.
+ *
+ * @date 16/10/2026
+ * @return The time of the event, in the RAIL time of this board.
+ */
+static RAIL_Time_t next_event_time(){
+	RAIL_Time_t t = tdma_epoch + (RAIL_Time_t)((int32_t) next_frame*(int32_t) TDMA_FRAME_MICROSECS);
+	if(next_is_slot)
+		t += ((RAIL_Time_t) tdma_slots[board_id]*TDMA_SLOT_MILISECS + TDMA_GUARD_MILISECS)*1000;
+	return t;
+}
+
+static void tdma_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg);
+
+/** Arms the TDMA timer for the next event of the schedule which is still in
+ * the future (the events which have already passed are skipped).
+ *
+ * @date 16/10/2026
+ */
+static void arm_next_event(){
+	RAIL_Time_t now = RAIL_GetTime();
+	do {
+		if(next_is_slot)
+			next_frame++;
+		next_is_slot = !next_is_slot;
+	} while((int32_t)(next_event_time()-now)<=0);
+	RAIL_SetMultiTimer(&tdma_tmr, next_event_time(), RAIL_TIME_ABSOLUTE, &tdma_alarm, NULL);
+}
+
+/** The callback function of the TDMA timer. It posts the event (see
+ * {@link app_events#event_t E_TDMA_FRAME}, {@link app_events#event_t E_TDMA_SLOT})
+ * and arms the timer for the next one.
+ *
+ * @date 16/10/2026
+ * @param tmr The timer which expired.
+ * @param expectedTimeOfEvent The time of the event.
+ * @param cbArg Is not used.
+ */
+static void tdma_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
+	(void)tmr; (void)cbArg;
+	if(next_is_slot){
+		slot_time = expectedTimeOfEvent;
+		post_event(E_TDMA_SLOT, 0);
+	}
+	else
+		post_event(E_TDMA_FRAME, (uint32_t) next_frame);
+	arm_next_event();
+}
+
+/*******************************************************************************
+ * Computes the schedule of the current topology.
+ ******************************************************************************/
+void initialize_tdma(){
+	RAIL_CancelMultiTimer(&tdma_tmr);
+	tdma_frame_started = false;
+	tdma_slot_started = false;
+	tdma_frame = 0;
+
+	tdma_num_of_slots = 0;
+	for(int i=0;i<num_of_boards;i++){
+		uint32_t used = 0; //the slots of the boards which would interfere with board i
+		for(int j=0;j<i;j++)
+			if(interfere(i, j))
+				used |= 1UL << tdma_slots[j];
+		tdma_slots[i] = 0;
+		while(used & (1UL << tdma_slots[i]))
+			tdma_slots[i]++;
+		if(tdma_slots[i]+1>tdma_num_of_slots)
+			tdma_num_of_slots = tdma_slots[i]+1;
+	}
+	tdma_diameter = routing_diameter();
+}
+
+/*******************************************************************************
+ * Computes a schedule which does not depend on the graph.
+ ******************************************************************************/
+void initialize_tdma_without_graph(){
+	initialize_tdma();
+	for(int i=0;i<num_of_boards;i++)
+		tdma_slots[i] = i;
+	tdma_num_of_slots = num_of_boards;
+	tdma_diameter = num_of_boards-1;
+}
+
+/*******************************************************************************
+ * Starts the schedule.
+ ******************************************************************************/
+void start_tdma(RAIL_Time_t epoch){
+	RAIL_CancelMultiTimer(&tdma_tmr);
+	tdma_epoch = epoch;
+	tdma_frame = -tdma_diameter-1;
+	next_frame = tdma_frame;
+	next_is_slot = true;
+	arm_next_event();
+}
+
+/*******************************************************************************
+ * Starts a new schedule from this board.
+ ******************************************************************************/
+void start_tdma_now(){
+	//The start message of this board needs a slot to reach its neighbors, and every setup frame carries it one hop further
+	start_tdma(RAIL_GetTime() + 2*TDMA_SLOT_MILISECS*1000 + tdma_diameter*TDMA_FRAME_MICROSECS);
+}
+
+/*******************************************************************************
+ * Returns whether the slot of this board is still open for a transmission.
+ ******************************************************************************/
+bool tdma_slot_is_open(){
+	return (int32_t)(RAIL_GetTime()-slot_time) <= TDMA_GUARD_MILISECS*1000;
+}
+
+/*******************************************************************************
+ * Writes the timestamps of the schedule to a message.
+ ******************************************************************************/
+void write_tdma_timestamps(packet_t *packet){
+	packet->tdma = true;
+	packet->timestamp = RAIL_GetTime();
+	packet->epoch = tdma_epoch;
+}
+
+/*******************************************************************************
+ * Starts the schedule of a received message.
+ ******************************************************************************/
+void synchronize_tdma(const packet_t *packet, RAIL_Time_t rx_time){
+	RAIL_Time_t offset = rx_time - packet->timestamp; //the time of this board minus the time of the sender
+	start_tdma(packet->epoch + offset);
+}
@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * @file app_tdma.h
+ * @brief Header file for the TDMA schedule of the system, an alternative to the
+ * baton (see {@link USE_TDMA}). Every board broadcasts in its own slot of a
+ * frame, and boards which cannot interfere (i.e., at distance greater than 2
+ * in the graph) share the same slot.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_TDMA_H
+#define APP_TDMA_H
+
+#include "rail_types.h"
+#include "app_config.h"
+#include "app_codec.h"
+
+#if USE_TDMA && !USE_SHARED_CHANNEL
+#error "The TDMA schedule requires all boards to receive on the shared channel (USE_SHARED_CHANNEL 1)."
+#endif
+
+///The maximum number of frames (i.e., iterations) of Average Consensus in TDMA mode. When reached, the boards stop even if they are not below the STOP_THRESHOLD.
+#define TDMA_MAX_FRAMES 250
+
+///The time from the start of a slot until the transmission of its board, in milliseconds. It absorbs the errors of the synchronization, and leaves time for the update at the start of a frame. A transmission which cannot start within another TDMA_GUARD_MILISECS is skipped, so that it does not overlap with the next slot.
+#define TDMA_GUARD_MILISECS 8
+
+///A value of the quiet-frames counter (see {@link app_codec#packet_t quiet_frames}) marking that the sender has terminated the algorithm.
+#define TDMA_DONE 255
+
+///The slot of every board in a frame (its color in the distance-2 coloring of the graph).
+uint8_t tdma_slots[MAX_NUM_OF_BOARDS];
+
+///The number of slots of a frame (i.e., the number of colors).
+uint8_t tdma_num_of_slots;
+
+///The diameter of the graph (the number of hops for a message to reach every board).
+uint8_t tdma_diameter;
+
+///The current frame of the schedule. Frames before 0 are used to disseminate the start of the task (setup frames), and frame k>=0 is iteration k.
+int tdma_frame;
+
+///Becomes true (from the main loop, when the event of the TDMA timer is drained) when a new frame begins, and {@link tdma_frame} is updated.
+bool tdma_frame_started;
+
+///Becomes true (from the main loop, when the event of the TDMA timer is drained) when the slot of this board begins.
+bool tdma_slot_started;
+
+/** Computes the schedule from the {@link graph}: a greedy distance-2 coloring
+ * (in the order of the identities, so that all boards compute the same one),
+ * and the diameter of the graph. It also stops any running schedule.
+ *
+ * @date 16/10/2026
+ */
+void initialize_tdma();
+
+/** Computes a schedule which does not depend on the {@link graph}, for the
+ * discovery of the graph (see app_discovery.h): every board gets its own slot,
+ * and the diameter is the largest possible (a line of all boards). It also
+ * stops any running schedule.
+ *
+ * @date 16/10/2026
+ */
+void initialize_tdma_without_graph();
+
+/** Starts the schedule, so that its events are posted at the right times until
+ * {@link initialize_tdma()} is called.
+ *
+ * @date 16/10/2026
+ * @param epoch The start of frame 0 (in the RAIL time of this board).
+ */
+void start_tdma(RAIL_Time_t epoch);
+
+/** Starts a new schedule from this board, whose frame 0 begins after enough
+ * setup frames for the start message to reach every board.
+ *
+ * @date 16/10/2026
+ */
+void start_tdma_now();
+
+/** Returns whether the slot of this board (after {@link tdma_slot_started} was
+ * raised) is still open for a transmission.
+ *
+ * @date 16/10/2026
+ * @return True if a transmission which starts now ends within the slot.
+ */
+bool tdma_slot_is_open();
+
+/** Writes the current time and the start of frame 0 (both in the RAIL time of
+ * this board) to a message, so that its receivers synchronize with the schedule.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ */
+void write_tdma_timestamps(packet_t *packet);
+
+/** Starts the schedule described by a received message (see
+ * {@link write_tdma_timestamps()}), after converting its times to the RAIL
+ * time of this board.
+ *
+ * @date 16/10/2026
+ * @param packet The message.
+ * @param rx_time The time (in the RAIL time of this board) when the preamble
+ * of the message started on the air.
+ */
+void synchronize_tdma(const packet_t *packet, RAIL_Time_t rx_time);
+
+#endif  // APP_TDMA_H
@@ -4,11 +4,15 @@
  * @author Georgios Apostolakis
  ******************************************************************************/
 #include "app_tools.h"
+#include "rail.h"
 #include "app_log.h"
 #include "sl_si70xx.h"
 #include "sl_i2cspm_instances.h"
 #include "app_config.h"
 #include "app_process.h"
+#include "app_events.h"
+#include "app_power.h"
+#include "app_network.h"
 
 //=========================================================================
 //-------------------- SLEEP MECHANISM ------------------------------------
@@ -17,17 +21,36 @@
 /** This variable is the core of the sleep mechanism. It cannot be directly changed by the user, but only through the {@link wake_up()}, {@link sleep()} functions.*/
 static bool ready_to_sleep = false;
 
+///True if the last pass through the main loop found nothing to do, i.e., the next pass only has work after an interrupt (see {@link allow_mcu_sleep()}).
+static bool mcu_idle = false;
+
 /*******************************************************************************
- * Returns whether the board should sleep or not.
+ * Returns whether the MCU can sleep until the next interrupt.
  ******************************************************************************/
 bool app_is_ok_to_sleep(void) {
-  return ready_to_sleep;
+  return mcu_idle && !events_pending();
+}
+
+/*******************************************************************************
+ * Records whether the last pass through the main loop found nothing to do.
+ ******************************************************************************/
+void allow_mcu_sleep(bool idle){
+	mcu_idle = idle;
+}
+
+/*******************************************************************************
+ * Returns whether the board sleeps.
+ ******************************************************************************/
+bool is_asleep(){
+	return ready_to_sleep;
 }
 
 /*******************************************************************************
  * Forces the current board to sleep.
  ******************************************************************************/
 void sleep(){
+	if(!ready_to_sleep)
+		stop_energy_estimate();
 	ready_to_sleep = true;
 }
 
@@ -35,8 +58,10 @@ void sleep(){
  * Forces the current board to wake up.
  ******************************************************************************/
 void wake_up(){
-	if(ready_to_sleep)
+	if(ready_to_sleep){
 		app_log_info("Woke up!\n");
+		start_energy_estimate();
+	}
 	ready_to_sleep = false;
 }
 //*************************************************************************
@@ -46,21 +71,53 @@ void wake_up(){
 //---------------------- GENERIC TOOLS ------------------------------------
 //=========================================================================
 
+///True while a measurement of the sensor, started by {@link start_temperature_measurement()}, has not been read yet.
+static bool measurement_pending = false;
+
+///The time when the pending measurement of the sensor was started (in the RAIL time of this board).
+static RAIL_Time_t measurement_started;
+
+///Expires when the pending measurement of the sensor has been converted, so that the main loop does not poll the sensor.
+static RAIL_MultiTimer_t sensor_tmr;
+
 /*******************************************************************************
- * Stores the current temperature at the {@link temperature} variable.
+ * Starts a measurement of the sensor in the background.
+ ******************************************************************************/
+void start_temperature_measurement(){
+	if(measurement_pending)
+		return;
+	measurement_pending = sl_si70xx_start_no_hold_measure_rh_and_temp(sl_i2cspm_sensor, SI7021_ADDR)==SL_STATUS_OK;
+	measurement_started = RAIL_GetTime();
+	if(measurement_pending)
+		RAIL_SetMultiTimer(&sensor_tmr, SENSOR_CONVERSION_MICROSECS, RAIL_TIME_DELAY, &enable_alarm, NULL);
+}
+
+/*******************************************************************************
+ * Returns whether the result of the sensor is ready.
+ ******************************************************************************/
+bool temperature_is_ready(){
+	return !measurement_pending || RAIL_GetTime()-measurement_started >= SENSOR_CONVERSION_MICROSECS;
+}
+
+/*******************************************************************************
+ * Stores the current temperature & humidity at their variables.
  ******************************************************************************/
 void measure_temperature(){
 	int32_t temp_data;
 	uint32_t rh_data;
-	sl_si70xx_measure_rh_and_temp(sl_i2cspm_sensor, SI7021_ADDR, &rh_data, &temp_data);
+	if(!measurement_pending || sl_si70xx_read_rh_and_temp(sl_i2cspm_sensor, SI7021_ADDR, &rh_data, &temp_data)!=SL_STATUS_OK)
+		sl_si70xx_measure_rh_and_temp(sl_i2cspm_sensor, SI7021_ADDR, &rh_data, &temp_data);
+	measurement_pending = false;
 	float temp = (float) temp_data/1000.0;
 	app_log_info("Actual temperature now is %.2f degrees of Celsius.", temp);
 	if(SIMULATE_TEMPERATURE_MEASUREMENTS){
-		temperature = simulated_temperatures[BOARD_ID];
+		temperature = simulated_temperatures[board_id];
+		humidity = simulated_humidities[board_id];
 		app_log_info(" However, a (simulated) value of %.2f degrees will be used instead.\n", temperature);
 	}
 	else{
 		temperature = temp;
+		humidity = (float) rh_data/1000.0;
 		app_log_info("\n");
 	}
 }
@@ -70,21 +127,111 @@ void measure_temperature(){
  ******************************************************************************/
 void enable_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg){
 	(void)cbArg; (void)expectedTimeOfEvent;
-	if(tmr==(&tmr0)){
-		baton = true;
-		for(int i=0;i<LENGTH_OF_BATON_PATH;i++){
-			if(baton_path[i]==BOARD_ID){
-				dst_of_baton = i+1;
-				break;
-			}
-		}
-		if(dst_of_baton==LENGTH_OF_BATON_PATH)
-			dst_of_baton = 0;
-		dst_of_baton = baton_path[dst_of_baton];
+	if(tmr==(&tmr0))
+		post_event(E_RESTART_TIMEOUT, 0); //The restart is prepared by the main loop
+	else if(tmr==(&sensor_tmr))
+		post_event(E_SENSOR_READY, 0); //The result is read by the main loop
+}
+
+//=========================================================================
+//-------------------- RESTART TIMEOUT ------------------------------------
+//=========================================================================
 
-		restart_command = true;
-		restart_id++;
+///The smoothed time per step of the baton (in microseconds), or 0 if no return of the baton has been measured in the current run.
+static uint32_t step_time;
+
+///The smoothed mean deviation of the time per step of the baton (in microseconds).
+static uint32_t step_deviation;
+
+///The number of doublings of the restart timeout (see {@link MAX_RESTART_BACKOFFS}).
+static uint8_t backoffs;
+
+///True if the next return of the baton is not measured (see {@link baton_returned()}).
+static bool skip_return = true;
+
+///True while {@link tmr0} counts for a return of the baton.
+static bool timer_armed;
+
+///The time when {@link tmr0} was armed.
+static RAIL_Time_t armed_time;
+
+/*******************************************************************************
+ * Arms the restart timer for a return of the baton.
+ ******************************************************************************/
+void arm_restart_timer(int steps){
+	uint32_t max_timeout = (uint32_t) steps*MAX_DELAY_PER_BATON_STEP_MILISECS*1000;
+	uint32_t timeout = max_timeout;
+	if(step_time>0){
+		timeout = ((uint32_t) steps*(step_time + 4*step_deviation)) << backoffs;
+		if(USE_ACKS) //A step whose message is retransmitted does not trigger a restart
+			timeout += MAX_TX_RETRIES*step_time + MAX_RETRANSMISSION_DELAY_MICROSECS;
+		if(timeout<MIN_RESTART_TIMEOUT_MILISECS*1000)
+			timeout = MIN_RESTART_TIMEOUT_MILISECS*1000;
+		if(timeout>max_timeout)
+			timeout = max_timeout;
+	}
+	armed_time = RAIL_GetTime();
+	timer_armed = true;
+	RAIL_SetMultiTimer(&tmr0, timeout, RAIL_TIME_DELAY, &enable_alarm, NULL);
+}
+
+/*******************************************************************************
+ * Measures a return of the baton.
+ ******************************************************************************/
+void baton_returned(int steps){
+	RAIL_CancelMultiTimer(&tmr0);
+	if(!timer_armed || steps<=0)
+		return;
+	timer_armed = false;
+	uint32_t sample = (RAIL_GetTime()-armed_time)/steps;
+	if(skip_return){
+		skip_return = false;
+		return;
 	}
+	if(step_time==0){ //The first measurement (RFC 6298)
+		step_time = sample;
+		step_deviation = sample/2;
+	}
+	else {
+		uint32_t error = sample>step_time ? sample-step_time : step_time-sample;
+		step_deviation = (3*step_deviation + error)/4;
+		step_time = (7*step_time + sample)/8;
+	}
+	backoffs = 0;
+}
+
+/*******************************************************************************
+ * Forgets the measured steps of the baton.
+ ******************************************************************************/
+void reset_restart_timeout(){
+	step_time = 0;
+	step_deviation = 0;
+	backoffs = 0;
+	skip_return = true;
+	timer_armed = false;
+}
+
+/*******************************************************************************
+ * Prepares this board to restart the system.
+ ******************************************************************************/
+void prepare_restart(){
+	timer_armed = false;
+	skip_return = true;
+	if(backoffs<MAX_RESTART_BACKOFFS)
+		backoffs++;
+	baton = true;
+	for(int i=0;i<length_of_baton_path;i++){
+		if(baton_path[i]==board_id){
+			dst_of_baton = i+1;
+			break;
+		}
+	}
+	if(dst_of_baton==length_of_baton_path)
+		dst_of_baton = 0;
+	dst_of_baton = baton_path[dst_of_baton];
+
+	restart_command = true;
+	restart_id++;
 }
 
 
@@ -96,5 +243,8 @@ void initialize_tools(){
 
 	average_command = false;
 	restart_command = false;
+	discovery_command = false;
+	gossip_command = false;
+	tracking_command = false;
 	restart_id = 0;
 }
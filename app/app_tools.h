@@ -8,26 +8,14 @@
 
 #include <rail_types.h>
 
-///The maximum delay for a board to release the baton, after it has received it (in milliseconds).
+///The maximum delay for a board to release the baton, after it has received it (in milliseconds). The restart timeout allows it for every step of the baton, until the steps of the current run have been measured (see {@link arm_restart_timer()}).
 #define MAX_DELAY_PER_BATON_STEP_MILISECS 1000
 
-///If the baton has not completed at least one cycle in the specified time (in milliseconds), the system will restart.
-#define RESTART_TIMEOUT_MILISECS ((LENGTH_OF_BATON_PATH-1)*MAX_DELAY_PER_BATON_STEP_MILISECS)
-
-//These constants will be used as indexes for the TX/RX messages.
-//When 2 constants are equal, they cannot be both included in the same message (obviously).
-///The index in the message payload where the type of the message is specified.
-#define MSGIDX_TYPE 0
-///The index in the message payload where the source board is specified.
-#define MSGIDX_SRC_BOARD 1
-///The index in the message payload where the destination board is specified.
-#define MSGIDX_DST_BOARD 2
-///The index in the message payload where the current task is specified.
-#define MSGIDX_TASK 3
-///The index in the message payload where the number of boards which agree to terminate the algorithm is specified.
-#define MSGIDX_BOARDS_OVER 3
-///The index in the message payload where the restart id (a number related with the restarting of the system) is specified.
-#define MSGIDX_RESTART_ID 3
+///The minimum restart timeout (in milliseconds), which absorbs the jitter of the measured baton steps on a short return of the baton.
+#define MIN_RESTART_TIMEOUT_MILISECS 20
+
+///The maximum number of doublings of the restart timeout after consecutive restarts (see {@link arm_restart_timer()}).
+#define MAX_RESTART_BACKOFFS 6
 
 ///Responsible to count the time between 2 batons passed from the board which started the averaging task. If it alarms, a restart of the system is initiated.
 RAIL_MultiTimer_t tmr0;
@@ -38,53 +26,160 @@ volatile bool average_command;
 /// When it is true, the system has to restart, starting from the current board.
 volatile bool restart_command;
 
+///When it is true, the discovery of the graph has to be executed (see app_discovery.h), started by the current board (if it is the {@link app_process#starting_board starting_board}) or joined.
+volatile bool discovery_command;
+
+///When it is true, the randomized gossip has to be executed (see app_gossip.h), started by the current board or joined.
+volatile bool gossip_command;
+
+///When it is true, the tracking of the average has to be executed (see app_gossip.h), started by the current board or joined.
+volatile bool tracking_command;
+
 ///A parameter used to determine when to restart. Re-initialization of the board takes place only if an id greater than the current value of this parameter is received from another board.
 int restart_id;
 
+///The conversion time of a measurement of the temperature & humidity sensor, in microseconds (the maximum conversion times of a 12-bit humidity and a 14-bit temperature measurement of the Si7021).
+#define SENSOR_CONVERSION_MICROSECS 23000
+
 ///Stores the last measured temperature by the current board, retrieved by the {@link measure_temperature()} function.
 float temperature;
 
-/** The callback function for {@link tmr0} timer. It re-initializes this board,
- * as part of a general restart which is starting for the whole distributed system.
+///Stores the last measured relative humidity (in %RH) by the current board, retrieved together with the {@link temperature}.
+float humidity;
+
+/** The callback function for {@link tmr0} timer. It posts the event of a
+ * restart (see {@link app_events#event_t E_RESTART_TIMEOUT}), which is handled
+ * by the main loop with {@link prepare_restart()}. It also posts the event of
+ * a converted measurement of the sensor (see
+ * {@link app_events#event_t E_SENSOR_READY}).
  *
  * @date 20/01/2023
- * @param tmr The timer which expired (i.e., {@link tmr0}).
+ * @param tmr The timer which expired (i.e., {@link tmr0}, or the timer of the sensor).
  * @param expectedTimeOfEvent Is not used.
  * @param cbArg Is not used.
  */
 void enable_alarm(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg);
 
+/** Prepares this board to re-initialize, as part of a general restart which is
+ * starting for the whole distributed system (after {@link tmr0} expired): it
+ * acquires the baton and raises the {@link restart_command}. It also doubles
+ * the next restart timeout (see {@link arm_restart_timer()}).
+ *
+ * @date 16/10/2026
+ */
+void prepare_restart();
+
+/** Arms the {@link tmr0} timer, when the starting board releases the baton,
+ * for the time that the baton needs to return to it. The timeout is estimated
+ * from the measured returns of the baton (see {@link baton_returned()}), as
+ * the retransmission timeout of TCP: the smoothed time per step of the baton
+ * plus 4 times its mean deviation, for every step until the return, but at
+ * least {@link MIN_RESTART_TIMEOUT_MILISECS}, plus the delay of the
+ * retransmissions of one step if {@link USE_ACKS} equals to 1. It is doubled after every
+ * restart, until a return is measured again (up to
+ * {@link MAX_RESTART_BACKOFFS} times). Until the first return of the run has
+ * been measured, {@link MAX_DELAY_PER_BATON_STEP_MILISECS} is allowed for
+ * every step.
+ *
+ * @date 16/10/2026
+ * @param steps The steps of the baton until it returns to this board.
+ */
+void arm_restart_timer(int steps);
+
+/** Cancels the {@link tmr0} timer when the baton returns to the starting
+ * board, and updates the estimated time per step of the baton with the time
+ * since the timer was armed. The first return of a run (or after a restart) is
+ * not measured, since it includes the start of the task on every board.
+ *
+ * @date 16/10/2026
+ * @param steps The steps of the baton since it was released by this board.
+ */
+void baton_returned(int steps);
+
+/** Forgets the measured steps of the baton, e.g., when the run is over, since
+ * the next run starts with the wake-up of the boards.
+ *
+ * @date 16/10/2026
+ */
+void reset_restart_timeout();
+
 /** This function is automatically called by the PowerManager API, to determine
- * whether the board will go into sleep mode or not. Its return value is
- * determined from whether {@link wake_up()} or {@link sleep()} was called last.
- * When the board is initially powered on (or the reset button is pressed), it
- * returns false (until {@link sleep()} is called for first time). Notice that
- * its result is not affected by restarts of the distributed system.
+ * whether the MCU will go into sleep mode (until the next interrupt) or not.
+ * It returns true only when the last pass through the main loop found nothing
+ * to do (see {@link allow_mcu_sleep()}) and no event is pending, whether the
+ * board sleeps (see {@link is_asleep()}) or not. The PowerManager calls it
+ * with the interrupts disabled, hence an event posted right after it is
+ * checked wakes the MCU immediately. The lowest energy mode is determined by
+ * the requirements of the drivers: RAIL keeps the MCU in EM1 while the radio
+ * is active, hence the MCU only reaches EM2 while the radio is turned off
+ * (see {@link app_power#plan_radio_sleep() plan_radio_sleep()}).
  *
- * @date 20/01/2023
- * @return True if the board should sleep, false if the board should not.
+ * @date 16/10/2026
+ * @return True if the MCU should sleep, false if it should not.
  */
 bool app_is_ok_to_sleep(void);
 
-//  Check if the MCU can sleep at that time.
+/** Records whether the last pass through the main loop found nothing to do,
+ * i.e., whether the next pass would only have work after an interrupt. It is
+ * called by the main loop after every pass.
+ *
+ * @date 16/10/2026
+ * @param idle True if the pass found nothing to do.
+ */
+void allow_mcu_sleep(bool idle);
+
+/** Returns whether the board sleeps, i.e., whether {@link sleep()} or
+ * {@link wake_up()} was called last. When the board is initially powered on
+ * (or the reset button is pressed), it returns false (until {@link sleep()} is
+ * called for first time). Notice that its result is not affected by restarts
+ * of the distributed system.
+ *
+ * @date 16/10/2026
+ * @return True if the board sleeps, false if the board is awake.
+ */
+bool is_asleep();
 
 /** Forces the board to sleep. From the call of this method (and until
- * {@link wake_up()} is called), {@link app_is_ok_to_sleep()} will return true.
+ * {@link wake_up()} is called), {@link is_asleep()} will return true. It also
+ * stops the energy estimate of the current run (see {@link app_power.h}).
  *
  * @date 20/01/2023
  */
 void sleep();
 
 /** Forces the board to wake up. From the call of this method (and until
- * {@link sleep()} is called), {@link app_is_ok_to_sleep()} will return false.
+ * {@link sleep()} is called), {@link is_asleep()} will return false. It also
+ * starts the energy estimate of a new run (see {@link app_power.h}).
  *
  * @date 20/01/2023
  */
 void wake_up();
 
-/** Stores the current temperature, as measured by this board's thermistor (or
- * a simulated value, depending on the {@code SIMULATE_TEMPERATURE_MEASUREMENTS}
- * constant) in the {@link temperature} variable.
+/** Starts a measurement of the sensor in the background (without holding the
+ * I2C bus), so that its result is ready when {@link measure_temperature()} is
+ * called later. It does nothing if a measurement has already been started.
+ * The event {@link app_events#event_t E_SENSOR_READY} is posted when the
+ * conversion is completed.
+ *
+ * @date 16/10/2026
+ */
+void start_temperature_measurement();
+
+/** Returns whether the measurement started by {@link start_temperature_measurement()}
+ * has been completed (or no measurement was started), i.e., whether
+ * {@link measure_temperature()} would return without waiting for the sensor.
+ *
+ * @date 16/10/2026
+ * @return True if the result of the sensor is ready.
+ */
+bool temperature_is_ready();
+
+/** Stores the current temperature & relative humidity, as measured by this
+ * board's sensor (or simulated values, depending on the
+ * {@code SIMULATE_TEMPERATURE_MEASUREMENTS} constant) in the
+ * {@link temperature} & {@link humidity} variables. It reads the result of the
+ * measurement started by {@link start_temperature_measurement()}, and only
+ * performs a new (blocking) measurement if none was started or the read failed.
  *
  * @date 20/01/2023
  */
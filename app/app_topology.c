@@ -0,0 +1,381 @@
+/***************************************************************************//**
+ * @file app_topology.c
+ * @brief Implementation file for the runtime topology of the system, stored in
+ * the user-data flash page of the board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_topology.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_msc.h"
+#include "app_log.h"
+#include "app_tdma.h"
+#include "app_path.h"
+#include "app_routing.h"
+#include "app_consensus.h"
+
+///Marks a valid topology record in the flash ("EDAS").
+#define TOPOLOGY_MAGIC 0x53414445UL
+
+///The version of the topology record. Increase it when the layout of {@link topology_record_t} changes.
+#define TOPOLOGY_VERSION 4
+
+/** The topology, as stored in the user-data flash page. Its size is a multiple
+ * of 4 bytes, since the flash is written in words.
+ * - magic: Equal to {@link TOPOLOGY_MAGIC} if the record is valid.
+ * - version: Equal to {@link TOPOLOGY_VERSION}.
+ * - board_id, num_of_boards, length_of_baton_path: See app_config.h.
+ * - graph: Bit j of graph[i] is set if graph[i][j] is true.
+ * - directed: Bit j of directed[i] is set if directed_graph[i][j] is true.
+ * - audible: Bit j of audible[i] is set if audible[i][j] is true.
+ * - baton_path: See app_config.h.
+ * - checksum: A CRC-32 of all previous fields.
+ */
+typedef struct {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t board_id;
+	uint8_t num_of_boards;
+	uint8_t length_of_baton_path;
+	uint32_t graph[MAX_NUM_OF_BOARDS];
+	uint32_t directed[MAX_NUM_OF_BOARDS];
+	uint32_t audible[MAX_NUM_OF_BOARDS];
+	int8_t baton_path[MAX_LENGTH_OF_BATON_PATH];
+	uint32_t checksum;
+} topology_record_t;
+
+/** Computes the CRC-32 (IEEE 802.3) of a buffer.
+ *
+ * @date 16/10/2026
+ * @param data The buffer.
+ * @param len The length of the buffer in bytes.
+ * @return The CRC-32 of the buffer.
+ */
+static uint32_t crc32(const uint8_t *data, size_t len){
+	uint32_t crc = 0xFFFFFFFFUL;
+	for(size_t i=0;i<len;i++){
+		crc ^= data[i];
+		for(int b=0;b<8;b++)
+			crc = (crc >> 1) ^ (0xEDB88320UL & (-(crc & 1)));
+	}
+	return ~crc;
+}
+
+/** Checks whether a topology obeys the rules of app_config.h, and prints the
+ * reason if it does not.
+ *
+ * @date 16/10/2026
+ * @param id The identity of the current board.
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param d The graph with the one-way links (see {@link directed_graph}).
+ * @param a The boards which hear each other (see {@link audible}).
+ * @param len The length of the baton path.
+ * @param path The baton path.
+ * @return True if the topology is valid, false otherwise.
+ */
+static bool validate_topology(uint8_t id, uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], uint8_t len, const int8_t *path){
+	int max_boards = USE_SHARED_CHANNEL || USE_ADDRESS_FILTER || MAX_NUM_OF_BOARDS<NUM_OF_RADIO_CHANNELS ? MAX_NUM_OF_BOARDS : NUM_OF_RADIO_CHANNELS; //One channel per board, otherwise
+	if(boards<2 || boards>max_boards){
+		app_log_error("Error. The number of boards has to be between 2 and %d.\n", max_boards);
+		return false;
+	}
+	if(id>=boards){
+		app_log_error("Error. The identity of the board has to be between 0 and %d.\n", boards-1);
+		return false;
+	}
+	if(len<2 || len>MAX_LENGTH_OF_BATON_PATH){
+		app_log_error("Error. The length of the baton path has to be between 2 and %d.\n", MAX_LENGTH_OF_BATON_PATH);
+		return false;
+	}
+	for(int i=0;i<boards;i++){
+		for(int j=0;j<boards;j++){
+			if(g[i][j]!=g[j][i] || (i==j && !g[i][j])){
+				app_log_error("Error. The graph has to be symmetric, with graph[i][i] true for any board.\n");
+				return false;
+			}
+			if(g[i][j] && !d[i][j]){
+				app_log_error("Error. The one-way links have to include the graph.\n");
+				return false;
+			}
+			if(a[i][j]!=a[j][i] || (d[i][j] && !a[i][j])){
+				app_log_error("Error. The audible boards have to be symmetric, and include the graph and the one-way links.\n");
+				return false;
+			}
+		}
+	}
+
+	bool visited[MAX_NUM_OF_BOARDS] = { false };
+	for(int i=0;i<len;i++){
+		int cur = path[i], next = path[(i+1)%len];
+		if(cur<0 || cur>=boards){
+			app_log_error("Error. Board %d of the baton path does not exist.\n", cur);
+			return false;
+		}
+		visited[cur] = true;
+		if(cur==next || !g[cur][next]){ //RULES 2 & 3
+			app_log_error("Error. The baton cannot be passed from board %d to board %d.\n", cur, next);
+			return false;
+		}
+		for(int k=0;k<i;k++){ //RULE 4
+			if(path[(k+len-1)%len]==path[(i+len-1)%len] && path[k]==cur && path[(k+1)%len]!=next){
+				app_log_error("Error. Board %d cannot determine where to send the baton received from board %d.\n", cur, path[(i+len-1)%len]);
+				return false;
+			}
+		}
+	}
+	for(int i=0;i<boards;i++){ //RULE 1
+		if(!visited[i]){
+			app_log_error("Error. Board %d is not included in the baton path.\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Makes a topology the current one, and computes its routing table (see
+ * app_routing.h).
+ *
+ * @date 16/10/2026
+ * @param id The identity of the current board.
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param d The graph with the one-way links.
+ * @param a The boards which hear each other.
+ * @param len The length of the baton path.
+ * @param path The baton path.
+ */
+static void apply_topology(uint8_t id, uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], uint8_t len, const int8_t *path){
+	board_id = id;
+	num_of_boards = boards;
+	length_of_baton_path = len;
+	memset(graph, 0, sizeof(graph));
+	memset(directed_graph, 0, sizeof(directed_graph));
+	memset(audible, 0, sizeof(audible));
+	for(int i=0;i<boards;i++){
+		for(int j=0;j<boards;j++){
+			graph[i][j] = g[i][j];
+			directed_graph[i][j] = d[i][j];
+			audible[i][j] = a[i][j];
+		}
+	}
+	memset(baton_path, 0, sizeof(baton_path));
+	memcpy(baton_path, path, len);
+	initialize_routing();
+	forget_consensus_result(); //The result of the last run belongs to the previous topology
+}
+
+/*******************************************************************************
+ * Loads the topology from the flash, or the default one.
+ ******************************************************************************/
+bool load_topology(){
+	const topology_record_t *rec = (const topology_record_t *) USERDATA_BASE;
+	static bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+
+	if(rec->magic==TOPOLOGY_MAGIC && rec->version==TOPOLOGY_VERSION
+			&& rec->checksum==crc32((const uint8_t *) rec, offsetof(topology_record_t, checksum))){
+		for(int i=0;i<MAX_NUM_OF_BOARDS;i++){
+			for(int j=0;j<MAX_NUM_OF_BOARDS;j++){
+				g[i][j] = (rec->graph[i] >> j) & 1;
+				d[i][j] = (rec->directed[i] >> j) & 1;
+				a[i][j] = (rec->audible[i] >> j) & 1;
+			}
+		}
+		if(validate_topology(rec->board_id, rec->num_of_boards, g, d, a, rec->length_of_baton_path, rec->baton_path)){
+			apply_topology(rec->board_id, rec->num_of_boards, g, d, a, rec->length_of_baton_path, rec->baton_path);
+			return true;
+		}
+		app_log_warning("The topology stored in the flash is invalid. The default one will be used.\n");
+	}
+
+	for(int i=0;i<DEFAULT_NUM_OF_BOARDS;i++)
+		for(int j=0;j<DEFAULT_NUM_OF_BOARDS;j++)
+			g[i][j] = default_graph[i][j];
+	int8_t p[MAX_LENGTH_OF_BATON_PATH];
+	uint8_t len = USE_AUTO_BATON_PATH ? generate_baton_path(DEFAULT_NUM_OF_BOARDS, g, p) : 0;
+	if(len)
+		apply_topology(DEFAULT_BOARD_ID, DEFAULT_NUM_OF_BOARDS, g, g, g, len, p);
+	else
+		apply_topology(DEFAULT_BOARD_ID, DEFAULT_NUM_OF_BOARDS, g, g, g, DEFAULT_LENGTH_OF_BATON_PATH, default_baton_path);
+	return false;
+}
+
+/** Parses the edges of a graph from a comma-separated list of pairs (e.g.,
+ * "0-1,1-2"), where a pair "a>b" is a one-way link, over which board b receives
+ * the messages of board a only (e.g., "0-1,1-2,2>0").
+ *
+ * @date 16/10/2026
+ * @param str The list.
+ * @param boards The total number of boards.
+ * @param g The graph where the edges are stored (graph[i][i] is always set).
+ * @param d The graph where the edges and the one-way links are stored (see {@link directed_graph}).
+ * @return True if the list was parsed successfully, false otherwise.
+ */
+static bool parse_edges(const char *str, uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	memset(g, 0, sizeof(bool)*MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS);
+	memset(d, 0, sizeof(bool)*MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS);
+	for(int i=0;i<boards;i++)
+		g[i][i] = d[i][i] = true;
+	while(*str){
+		char *end;
+		long a = strtol(str, &end, 10);
+		if(end==str || (*end!='-' && *end!='>'))
+			return false;
+		bool one_way = *end=='>';
+		str = end+1;
+		long b = strtol(str, &end, 10);
+		if(end==str || a<0 || b<0 || a>=boards || b>=boards)
+			return false;
+		d[b][a] = true;
+		if(!one_way)
+			g[a][b] = g[b][a] = d[a][b] = true;
+		str = end;
+		if(*str==',')
+			str++;
+		else if(*str)
+			return false;
+	}
+	return true;
+}
+
+/** Parses the baton path from a comma-separated list of boards (e.g., "3,2,1,0").
+ *
+ * @date 16/10/2026
+ * @param str The list.
+ * @param path The array where the path is stored.
+ * @param len Where the length of the path is stored.
+ * @return True if the list was parsed successfully, false otherwise.
+ */
+static bool parse_path(const char *str, int8_t *path, uint8_t *len){
+	*len = 0;
+	while(*str){
+		char *end;
+		long b = strtol(str, &end, 10);
+		if(end==str || b<0 || b>=MAX_NUM_OF_BOARDS || *len==MAX_LENGTH_OF_BATON_PATH)
+			return false;
+		path[(*len)++] = (int8_t) b;
+		str = end;
+		if(*str==',')
+			str++;
+		else if(*str)
+			return false;
+	}
+	return true;
+}
+
+/** Validates a topology, stores it to the flash and applies it.
+ *
+ * @date 16/10/2026
+ * @param id The identity of the current board.
+ * @param boards The total number of boards.
+ * @param g The graph.
+ * @param d The graph with the one-way links.
+ * @param a The boards which hear each other.
+ * @param len The length of the baton path.
+ * @param path The baton path.
+ * @return True if the topology is valid and was stored, false otherwise.
+ */
+static bool store_topology(uint8_t id, uint8_t boards, bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], uint8_t len, const int8_t *path){
+	static topology_record_t rec;
+	if(!validate_topology(id, boards, g, d, a, len, path))
+		return false;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = TOPOLOGY_MAGIC;
+	rec.version = TOPOLOGY_VERSION;
+	rec.board_id = id;
+	rec.num_of_boards = boards;
+	rec.length_of_baton_path = len;
+	for(int i=0;i<boards;i++){
+		for(int j=0;j<boards;j++){
+			if(g[i][j])
+				rec.graph[i] |= 1UL << j;
+			if(d[i][j])
+				rec.directed[i] |= 1UL << j;
+			if(a[i][j])
+				rec.audible[i] |= 1UL << j;
+		}
+	}
+	memcpy(rec.baton_path, path, len);
+	rec.checksum = crc32((const uint8_t *) &rec, offsetof(topology_record_t, checksum));
+
+	MSC_Init();
+	MSC_Status_TypeDef status = MSC_ErasePage((uint32_t *) USERDATA_BASE);
+	if(status==mscReturnOk)
+		status = MSC_WriteWord((uint32_t *) USERDATA_BASE, &rec, sizeof(rec));
+	MSC_Deinit();
+	if(status!=mscReturnOk){
+		app_log_error("Error. The topology could not be written to the flash (MSC status %d).\n", status);
+		return false;
+	}
+
+	apply_topology(id, boards, g, d, a, len, path);
+	return true;
+}
+
+/*******************************************************************************
+ * Validates, applies and stores a topology.
+ ******************************************************************************/
+bool provision_topology(uint8_t id, uint8_t boards, const char *edges, const char *path){
+	static bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	int8_t p[MAX_LENGTH_OF_BATON_PATH];
+	uint8_t len;
+
+	if(boards>MAX_NUM_OF_BOARDS || !parse_edges(edges, boards, g, d)){
+		app_log_error("Error. Invalid list of edges '%s' (expected e.g. \"0-1,1-2\" or \"0-1,1-2,2>0\").\n", edges);
+		return false;
+	}
+	if(strcmp(path, "auto")==0){
+		len = generate_baton_path(boards, g, p);
+		if(!len){
+			app_log_error("Error. The baton path cannot be generated, since the graph is not connected.\n");
+			return false;
+		}
+	}
+	else if(!parse_path(path, p, &len)){
+		app_log_error("Error. Invalid baton path '%s' (expected e.g. \"0,1,2,1\" or \"auto\").\n", path);
+		return false;
+	}
+	for(int i=0;i<MAX_NUM_OF_BOARDS;i++) //only the edges of the graph and the one-way links are known to be audible
+		for(int j=0;j<MAX_NUM_OF_BOARDS;j++)
+			a[i][j] = d[i][j] || d[j][i];
+	return store_topology(id, boards, g, d, a, len, p);
+}
+
+/*******************************************************************************
+ * Validates, applies and stores a graph, with its generated baton path.
+ ******************************************************************************/
+bool provision_graph(bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	int8_t p[MAX_LENGTH_OF_BATON_PATH];
+	uint8_t len = generate_baton_path(num_of_boards, g, p);
+	if(!len){
+		app_log_error("Error. The baton path cannot be generated, since the graph is not connected.\n");
+		return false;
+	}
+	return store_topology(board_id, num_of_boards, g, d, a, len, p);
+}
+
+/*******************************************************************************
+ * Prints the current topology.
+ ******************************************************************************/
+void print_topology(){
+	app_log_info("  Board id:     %d (of %d boards)\n", board_id, num_of_boards);
+	app_log_info("  Graph:        ");
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=i+1;j<num_of_boards;j++)
+			if(graph[i][j])
+				app_log_info("%d-%d ", i, j);
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=0;j<num_of_boards;j++)
+			if(directed_graph[j][i] && !graph[i][j])
+				app_log_info("%d>%d ", i, j);
+	app_log_info("\n  Baton path:   ");
+	for(int i=0;i<length_of_baton_path;i++)
+		app_log_info("%d ", baton_path[i]);
+	app_log_info("\n");
+	print_routes();
+	if(USE_TDMA)
+		app_log_info("  TDMA slot:    %d (of %d slots)\n", tdma_slots[board_id], tdma_num_of_slots);
+}
@@ -0,0 +1,59 @@
+/***************************************************************************//**
+ * @file app_topology.h
+ * @brief Header file for the runtime topology of the system (identity of the
+ * board, graph and baton path), stored in the user-data flash page.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_TOPOLOGY_H
+#define APP_TOPOLOGY_H
+
+#include "rail_types.h"
+#include "app_config.h"
+
+/** Loads the topology of the system into {@link board_id}, {@link num_of_boards},
+ * {@link graph}, {@link directed_graph}, {@link audible}, {@link length_of_baton_path} and {@link baton_path}. If the
+ * user-data flash page contains a valid topology (i.e., the board has been
+ * provisioned), it is used. Otherwise, the defaults of app_config.h are used.
+ *
+ * @date 16/10/2026
+ * @return True if the topology was loaded from the flash, false if the defaults were used.
+ */
+bool load_topology();
+
+/** Validates a topology, applies it and stores it to the user-data flash page,
+ * so that it is loaded at every boot from now on.
+ *
+ * @date 16/10/2026
+ * @param id The identity of the current board.
+ * @param boards The total number of boards.
+ * @param edges The edges of the graph, as a comma-separated list of pairs of
+ * boards (e.g., "0-1,0-5,1-2"), and the one-way links (e.g., "2>5" if board 5
+ * receives the messages of board 2 only).
+ * @param path The baton path, as a comma-separated list of boards (e.g., "3,2,1,0"),
+ * or "auto" for the path generated from the graph (see app_path.h).
+ * @return True if the topology is valid and was stored, false otherwise (the
+ * current topology remains unchanged).
+ */
+bool provision_topology(uint8_t id, uint8_t boards, const char *edges, const char *path);
+
+/** Validates a graph of the current boards (e.g., as discovered, see
+ * app_discovery.h), generates its baton path (see app_path.h), applies the
+ * topology and stores it to the user-data flash page. The identity of the
+ * board and the number of boards remain unchanged.
+ *
+ * @date 16/10/2026
+ * @param g The graph.
+ * @param d The graph with the one-way links (see {@link directed_graph}).
+ * @param a The boards which hear each other (see {@link audible}), including the one-way links.
+ * @return True if the graph is valid (i.e., connected) and was stored, false
+ * otherwise (the current topology remains unchanged).
+ */
+bool provision_graph(bool g[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool d[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], bool a[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]);
+
+/** Prints the current topology to the console.
+ *
+ * @date 16/10/2026
+ */
+void print_topology();
+
+#endif  // APP_TOPOLOGY_H
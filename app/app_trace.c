@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ * @file app_trace.c
+ * @brief Implementation file for the trace of the system.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+
+#include "app_trace.h"
+#include <string.h>
+#include "rail.h"
+#include "app_log.h"
+#include "app_config.h"
+
+///The space where the records of the trace are stored.
+static trace_record_t records[TRACE_BUFFER_SIZE];
+
+///The position of the next record to be appended.
+static uint16_t head;
+
+///The number of records in the trace.
+static uint16_t count;
+
+///The number of records which were overwritten (when the trace was full) since the last dump.
+static uint16_t overwritten;
+
+///The hex digits, in the order of their values.
+static const char hex_digits[] = "0123456789ABCDEF";
+
+/*******************************************************************************
+ * Appends a record to the trace.
+ ******************************************************************************/
+void trace(trace_id_t id, uint16_t arg0, uint8_t arg1, float value){
+	trace_record_t *record = &records[head];
+	record->time = RAIL_GetTime();
+	record->id = id;
+	record->arg0 = arg0;
+	record->arg1 = arg1;
+	record->value = value;
+	if(!USE_TRACE){ //The record is printed immediately
+		char text[160];
+		trace_to_text(record, text, sizeof(text));
+		app_log_info("%s", text);
+		return;
+	}
+	head = (head+1) & (TRACE_BUFFER_SIZE-1);
+	if(count<TRACE_BUFFER_SIZE)
+		count++;
+	else
+		overwritten++;
+}
+
+/*******************************************************************************
+ * Prints all the records of the trace to the console.
+ ******************************************************************************/
+void dump_trace(){
+	if(count==0)
+		return;
+	if(overwritten>0)
+		app_log_info("The %d oldest records of the trace were overwritten.\n", overwritten);
+	char digits[TRACE_LINE_DIGITS+1];
+	for(uint16_t i=(head-count) & (TRACE_BUFFER_SIZE-1); count>0; i=(i+1) & (TRACE_BUFFER_SIZE-1), count--){
+		encode_trace_record(&records[i], digits);
+		app_log_info(TRACE_LINE_PREFIX "%s\n", digits);
+	}
+	overwritten = 0;
+}
+
+/*******************************************************************************
+ * Converts a record to text.
+ ******************************************************************************/
+void trace_to_text(const trace_record_t *record, char *text, size_t size){
+	switch(record->id){
+	case TRACE_BATON_RECEIVED:
+		snprintf(text, size, "                              Received BATON %d! %d boards have reached to a result under the threshold.\n", record->arg0, record->arg1);
+		break;
+	case TRACE_BATON_RELEASED:
+		snprintf(text, size, "                              Released BATON %d! %d boards have reached to a result under the threshold.\n", record->arg0, record->arg1);
+		break;
+	case TRACE_ITERATION_STARTED:
+		snprintf(text, size, "=========================================================\nIteration %d:\n   - Now sending my state to my neighbors.\n", record->arg0);
+		break;
+	case TRACE_STATE_UPDATED:
+		snprintf(text, size, "   - Now updating my state, to %f.\n", record->value);
+		break;
+	case TRACE_BELOW_THRESHOLD:
+		snprintf(text, size, "     This board has reached to a value below the threshold, and it agrees for the algorithm to be terminated.\n");
+		break;
+	case TRACE_ABOVE_THRESHOLD:
+		snprintf(text, size, "     This board is no longer below the threshold, and it does NOT agree for the algorithm to be terminated.\n");
+		break;
+	case TRACE_FRAME_UPDATE:
+		snprintf(text, size, "Iteration %d: my state is now %f (quiet for %d frames).\n", record->arg0, record->value, record->arg1);
+		break;
+	case TRACE_TERMINATED:
+		snprintf(text, size, "     All boards have reached a value below the threshold, and the algorithm is terminated.\n");
+		break;
+	default:
+		snprintf(text, size, "Unknown trace record %d.\n", record->id);
+		break;
+	}
+}
+
+/*******************************************************************************
+ * Encodes a record as hex digits.
+ ******************************************************************************/
+void encode_trace_record(const trace_record_t *record, char *digits){
+	uint32_t value;
+	memcpy(&value, &record->value, sizeof(value));
+	uint8_t bytes[TRACE_LINE_DIGITS/2] = {
+		record->time, record->time >> 8, record->time >> 16, record->time >> 24,
+		record->id, record->arg1, record->arg0, record->arg0 >> 8,
+		value, value >> 8, value >> 16, value >> 24
+	};
+	for(int i=0;i<TRACE_LINE_DIGITS/2;i++){
+		digits[2*i] = hex_digits[bytes[i] >> 4];
+		digits[2*i+1] = hex_digits[bytes[i] & 0xF];
+	}
+	digits[TRACE_LINE_DIGITS] = '\0';
+}
+
+/*******************************************************************************
+ * Decodes a record from hex digits.
+ ******************************************************************************/
+bool decode_trace_record(const char *digits, trace_record_t *record){
+	uint8_t bytes[TRACE_LINE_DIGITS/2];
+	for(int i=0;i<TRACE_LINE_DIGITS;i++){
+		const char *digit = digits[i] ? strchr(hex_digits, digits[i]) : NULL;
+		if(digit==NULL)
+			return false;
+		if(i%2==0)
+			bytes[i/2] = (digit-hex_digits) << 4;
+		else
+			bytes[i/2] |= digit-hex_digits;
+	}
+	uint32_t value = bytes[8] | (uint32_t) bytes[9] << 8 | (uint32_t) bytes[10] << 16 | (uint32_t) bytes[11] << 24;
+	record->time = bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+	record->id = bytes[4];
+	record->arg1 = bytes[5];
+	record->arg0 = bytes[6] | bytes[7] << 8;
+	memcpy(&record->value, &value, sizeof(value));
+	return true;
+}
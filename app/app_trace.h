@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file app_trace.h
+ * @brief Header file for the trace of the system: a ring buffer of compact
+ * binary records, which replaces the formatted console messages of the
+ * iterations of Average Consensus (e.g., every received & released baton).
+ * Writing a record takes a few cycles, while formatting the same message and
+ * sending it over the console UART takes milliseconds. The records are dumped
+ * to the console (in hex) when the board goes to sleep, or on demand with the
+ * 'trace' CLI command, and host/trace_decode renders them as text.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_TRACE_H
+#define APP_TRACE_H
+
+#include <stddef.h>
+#include "rail_types.h"
+
+///The capacity of the trace, in records (a power of 2). When it is full, the oldest records are overwritten.
+#define TRACE_BUFFER_SIZE 256
+
+///The prefix of a dumped record in the console output.
+#define TRACE_LINE_PREFIX "TRC:"
+
+///The length of a dumped record in hex digits (after the {@link TRACE_LINE_PREFIX}).
+#define TRACE_LINE_DIGITS 24
+
+/** The types of the records (with the meaning of their arguments).
+* - TRACE_BATON_RECEIVED: The baton was received (arg0: the baton counter, arg1: the boards which are below the threshold).
+* - TRACE_BATON_RELEASED: The baton was released (arg0: the baton counter, arg1: the boards which are below the threshold).
+* - TRACE_ITERATION_STARTED: This board sends its state to its neighbors (arg0: the iteration).
+* - TRACE_STATE_UPDATED: This board updated its state (value: the temperature of the new state).
+* - TRACE_BELOW_THRESHOLD: This board agrees for the algorithm to be terminated.
+* - TRACE_ABOVE_THRESHOLD: This board no longer agrees for the algorithm to be terminated.
+* - TRACE_FRAME_UPDATE: This board updated its state at the start of a TDMA frame (arg0: the iteration, arg1: the quiet frames, value: the temperature of the new state).
+* - TRACE_TERMINATED: All boards are below the threshold (in TDMA mode), and the algorithm is terminated.
+*/
+typedef enum {
+	TRACE_BATON_RECEIVED,
+	TRACE_BATON_RELEASED,
+	TRACE_ITERATION_STARTED,
+	TRACE_STATE_UPDATED,
+	TRACE_BELOW_THRESHOLD,
+	TRACE_ABOVE_THRESHOLD,
+	TRACE_FRAME_UPDATE,
+	TRACE_TERMINATED
+} trace_id_t;
+
+///A record of the trace (12 bytes).
+typedef struct {
+	RAIL_Time_t time; ///< The time of the record (in the RAIL time of this board).
+	uint8_t id;       ///< The type of the record (see {@link trace_id_t}).
+	uint8_t arg1;     ///< A small argument (e.g., a number of boards).
+	uint16_t arg0;    ///< An argument (e.g., a counter).
+	float value;      ///< A state of Average Consensus.
+} trace_record_t;
+
+/** Appends a record to the trace. If {@link USE_TRACE} equals to 0, the record
+ * is printed to the console immediately instead (as text).
+ *
+ * @date 16/10/2026
+ * @param id The type of the record.
+ * @param arg0 The first argument of the record.
+ * @param arg1 The second argument of the record.
+ * @param value The state of the record.
+ */
+void trace(trace_id_t id, uint16_t arg0, uint8_t arg1, float value);
+
+/** Prints all the records of the trace to the console, one per line (the
+ * {@link TRACE_LINE_PREFIX} and {@link TRACE_LINE_DIGITS} hex digits), and
+ * empties the trace. It does nothing if the trace is empty.
+ *
+ * @date 16/10/2026
+ */
+void dump_trace();
+
+/** Converts a record to the message which was printed to the console before
+ * the trace was introduced.
+ *
+ * @date 16/10/2026
+ * @param record The record.
+ * @param text The buffer of the message.
+ * @param size The size of the buffer.
+ */
+void trace_to_text(const trace_record_t *record, char *text, size_t size);
+
+/** Encodes a record as hex digits (the format of {@link dump_trace()}).
+ *
+ * @date 16/10/2026
+ * @param record The record.
+ * @param digits A buffer for {@link TRACE_LINE_DIGITS} digits and a null terminator.
+ */
+void encode_trace_record(const trace_record_t *record, char *digits);
+
+/** Decodes a record from hex digits (the format of {@link dump_trace()}).
+ *
+ * @date 16/10/2026
+ * @param digits At least {@link TRACE_LINE_DIGITS} hex digits.
+ * @param record The decoded record.
+ * @return True if the digits are a valid record.
+ */
+bool decode_trace_record(const char *digits, trace_record_t *record);
+
+#endif  // APP_TRACE_H
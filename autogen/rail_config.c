@@ -103,9 +103,9 @@ const uint32_t Backscatter_receiver_modemConfigBase[] = {
   /*    1FF4 */ 0x00000000UL,
   /*    1FF8 */ (uint32_t) &phyInfo,
   /*    1FFC */ 0x00000000UL,
-  0x00020004UL, 0x00000000UL,
-  /*    0008 */ 0x00000000UL,
-  0x00020018UL, 0x0000000FUL,
+  0x00020004UL, 0x00048001UL,
+  /*    0008 */ 0x00000011UL,
+  0x00020018UL, 0x00000000UL,
   /*    001C */ 0x00000000UL,
   0x00070028UL, 0x00000000UL,
   /*    002C */ 0x00000000UL,
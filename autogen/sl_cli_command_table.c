@@ -29,6 +29,71 @@ void cli_info(sl_cli_command_arg_t *arguments);
  */
 void cli_avg_consensus(sl_cli_command_arg_t *arguments);
 
+/** CLI - gossip: Wakes up the system and starts the execution of Average
+ * Consensus with pairwise exchanges between random neighbors (randomized
+ * gossip), without the baton.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_gossip(sl_cli_command_arg_t *arguments);
+
+/** CLI - track: Wakes up the system and starts the tracking of the average,
+ * i.e., the randomized gossip over the changing readings of the boards, or
+ * stops it if it is running.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_track(sl_cli_command_arg_t *arguments);
+
+/** CLI - provision: Stores the identity of the board and the topology of the
+ * system to the flash, and applies them immediately.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (board id, number of boards, edges of the graph, baton path).
+ */
+void cli_provision(sl_cli_command_arg_t *arguments);
+
+/** CLI - discover: Wakes up the system and discovers the graph from the
+ * links measured by the boards, which becomes the topology of all boards.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_discover(sl_cli_command_arg_t *arguments);
+
+/** CLI - topology: Prints the identity of the board and the topology of the
+ * system to the console.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_topology(sl_cli_command_arg_t *arguments);
+
+/** CLI - trace: Prints the records of the trace of the board to the console,
+ * and empties the trace.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_trace(sl_cli_command_arg_t *arguments);
+
+/** CLI - energy: Prints the energy estimate of the current (or the last) run of
+ * the board to the console.
+ *
+ * @date 16/10/2026
+ * @param arguments A pointer to the arguments provided by the user through the
+ * console (no arguments should be provided for this command).
+ */
+void cli_energy(sl_cli_command_arg_t *arguments);
+
 
 ///This struct determines the exact syntax of the 'info' CLI command.
 static const sl_cli_command_info_t cli_cmd__info = \
@@ -44,10 +109,66 @@ static const sl_cli_command_info_t cli_cmd__average = \
                   "",
                  {SL_CLI_ARG_END, });
 
+///This struct determines the exact syntax of the 'gossip' CLI command.
+static const sl_cli_command_info_t cli_cmd__gossip = \
+  SL_CLI_COMMAND(cli_gossip,
+                 "Starts the execution of Average Consensus with randomized gossip (pairwise exchanges without the baton) and returns the average temperature of the system.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'track' CLI command.
+static const sl_cli_command_info_t cli_cmd__track = \
+  SL_CLI_COMMAND(cli_track,
+                 "Starts the tracking of the average temperature of the system (then 'average' returns it instantly), or stops it if it is running.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'provision' CLI command.
+static const sl_cli_command_info_t cli_cmd__provision = \
+  SL_CLI_COMMAND(cli_provision,
+                 "Stores the identity of this Thunderboard and the topology of the system to the flash, e.g. provision 3 6 0-1,0-5,1-2,1-5,2-3,4-5 3,2,1,0,5,4,5,1,2",
+                  "Board id\x1F" "Number of boards\x1F" "Edges of the graph\x1F" "Baton path (or auto)\x1F",
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_UINT8, SL_CLI_ARG_STRING, SL_CLI_ARG_STRING, SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'discover' CLI command.
+static const sl_cli_command_info_t cli_cmd__discover = \
+  SL_CLI_COMMAND(cli_discover,
+                 "Measures the links between the Thunderboards, and stores the discovered graph (with its baton path) to the flash of every board.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'topology' CLI command.
+static const sl_cli_command_info_t cli_cmd__topology = \
+  SL_CLI_COMMAND(cli_topology,
+                 "Prints the identity of this Thunderboard and the topology of the system.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'trace' CLI command.
+static const sl_cli_command_info_t cli_cmd__trace = \
+  SL_CLI_COMMAND(cli_trace,
+                 "Prints the trace of this Thunderboard (to be rendered by host/trace_decode) and empties it.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+///This struct determines the exact syntax of the 'energy' CLI command.
+static const sl_cli_command_info_t cli_cmd__energy = \
+  SL_CLI_COMMAND(cli_energy,
+                 "Prints the time in every energy mode, the time of the radio and the estimated charge of the current (or the last) run, and the retransmissions of the link layer.",
+                  "",
+                 {SL_CLI_ARG_END, });
+
 ///This table determines the commands to be used in the CLI.
 const sl_cli_command_entry_t sl_cli_default_command_table[] = {
   { "info", &cli_cmd__info, false },
   { "average", &cli_cmd__average, false },
+  { "gossip", &cli_cmd__gossip, false },
+  { "track", &cli_cmd__track, false },
+  { "provision", &cli_cmd__provision, false },
+  { "discover", &cli_cmd__discover, false },
+  { "topology", &cli_cmd__topology, false },
+  { "trace", &cli_cmd__trace, false },
+  { "energy", &cli_cmd__energy, false },
   { NULL, NULL, false }
 };
 
@@ -5,7 +5,10 @@
  ******************************************************************************/
 #include "app_config.h"
 
-bool graph[NUM_OF_BOARDS][NUM_OF_BOARDS] = {
+/*******************************************************************************
+ * The default graph, used by a board which has not been provisioned yet.
+ ******************************************************************************/
+const bool default_graph[DEFAULT_NUM_OF_BOARDS][DEFAULT_NUM_OF_BOARDS] = {
     {true,  true,  false, false, false, true},
     {true,  true,  true,  false, false, true},
     {false, true,  true,  true,  false, false},
@@ -13,6 +16,19 @@ bool graph[NUM_OF_BOARDS][NUM_OF_BOARDS] = {
     {false, false, false, false, true,  true},
     {true,  true,  false, false, true,  true}};
 
+/*******************************************************************************
+ * The precomputed weights of the default graph (the fastest-mixing weights
+ * reported by host/spectral_gap), used when CONSENSUS_WEIGHTS equals to
+ * WEIGHTS_CONFIGURED. Only the weights of the edges are used.
+ ******************************************************************************/
+const float default_weights[DEFAULT_NUM_OF_BOARDS][DEFAULT_NUM_OF_BOARDS] = {
+    {0.0000, 0.3677, 0.0000, 0.0000, 0.0000, 0.4029},
+    {0.3677, 0.0000, 0.5001, 0.0000, 0.0000, 0.3104},
+    {0.0000, 0.5001, 0.0000, 0.4999, 0.0000, 0.0000},
+    {0.0000, 0.0000, 0.4999, 0.0000, 0.0000, 0.0000},
+    {0.0000, 0.0000, 0.0000, 0.0000, 0.0000, 0.4997},
+    {0.4029, 0.3104, 0.0000, 0.0000, 0.4997, 0.0000}};
+
 /*******************************************************************************
  * RULE 1: The path should include all nodes at least once.
  * RULE 2: Every node should have an edge (according to the graph) with its previous and next.
@@ -21,7 +37,16 @@ bool graph[NUM_OF_BOARDS][NUM_OF_BOARDS] = {
  * the node from which it was received. For example, sequences like ...1,2,3... and ...1,2,4...
  * should not exist in the same path.
  ******************************************************************************/
-int8_t baton_path[LENGTH_OF_BATON_PATH] = {3, 2, 1, 0, 5, 4, 5, 1, 2};
+const int8_t default_baton_path[DEFAULT_LENGTH_OF_BATON_PATH] = {3, 2, 1, 0, 5, 4, 5, 1, 2};
+
+//The runtime topology, loaded at boot by load_topology() (see app_topology.h).
+uint8_t board_id;
+uint8_t num_of_boards;
+bool graph[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+bool directed_graph[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+bool audible[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+uint8_t length_of_baton_path;
+int8_t baton_path[MAX_LENGTH_OF_BATON_PATH];
 
 /*******************************************************************************
  * When |state-previous_state|<=STOP_THRESHOLD for every board, then the
@@ -29,9 +54,15 @@ int8_t baton_path[LENGTH_OF_BATON_PATH] = {3, 2, 1, 0, 5, 4, 5, 1, 2};
  ******************************************************************************/
 const float STOP_THRESHOLD = 0.1;
 
-///This array contains some pre-specified temperatures, to be used instead of the actual ones, when {@link SIMULATE_TEMPERATURE_MEASUREMENTS} equals to 1.
 /*******************************************************************************
  * This array contains some pre-specified temperatures, to be used instead of
  * the actual ones, when {@link SIMULATE_TEMPERATURE_MEASUREMENTS} equals to 1.
  ******************************************************************************/
-const float simulated_temperatures[NUM_OF_BOARDS] = {10, 20, 30, 20, 15, 25};
+const float simulated_temperatures[MAX_NUM_OF_BOARDS] = {10, 20, 30, 20, 15, 25};
+
+/*******************************************************************************
+ * This array contains some pre-specified relative humidities, to be used
+ * instead of the actual ones, when {@link SIMULATE_TEMPERATURE_MEASUREMENTS}
+ * equals to 1.
+ ******************************************************************************/
+const float simulated_humidities[MAX_NUM_OF_BOARDS] = {40, 55, 60, 45, 50, 35};
@@ -9,21 +9,63 @@
 #include <stdio.h>
 #include <rail_types.h>
 
-///The identity (also defining the RX channel) of the current board.
-#define BOARD_ID 0
+//---------------------------Grid topology constants----------------------------
+///The maximum number of boards. It is limited by the bitmasks of 32 bits which carry a set of boards (e.g., the links of a board, see app_codec.h). If every board receives on its own channel ({@link USE_SHARED_CHANNEL} and {@link USE_ADDRESS_FILTER} equal to 0), the boards are also limited to the {@link NUM_OF_RADIO_CHANNELS}.
+#define MAX_NUM_OF_BOARDS 32
 
+///The number of channels of the radio configuration (0 to 20, see autogen/rail_config.c).
+#define NUM_OF_RADIO_CHANNELS 21
+
+///The maximum length of the {@link baton_path} array.
+#define MAX_LENGTH_OF_BATON_PATH 64
+
+/* The following values are the defaults, used by a board which has not been
+ * provisioned yet (see the 'provision' CLI command). A provisioned board reads
+ * its identity and the topology from its user-data flash page at boot. */
+
+///The default identity (also defining the RX channel, if every board receives on its own channel) of the current board. It can be overridden from the compiler's command line (e.g., -DDEFAULT_BOARD_ID=3), as the host simulator does for every simulated board.
+#ifndef DEFAULT_BOARD_ID
+#define DEFAULT_BOARD_ID 0
+#endif
+
+///The default (exact) total number of boards.
+#define DEFAULT_NUM_OF_BOARDS 6
+
+///The exact size of the {@link default_baton_path} array.
+#define DEFAULT_LENGTH_OF_BATON_PATH 9
+
+///The default graph (see {@link graph}).
+extern const bool default_graph[DEFAULT_NUM_OF_BOARDS][DEFAULT_NUM_OF_BOARDS];
+
+///The precomputed weights of the default graph, used when {@link CONSENSUS_WEIGHTS} equals to {@link WEIGHTS_CONFIGURED}. default_weights[i][j] is the weight of the state of board j in the update of board i (the weights of the boards themselves are not used, as every row is completed to sum to 1).
+extern const float default_weights[DEFAULT_NUM_OF_BOARDS][DEFAULT_NUM_OF_BOARDS];
+
+///The default baton path (see {@link baton_path}).
+extern const int8_t default_baton_path[DEFAULT_LENGTH_OF_BATON_PATH];
+
+///Set to 1 for a board which has not been provisioned to generate the baton path from the {@link default_graph} at boot (see app_path.h), instead of using the {@link default_baton_path}. Every board generates the same path from the same graph. Set to 0 for the default_baton_path (a provisioned board uses its provisioned path, which can also be generated, see the 'provision' CLI command).
+#define USE_AUTO_BATON_PATH 1
+
+//------------------------Runtime topology (provisioned)------------------------
+///The identity (also defining the RX channel, if every board receives on its own channel) of the current board.
+extern uint8_t board_id;
 
-//---------------------------Grid topology constants----------------------------
 ///The (exact) total number of boards.
-#define NUM_OF_BOARDS 6
+extern uint8_t num_of_boards;
+
+///This graph specifies the commuting boards. graph[i][j] is true if board i can send/receive messages from board j, or false otherwise. Also, graph[i][i] is true for any board. Only the first {@link num_of_boards} rows & columns are used.
+extern bool graph[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
 
-///This graph specifies the commuting boards. Set graph[i][j] true if board i can send/receive messages from board j, or false otherwise. Also, graph[i][i] has to be set true for any board.
-extern bool graph[NUM_OF_BOARDS][NUM_OF_BOARDS];
+///The links of the graph together with the one-way links, over which the states of push-sum are sent too (see {@link CONSENSUS_PUSH_SUM}). directed_graph[i][j] is true if board i receives the messages of board j, even if board j does not receive those of board i. It includes the graph, and it is equal to it unless one-way links were provisioned or discovered. Only the first {@link num_of_boards} rows & columns are used.
+extern bool directed_graph[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
 
-///The exact size of the {@link baton_path} array.
-#define LENGTH_OF_BATON_PATH 9
+///The boards which hear each other, even over a link which is too weak for the {@link graph} (see the 'discover' CLI command). audible[i][j] is true if board i hears board j or board j hears board i. It includes the {@link directed_graph}, and it is equal to the graph unless one-way links were provisioned or the graph was discovered. The TDMA schedule keeps such boards apart.
+extern bool audible[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
 
-/** A path inside the graph, which will be followed by the baton.
+///The exact length of the {@link baton_path}.
+extern uint8_t length_of_baton_path;
+
+/** A path inside the graph, which will be followed by the baton. Only the first {@link length_of_baton_path} elements are used.
  * - RULE 1: The path should include all nodes at least once.
  * - RULE 2: Every node should have an edge (according to the {@link graph}) with its previous and next.
  * - RULE 3: The last node of the cycle should have an edge with the first one.
@@ -31,22 +73,140 @@ extern bool graph[NUM_OF_BOARDS][NUM_OF_BOARDS];
  * the node from which it was received. For example, subsequences like ...1,2,3... and ...1,2,4...
  * should not both exist.
  */
-extern int8_t baton_path[LENGTH_OF_BATON_PATH];
+extern int8_t baton_path[MAX_LENGTH_OF_BATON_PATH];
 
 //---------Configuration of parameters related to the application---------------
 ///The minimum temperature that can be measured by the thermal sensor.
 #define MIN_TEMPERATURE -273
 
-///When |state-previous_state|<=STOP_THRESHOLD for every board, then the execution of the Average Consensus algorithm can be terminated.
+///The index of the temperature in the state of a board (see {@link NUM_OF_QUANTITIES}).
+#define QUANTITY_TEMPERATURE 0
+
+///The index of the relative humidity in the state of a board, which the sensor measures together with the temperature.
+#define QUANTITY_HUMIDITY 1
+
+///The number of quantities which are averaged together by every run ({@link QUANTITY_TEMPERATURE}, and {@link QUANTITY_HUMIDITY} if 2): the state of a board is a vector with one element per quantity, and every state message carries all of them, so that the quantities converge in the same iterations and messages. Every element adds 4 or 2 bytes to the messages with the state (see {@link STATE_ENCODING}). It has to be the same for all boards.
+#define NUM_OF_QUANTITIES 2
+
+#if NUM_OF_QUANTITIES < 1 || NUM_OF_QUANTITIES > 2
+#error "Only the temperature & the relative humidity are measured (see app_tools.h)."
+#endif
+
+///When |state-previous_state|<=STOP_THRESHOLD for every board (and every quantity of its state, see {@link NUM_OF_QUANTITIES}), then the execution of the Average Consensus algorithm can be terminated.
 extern const float STOP_THRESHOLD;
 
-///Set to 1 for the board's LEDs to indicate the EM transitions (awake or asleep). Set to 0 for deactivated LEDs.
+///The plain update rule of Average Consensus, x(k+1) = W x(k).
+#define CONSENSUS_FIRST_ORDER 0
+
+///The second-order (heavy-ball) update rule of Average Consensus, x(k+1) = b W x(k) + (1-b) x(k-1), with b computed from the {@link graph}.
+#define CONSENSUS_SECOND_ORDER 1
+
+///The Chebyshev-accelerated update rule of Average Consensus, x(k+1) = c(k) (W x(k) - x(k-1)) + x(k-1), with c(k) computed from the {@link graph}.
+#define CONSENSUS_CHEBYSHEV 2
+
+///The plain update rule of Average Consensus, after which every board computes the exact average from its first states (minimal-polynomial extrapolation). The algorithm then stops after a fixed number of iterations, which depends only on the {@link graph} (at most {@link num_of_boards}), instead of waiting for the {@link STOP_THRESHOLD}. The last iteration verifies that the neighbors computed the same average; if they did not (i.e., messages were lost), the boards continue with the plain update until the {@link STOP_THRESHOLD}.
+#define CONSENSUS_FINITE_TIME 3
+
+///The push-sum (ratio consensus) update rule: every board keeps a sum & a weight (initially its temperature & 1), keeps a share 1/(d+1) of both and pushes a share to each of the d boards which receive it (according to the {@link directed_graph}), and its state is the ratio of its sum to its weight. The shares are sent as running sums, so that a lost message is made up by the next one. It uses the one-way links too, which the other rules cannot use (their weights need a symmetric graph), while the baton still follows the {@link graph}. Every state message also carries the weight (4 more bytes), and the running sums need {@link STATE_FLOAT}.
+#define CONSENSUS_PUSH_SUM 4
+
+///The update rule of Average Consensus ({@link CONSENSUS_FIRST_ORDER}, {@link CONSENSUS_SECOND_ORDER}, {@link CONSENSUS_CHEBYSHEV}, {@link CONSENSUS_FINITE_TIME} or {@link CONSENSUS_PUSH_SUM}). The accelerated rules need far fewer iterations on sparse graphs. Every board computes their parameters from the {@link graph}, so it has to be the same for all boards.
+#define CONSENSUS_UPDATE CONSENSUS_FIRST_ORDER
+
+///The max-degree weights: every edge gets the weight 1/(d+1), where d is the maximum degree of the {@link graph}.
+#define WEIGHTS_MAX_DEGREE 0
+
+///The Metropolis-Hastings weights: the edge between boards i & j gets the weight 1/(1+max(d_i,d_j)), where d_i & d_j are their degrees.
+#define WEIGHTS_METROPOLIS 1
+
+///The best-constant weights: every edge gets the weight 2/(l_1+l_{n-1}), where l_1 & l_{n-1} are the largest & the second smallest eigenvalues of the Laplacian matrix of the {@link graph}.
+#define WEIGHTS_BEST_CONSTANT 2
+
+///The precomputed weights of {@link default_weights} (e.g., the fastest-mixing weights reported by host/spectral_gap). They are only valid for the default graph; on any other graph, the Metropolis-Hastings weights are used instead.
+#define WEIGHTS_CONFIGURED 3
+
+///The weight policy of Average Consensus ({@link WEIGHTS_MAX_DEGREE}, {@link WEIGHTS_METROPOLIS}, {@link WEIGHTS_BEST_CONSTANT} or {@link WEIGHTS_CONFIGURED}). It determines the convergence rate on a given graph (host/spectral_gap compares the policies). Every board computes the weights of all boards, so it has to be the same for all boards. It is not used by {@link CONSENSUS_PUSH_SUM}, whose shares depend only on the {@link directed_graph}.
+#define CONSENSUS_WEIGHTS WEIGHTS_MAX_DEGREE
+
+///Set to 1 for every board to start a run from the result of its last run, corrected by the change of its readings since then, i.e., previous state + (new reading - previous reading), instead of its new reading. The sum of the initial states is still the sum of the new readings (the runs preserve the sum of the states), hence the average is the same, but the states start close to it when the readings drift slowly, and the run needs only as many iterations as the drift requires. Every board has to have completed the last run (a board which has not, e.g., after a reset or a new topology, starts from its reading, and the average is off by the difference of its last state from its last reading). Set to 0 for every run to start from the readings.
+#define USE_WARM_START 0
+
+///Set to 1 for all boards to receive on a single radio channel ({@link SHARED_CHANNEL}), where every board broadcasts its state once per iteration to all its neighbors. Set to 0 for every board to receive only its own messages (see {@link USE_ADDRESS_FILTER}), where the state is sent once per neighbor. It can be overridden from the compiler's command line (e.g., -DUSE_SHARED_CHANNEL=0), as the host tests do for a run behind the address filter.
+#ifndef USE_SHARED_CHANNEL
+#define USE_SHARED_CHANNEL 1
+#endif
+
+///The radio channel shared by all boards when {@link USE_SHARED_CHANNEL} equals to 1 (or {@link USE_ADDRESS_FILTER} equals to 1).
+#define SHARED_CHANNEL 0
+
+///Set to 1 for the boards to receive on the {@link SHARED_CHANNEL} when {@link USE_SHARED_CHANNEL} equals to 0, where the radio drops the messages for other boards by their destination field (the address filter of RAIL), before they wake up the MCU. The number of boards is not limited by the channels, and the radio is never retuned. Set to 0 for every board to receive on its own channel (equal to its identity), where the radio is retuned to the channel of the destination before every transmission. Has no effect when {@link USE_SHARED_CHANNEL} equals to 1, where the boards overhear the messages of their neighbors.
+#define USE_ADDRESS_FILTER 1
+
+///Set to 1 for the messages which are sent to a single board (the baton, the state when {@link USE_SHARED_CHANNEL} equals to 0, and the messages of the gossip) to be acknowledged by their receiver with the auto-ACK of RAIL, and retransmitted after a random backoff if their ACK does not arrive (see app_network.h), so that a lost baton does not stall the system until its restart. Broadcast messages are not acknowledged. Every ACK costs about one more airtime per message, and the timeouts allow for the retransmissions, which only pays off on links which lose messages: enable it for such deployments. Set to 0 for every message to be sent once. It can be overridden from the compiler's command line (e.g., -DUSE_ACKS=1).
+#ifndef USE_ACKS
+#define USE_ACKS 0
+#endif
+
+///Set to 1 for the restart and start messages to be flooded (see app_routing.h): every board relays them once when it first receives them, if it has neighbors farther from the board which sent them first, so that they reach all boards within diameter-many hops in parallel. A board which heard a copy from every neighbor skips them when the baton reaches it. Set to 0 for every board to send them to its neighbors only when the baton reaches it. Has no effect in TDMA mode, which relays the start message in the setup frames, nor with {@link USE_LOW_POWER_LISTEN}, where every relay is a wake train that would keep the baton from being received.
+#define USE_FLOODING 1
+
+///Set to 1 for the iterations of Average Consensus to follow a TDMA schedule instead of the baton: every board broadcasts its state in its own slot of a frame, and boards which cannot interfere (at distance greater than 2 in the {@link graph}) share a slot. The boards synchronize their clocks with the start message. Requires {@link USE_SHARED_CHANNEL} to be 1.
+#define USE_TDMA 0
+
+///The duration of a TDMA slot in milliseconds. It has to exceed the airtime of a message (at most about 77 ms at 2.4 kbps, or 90 ms for a state of 2 quantities with the weight of push-sum, see {@link app_codec.h}) plus the errors of the synchronization.
+#define TDMA_SLOT_MILISECS 100
+
+///The number of frames of the discovery of the graph (see the 'discover' CLI command) in which every board broadcasts a beacon in its own slot, and counts the beacons it receives from every other board.
+#define DISCOVERY_BEACONS 4
+
+///The minimum number of beacons (of {@link DISCOVERY_BEACONS}) which a board has to receive from another board during the discovery, for their link to be included in the graph.
+#define DISCOVERY_MIN_BEACONS 3
+
+///The minimum mean RSSI (in dBm) of the beacons which a board receives from another board during the discovery, for their link to be included in the graph. A link is included only if both of its boards measure it above the thresholds, so that a marginal link does not lose the baton.
+#define DISCOVERY_MIN_RSSI -85
+
+///Set to 1 for the messages of every iteration of Average Consensus (e.g., every received & released baton) to be stored as binary records in the trace of the board, which is printed when the board goes to sleep or with the 'trace' CLI command, and rendered as text by host/trace_decode. Set to 0 for the messages to be printed immediately (as text), which delays every iteration by the time to send them over the console UART.
+#define USE_TRACE 1
+
+///Set to 1 for a board to turn off its radio while the baton is away from its neighborhood, so that the MCU drops to EM2 until the earliest time the baton can return (at one airtime per step of the baton). Set to 0 for the radio to receive throughout a run, which keeps the MCU in EM1 between the steps of the baton. It only applies to the baton on the shared channel ({@link USE_SHARED_CHANNEL} equals to 1 and {@link USE_TDMA} equals to 0), where a board overhears the batons of its neighbors.
+#define USE_RADIO_SLEEP 0
+
+///Set to 1 for a sleeping board to receive only in short periodic windows ({@link LISTEN_WINDOW_MILISECS} every {@link LISTEN_INTERVAL_MILISECS}), with its radio turned off (and the MCU in EM2) in between, instead of receiving continuously until the next run. A board which starts the task (or restarts the system) then repeats its message for a whole interval and window, so that it falls in a window of every sleeping neighbor; every hop of the start message adds up to an interval to the wake-up of the system. Set to 0 for a sleeping board to receive continuously. It only applies to the baton ({@link USE_TDMA} equals to 0).
+#define USE_LOW_POWER_LISTEN 0
+
+///The period of the listen windows of a sleeping board in milliseconds (when {@link USE_LOW_POWER_LISTEN} equals to 1). It bounds the delay of every hop of the start message, while the idle current of a board is roughly proportional to {@link LISTEN_WINDOW_MILISECS}/LISTEN_INTERVAL_MILISECS.
+#define LISTEN_INTERVAL_MILISECS 1000
+
+///The duration of a listen window in milliseconds (when {@link USE_LOW_POWER_LISTEN} equals to 1). It has to exceed the airtime of a message (at most about 77 ms at 2.4 kbps, see {@link app_codec.h}) plus the gap between two repetitions of the start message, so that a whole message starts in every window (a message which has started is received after the end of the window).
+#define LISTEN_WINDOW_MILISECS 100
+
+///Set to 1 for the board's LEDs to indicate the EM transitions (red in EM0, green in EM1, both off in EM2). Set to 0 for deactivated LEDs.
 #define USE_EM_TRANSITION_LEDS 1
 
-///Set to 1 if the board has to use pre-specified temperature measurements (from the {@link simulated_temperatures} array), e.g., for debugging or performance measurement. Set to 0 for the board to use the actual temperature measured by its thermistor.
+///Set to 1 if the board has to use pre-specified temperature & humidity measurements (from the {@link simulated_temperatures} & {@link simulated_humidities} arrays), e.g., for debugging or performance measurement. Set to 0 for the board to use the actual values measured by its sensor.
 #define SIMULATE_TEMPERATURE_MEASUREMENTS 0
 
+///The state is sent as a 32-bit float (4 bytes), i.e., exactly.
+#define STATE_FLOAT 0
+
+///The state is sent as a half-precision float (2 bytes): about 3 significant digits (a resolution of 1/64 between 16 & 32 degrees).
+#define STATE_HALF 1
+
+///The state is sent as a fixed-point number (2 bytes) with {@link STATE_FIXED_FRACTION_BITS} fraction bits, saturated to its range.
+#define STATE_FIXED 2
+
+///The encoding of the state in the messages ({@link STATE_FLOAT}, {@link STATE_HALF} or {@link STATE_FIXED}). The 2-byte encodings shorten the messages with the state, and every board rounds its own state to the encoded value, so that the boards still compute with the same states (and the average is preserved up to the rounding of the initial temperatures). The resolution has to be well below the {@link STOP_THRESHOLD}, and {@link CONSENSUS_FINITE_TIME} needs {@link STATE_FLOAT}. It has to be the same for all boards. It can be overridden from the compiler's command line (e.g., -DSTATE_ENCODING=1), as the host tests of the codec do for every encoding.
+#ifndef STATE_ENCODING
+#define STATE_ENCODING STATE_FLOAT
+#endif
+
+///The fraction bits of the fixed-point state (when {@link STATE_ENCODING} equals to {@link STATE_FIXED}): 7 bits give a resolution of 1/128 and a range of [-256, 256).
+#define STATE_FIXED_FRACTION_BITS 7
+
 ///This array contains some pre-specified temperatures, to be used instead of the actual ones, when {@link SIMULATE_TEMPERATURE_MEASUREMENTS} equals to 1.
-extern const float simulated_temperatures[NUM_OF_BOARDS];
+extern const float simulated_temperatures[MAX_NUM_OF_BOARDS];
+
+///This array contains some pre-specified relative humidities (in %RH), to be used instead of the actual ones, when {@link SIMULATE_TEMPERATURE_MEASUREMENTS} equals to 1.
+extern const float simulated_humidities[MAX_NUM_OF_BOARDS];
 
 #endif  //APP_CONFIG_H
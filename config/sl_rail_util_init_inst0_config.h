@@ -195,7 +195,7 @@
 #define SL_RAIL_UTIL_INIT_EVENT_RX_PACKET_RECEIVED_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_RX_FRAME_ERROR_INST0_ENABLE> RX Frame Error
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_RX_FRAME_ERROR_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_RX_FRAME_ERROR_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_RX_PACKET_ABORTED_INST0_ENABLE> RX Packet Aborted
 // <i> Default: 0
 #define SL_RAIL_UTIL_INIT_EVENT_RX_PACKET_ABORTED_INST0_ENABLE 1
@@ -265,7 +265,7 @@
 #define SL_RAIL_UTIL_INIT_EVENT_RX_TX_SCHEDULED_RX_TX_STARTED_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_RX_SCHEDULED_RX_END_INST0_ENABLE> Scheduled RX End
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_RX_SCHEDULED_RX_END_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_RX_SCHEDULED_RX_END_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_RX_SCHEDULED_RX_MISSED_INST0_ENABLE> Scheduled RX Missed
 // <i> Default: 0
 #define SL_RAIL_UTIL_INIT_EVENT_RX_SCHEDULED_RX_MISSED_INST0_ENABLE 1
@@ -276,19 +276,19 @@
 // <h> ACK Radio Events
 // <q SL_RAIL_UTIL_INIT_EVENT_RX_ACK_TIMEOUT_INST0_ENABLE> RX ACK, Timeout
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_RX_ACK_TIMEOUT_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_RX_ACK_TIMEOUT_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_TXACK_PACKET_SENT_INST0_ENABLE> TX ACK, Packet Sent
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_TXACK_PACKET_SENT_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_TXACK_PACKET_SENT_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_TXACK_ABORTED_INST0_ENABLE> TX ACK, Aborted
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_TXACK_ABORTED_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_TXACK_ABORTED_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_TXACK_BLOCKED_INST0_ENABLE> TX ACK, Blocked
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_TXACK_BLOCKED_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_TXACK_BLOCKED_INST0_ENABLE 1
 // <q SL_RAIL_UTIL_INIT_EVENT_TXACK_UNDERFLOW_INST0_ENABLE> TX ACK, FIFO Underflow
 // <i> Default: 0
-#define SL_RAIL_UTIL_INIT_EVENT_TXACK_UNDERFLOW_INST0_ENABLE 0
+#define SL_RAIL_UTIL_INIT_EVENT_TXACK_UNDERFLOW_INST0_ENABLE 1
 // </h>
 // <h> Protocol Radio Events
 // <q SL_RAIL_UTIL_INIT_EVENT_IEEE802154_DATA_REQUEST_COMMAND_INST0_ENABLE> IEEE 802.15.4 Data Request Command
@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @file baton_path.c
+ * @brief A host tool which generates the baton path of a graph with the
+ * function of app/app_path.c (as a board does, see USE_AUTO_BATON_PATH in
+ * config/app_config.h), and prints it in the formats of the 'provision' CLI
+ * command and of default_baton_path in config/app_config.c. It also generates
+ * the paths of random connected graphs, checks that every path obeys the rules
+ * of baton_path, and compares their lengths with the number of boards (a
+ * Hamiltonian cycle) and with the Euler tour of a spanning tree.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_config.h"
+#include "app_path.h"
+
+///The options of the tool.
+static struct {
+	int boards;
+	const char *edges;
+	int graphs;
+	int random_boards;
+	double extra_edges;
+	uint64_t seed;
+} opts = {
+	.boards = DEFAULT_NUM_OF_BOARDS,
+	.edges = NULL,
+	.graphs = 0,
+	.random_boards = 10,
+	.extra_edges = 0.1,
+	.seed = 1
+};
+
+///The state of the random generator.
+static uint64_t rng_state;
+
+/** Returns a uniformly distributed random number in [0,1) (xorshift64*).
+ *
+ * @return The random number.
+ */
+static double random_uniform(void){
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+/** Replaces the graph with a random connected graph: a random spanning tree,
+ * and every other edge with a given probability.
+ *
+ * @param boards The number of boards.
+ * @param extra The probability of every edge beyond the spanning tree.
+ */
+static void random_graph(int boards, double extra){
+	num_of_boards = boards;
+	memset(graph, 0, sizeof(graph));
+	for(int i=0;i<boards;i++){
+		graph[i][i] = true;
+		if(i>0){
+			int j = (int)(random_uniform()*i);
+			graph[i][j] = graph[j][i] = true;
+		}
+	}
+	for(int i=0;i<boards;i++)
+		for(int j=i+1;j<boards;j++)
+			if(random_uniform()<extra)
+				graph[i][j] = graph[j][i] = true;
+}
+
+/** Checks whether a baton path obeys the rules of baton_path on the graph
+ * (independently of the application, which checks them when it is provisioned).
+ *
+ * @param len The length of the path.
+ * @param path The path.
+ * @return NULL if the path is valid, otherwise the rule that it breaks.
+ */
+static const char *check_path(int len, const int8_t *path){
+	bool visited[MAX_NUM_OF_BOARDS] = { false };
+	if(len<2 || len>MAX_LENGTH_OF_BATON_PATH)
+		return "length";
+	for(int i=0;i<len;i++){
+		int prev = path[(i+len-1)%len], cur = path[i], next = path[(i+1)%len];
+		if(cur<0 || cur>=num_of_boards)
+			return "board";
+		visited[cur] = true;
+		if(cur==next || !graph[cur][next])
+			return "RULE 2/3";
+		for(int k=0;k<len;k++)
+			if(k!=i && path[(k+len-1)%len]==prev && path[k]==cur && path[(k+1)%len]!=next)
+				return "RULE 4";
+	}
+	for(int i=0;i<num_of_boards;i++)
+		if(!visited[i])
+			return "RULE 1";
+	return NULL;
+}
+
+/** Prints the usage of the tool.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options]\n"
+	       "Generates the baton path of a graph, and checks the paths of random graphs.\n"
+	       "Without --edges, the default graph of config/app_config.c is used.\n\n"
+	       "  --boards N           Number of boards of the graph (at most %d, default %d).\n"
+	       "  --edges LIST         Edges of the graph (e.g., 0-1,1-2,2-3).\n"
+	       "  --graphs N           Number of random graphs (default 0).\n"
+	       "  --random-boards N    Boards of every random graph (default 10).\n"
+	       "  --extra-edges P      Probability of every edge beyond a random spanning tree (default 0.1).\n"
+	       "  --seed N             Seed of the random generator (default 1).\n"
+	       "  -h, --help           Print this message.\n", prog, MAX_NUM_OF_BOARDS, DEFAULT_NUM_OF_BOARDS);
+}
+
+/** Parses a comma-separated list of edges (e.g., 0-1,1-2) into the graph.
+ *
+ * @param list The list.
+ * @return True if the list was parsed successfully.
+ */
+static bool parse_edges(const char *list){
+	memset(graph, 0, sizeof(graph));
+	for(int i=0;i<num_of_boards;i++)
+		graph[i][i] = true;
+	const char *p = list;
+	while(*p){
+		char *end;
+		long a = strtol(p, &end, 10);
+		if(end==p || *end!='-' || a<0 || a>=num_of_boards)
+			return false;
+		p = end+1;
+		long b = strtol(p, &end, 10);
+		if(end==p || b<0 || b>=num_of_boards)
+			return false;
+		graph[a][b] = graph[b][a] = true;
+		p = (*end==',') ? end+1 : end;
+		if(*end && *end!=',')
+			return false;
+	}
+	return true;
+}
+
+/** Parses the command line, and generates the path of the given graph and of
+ * the random graphs.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 if every path is valid, 1 otherwise.
+ */
+int main(int argc, char **argv){
+	static const struct option long_opts[] = {
+		{ "boards", required_argument, NULL, 'n' },
+		{ "edges", required_argument, NULL, 'e' },
+		{ "graphs", required_argument, NULL, 'g' },
+		{ "random-boards", required_argument, NULL, 'r' },
+		{ "extra-edges", required_argument, NULL, 'x' },
+		{ "seed", required_argument, NULL, 'S' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "h", long_opts, NULL)) != -1){
+		switch(c){
+		case 'n': opts.boards = atoi(optarg); break;
+		case 'e': opts.edges = optarg; break;
+		case 'g': opts.graphs = atoi(optarg); break;
+		case 'r': opts.random_boards = atoi(optarg); break;
+		case 'x': opts.extra_edges = atof(optarg); break;
+		case 'S': opts.seed = strtoull(optarg, NULL, 0); break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	if(opts.boards < 2 || opts.boards > MAX_NUM_OF_BOARDS || opts.graphs < 0
+			|| opts.random_boards < 2 || opts.random_boards > MAX_NUM_OF_BOARDS
+			|| (!opts.edges && opts.boards != DEFAULT_NUM_OF_BOARDS)){
+		usage(argv[0]);
+		return 1;
+	}
+	rng_state = opts.seed ? opts.seed : 1;
+
+	num_of_boards = opts.boards;
+	if(opts.edges){
+		if(!parse_edges(opts.edges)){
+			fprintf(stderr, "baton_path: invalid list of edges '%s'.\n", opts.edges);
+			return 1;
+		}
+	}
+	else {
+		for(int i=0;i<DEFAULT_NUM_OF_BOARDS;i++)
+			for(int j=0;j<DEFAULT_NUM_OF_BOARDS;j++)
+				graph[i][j] = default_graph[i][j];
+	}
+
+	int8_t path[MAX_LENGTH_OF_BATON_PATH];
+	uint8_t len = generate_baton_path(num_of_boards, graph, path);
+	if(!len){
+		fprintf(stderr, "baton_path: the graph is not connected.\n");
+		return 1;
+	}
+	const char *broken = check_path(len, path);
+	printf("%s graph (%d boards): baton path of %d boards%s%s\n", opts.edges ? "Given" : "Default", num_of_boards, len,
+			broken ? ", which breaks " : "", broken ? broken : "");
+	if(!opts.edges)
+		printf("  (default_baton_path: %d boards)\n", DEFAULT_LENGTH_OF_BATON_PATH);
+	printf("  provision:          ");
+	for(int i=0;i<len;i++)
+		printf("%s%d", i ? "," : "", path[i]);
+	printf("\n  default_baton_path: {");
+	for(int i=0;i<len;i++)
+		printf("%s%d", i ? ", " : "", path[i]);
+	printf("}\n");
+	int failures = broken!=NULL;
+
+	if(opts.graphs == 0)
+		return failures ? 1 : 0;
+	double sum_len = 0;
+	int worst = 0, cycles = 0;
+	for(int g=0;g<opts.graphs;g++){
+		random_graph(opts.random_boards, opts.extra_edges);
+		len = generate_baton_path(num_of_boards, graph, path);
+		broken = len ? check_path(len, path) : "connectivity";
+		if(broken){
+			if(failures++ < 10)
+				fprintf(stderr, "FAILED: the path of random graph %d breaks %s\n", g, broken);
+			continue;
+		}
+		sum_len += len;
+		cycles += len==num_of_boards;
+		if(len > worst)
+			worst = len;
+	}
+	printf("\n%d random graphs (%d boards, extra edges %.2f): %s\n", opts.graphs, opts.random_boards, opts.extra_edges, failures ? "FAILED" : "OK");
+	printf("  mean length %.2f, worst %d (Hamiltonian cycle %d, spanning tree tour %d), %d Hamiltonian cycles\n",
+			sum_len/opts.graphs, worst, opts.random_boards, 2*(opts.random_boards-1), cycles);
+	return failures ? 1 : 0;
+}
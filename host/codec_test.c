@@ -0,0 +1,277 @@
+/***************************************************************************//**
+ * @file codec_test.c
+ * @brief Host tests of the wire format of app/app_codec.c. Every type of
+ * message (with and without its optional fields) is encoded and decoded
+ * with random fields, and random or corrupted packets are decoded, which must
+ * either be rejected or decode to a message which is encoded to the same
+ * packet. The encoding of the state is fixed when the codec is compiled, hence
+ * the Makefile builds the tests once per encoding (see STATE_ENCODING).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_codec.h"
+
+///The names of the encodings of the state (ordered by their values in app_config.h).
+static const char *const encoding_names[] = { "float", "half", "fixed" };
+
+///The options of the tests.
+static struct {
+	int iterations;
+	uint64_t seed;
+} opts = {
+	.iterations = 100000,
+	.seed = 1
+};
+
+///The state of the random generator.
+static uint64_t rng_state;
+
+///The number of failed checks.
+static int failures;
+
+/** Returns a random 32-bit number (xorshift64*).
+ *
+ * @return The random number.
+ */
+static uint32_t random_u32(void){
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (uint32_t)((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/** Returns a random state: mostly temperatures, sometimes any float (e.g.,
+ * out of the range of the encoding, infinite or NaN).
+ *
+ * @return The random state.
+ */
+static float random_state(void){
+	if(random_u32() % 4){
+		float unit = random_u32() / 4294967296.0f;
+		return -40 + 125*unit;
+	}
+	uint32_t bits = random_u32();
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/** Records a failed check.
+ *
+ * @param what The description of the failure.
+ * @param packet The message (or NULL).
+ */
+static void fail(const char *what, const packet_t *packet){
+	if(failures++ < 10){
+		if(packet)
+			fprintf(stderr, "FAILED: %s (type %d, src %u, dst %u, tdma %d, has_state %d, state %a)\n", what, packet->type, packet->src, packet->dst, packet->tdma, packet->has_state, packet->state[0]);
+		else
+			fprintf(stderr, "FAILED: %s\n", what);
+	}
+}
+
+/** Returns whether two states are equal, as the codec carries them (NaN
+ * equals NaN).
+ *
+ * @param a The first state.
+ * @param b The second state.
+ * @return True if the states are equal.
+ */
+static bool same_state(float a, float b){
+	return (isnan(a) && isnan(b)) || a == b;
+}
+
+/** Returns whether a decoded state equals the rounding of an encoded one, in
+ * every quantity.
+ *
+ * @param out The decoded state.
+ * @param in The encoded state.
+ * @return True if the states are equal.
+ */
+static bool same_states(const float *out, const float *in){
+	bool same = true;
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		same = same && same_state(out[q], quantize_state(in[q]));
+	return same;
+}
+
+/** Checks the rounding of a state by the encoding: it is idempotent, and its
+ * error is within the resolution of the encoding.
+ *
+ * @param state The state.
+ */
+static void check_quantization(float state){
+	float q = quantize_state(state);
+	if(!same_state(quantize_state(q), q))
+		fail("the rounding of a state is not idempotent", NULL);
+	if(!isfinite(state) || !isfinite(q))
+		return;
+	double err = fabs((double) q - state);
+	if(STATE_ENCODING==STATE_FLOAT && err != 0)
+		fail("a float state is not exact", NULL);
+	if(STATE_ENCODING==STATE_HALF && fabs(state) >= ldexp(1, -14) && fabs(state) <= 65504 && err > fabs((double) state)*ldexp(1, -11))
+		fail("a half-precision state is not rounded to the nearest value", NULL);
+	if(STATE_ENCODING==STATE_FIXED){
+		double limit = ldexp(1, 15 - STATE_FIXED_FRACTION_BITS);
+		if(state > -limit && state < limit - ldexp(1, -STATE_FIXED_FRACTION_BITS) && err > ldexp(1, -STATE_FIXED_FRACTION_BITS-1))
+			fail("a fixed-point state is not rounded to the nearest value", NULL);
+		if(fabs(q) > limit)
+			fail("a fixed-point state is not saturated", NULL);
+	}
+}
+
+/** Encodes and decodes a random message of a type, and checks that the
+ * decoded message equals the encoded one.
+ *
+ * @param type The type of the message.
+ * @param tdma True if the fields of the TDMA mode are included.
+ * @param has_state True if a baton carries the state of its sender.
+ * @param has_weight True if the state is followed by the weight of push-sum.
+ */
+static void round_trip(message_t type, bool tdma, bool has_state, bool has_weight){
+	packet_t in = {
+		.type = type, .src = random_u32(), .dst = random_u32(), .tdma = tdma, .seq = random_u32(),
+		.restart_id = random_u32(), .task = random_u32(), .origin = random_u32(), .timestamp = random_u32(), .epoch = random_u32(),
+		.has_weight = has_weight, .weight = random_state(), .quiet_frames = random_u32(), .boards_over = (int8_t) random_u32(),
+		.has_state = has_state, .owner = random_u32(), .links = random_u32() >> (32 - 8*LINKS_BYTES),
+		.audible = random_u32() >> (32 - 8*LINKS_BYTES), .gossip = random_u32() % (GOSSIP_STOP+1)
+	};
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		in.state[q] = random_state();
+	uint8_t buffer[MAX_PACKET_LENGTH];
+	uint8_t length = encode_packet(&in, buffer);
+	if(length == 0 || length > MAX_PACKET_LENGTH || length != packet_length(&in) || buffer[PKTIDX_LENGTH] != length - 1 || PACKET_TYPE(buffer) != type){
+		fail("invalid length or header of an encoded packet", &in);
+		return;
+	}
+	packet_t out;
+	if(!decode_packet(buffer, length, &out)){
+		fail("an encoded packet is rejected", &in);
+		return;
+	}
+	bool same = out.type == in.type && out.src == in.src && out.dst == in.dst;
+	switch(type){
+	case MSG_RESTART:
+		same = same && out.restart_id == in.restart_id && out.origin == in.origin;
+		break;
+	case MSG_START_TASK:
+		same = same && out.task == in.task && out.origin == in.origin && out.tdma == tdma && (!tdma || (out.timestamp == in.timestamp && out.epoch == in.epoch));
+		break;
+	case MSG_CONSENSUS_STATE:
+		same = same && out.seq == in.seq && same_states(out.state, in.state) && out.tdma == tdma && (!tdma || out.quiet_frames == in.quiet_frames)
+				&& out.has_weight == has_weight && (!has_weight || same_state(out.weight, in.weight));
+		break;
+	case MSG_BATON:
+		same = same && out.seq == in.seq && out.boards_over == in.boards_over && out.has_state == has_state && (!has_state || same_states(out.state, in.state))
+				&& out.has_weight == (has_state && has_weight) && (!out.has_weight || same_state(out.weight, in.weight));
+		break;
+	case MSG_LINKS:
+		same = same && out.owner == in.owner && out.links == in.links && out.audible == in.audible;
+		break;
+	case MSG_ACK:
+		same = same && out.seq == in.seq;
+		break;
+	case MSG_GOSSIP:
+		same = same && out.seq == in.seq && out.gossip == in.gossip && out.quiet_frames == in.quiet_frames && same_states(out.state, in.state);
+		break;
+	default:
+		break;
+	}
+	if(!same)
+		fail("a decoded message differs from the encoded one", &in);
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		check_quantization(in.state[q]);
+
+	for(uint8_t len=0;len<length;len++) //every truncated packet is rejected
+		if(decode_packet(buffer, len, &out))
+			fail("a truncated packet is accepted", &in);
+}
+
+/** Decodes a random (or randomly corrupted) packet, and checks that a packet
+ * which is accepted is encoded back to the same bytes.
+ */
+static void fuzz(void){
+	uint8_t buffer[2*MAX_PACKET_LENGTH];
+	for(size_t i=0;i<sizeof(buffer);i++)
+		buffer[i] = random_u32();
+	uint16_t length = random_u32() % (sizeof(buffer)+1);
+	if(random_u32() % 2 && length > PKTIDX_HEADER){ //make most of the header valid, so that the fields are reached
+		buffer[PKTIDX_LENGTH] = length - 1 + (random_u32() % 8 == 0);
+		buffer[PKTIDX_HEADER] = (PACKET_VERSION << 4) | (random_u32() % (NUM_OF_MSG_TYPES+1));
+	}
+	packet_t packet;
+	if(!decode_packet(buffer, length, &packet))
+		return;
+	bool nan = false; //a NaN may be encoded back with other bits
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		nan = nan || isnan(packet.state[q]);
+	uint8_t encoded[MAX_PACKET_LENGTH];
+	uint8_t encoded_length = encode_packet(&packet, encoded);
+	if(encoded_length != length || (!nan && memcmp(encoded, buffer, length) != 0))
+		fail("an accepted packet is not encoded back to the same bytes", &packet);
+}
+
+/** Prints the usage of the tests.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options]\n\n"
+	       "  --iterations N  Random messages per type, and random packets (default 100000).\n"
+	       "  --seed N        Seed of the random generator (default 1).\n"
+	       "  -h, --help      Print this message.\n", prog);
+}
+
+/** Parses the command line and runs the tests.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(int argc, char **argv){
+	static const struct option long_opts[] = {
+		{ "iterations", required_argument, NULL, 'i' },
+		{ "seed", required_argument, NULL, 's' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "h", long_opts, NULL)) != -1){
+		switch(c){
+		case 'i': opts.iterations = atoi(optarg); break;
+		case 's': opts.seed = strtoull(optarg, NULL, 0); break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	rng_state = opts.seed ? opts.seed : 0x9E3779B97F4A7C15ULL;
+
+	//The boundaries of the encodings
+	static const float edges[] = { 0, -0.0f, 1, -1, 0.5f, 20.03125f, -273, 255.99f, 256, -256, -256.01f, 65504, 65520, 1e-8f, 6e-8f, 3e-8f, 1e30f, INFINITY, -INFINITY, NAN };
+	for(size_t i=0;i<sizeof(edges)/sizeof(edges[0]);i++)
+		check_quantization(edges[i]);
+
+	for(int i=0;i<opts.iterations;i++){
+		for(int type=0;type<NUM_OF_MSG_TYPES;type++){
+			round_trip((message_t) type, false, false, false);
+			round_trip((message_t) type, true, false, false);
+			round_trip((message_t) type, false, true, false);
+			round_trip((message_t) type, false, false, true);
+			round_trip((message_t) type, true, false, true);
+			round_trip((message_t) type, false, true, true);
+		}
+		fuzz();
+	}
+	packet_t invalid = { .type = NUM_OF_MSG_TYPES };
+	uint8_t buffer[MAX_PACKET_LENGTH];
+	if(encode_packet(&invalid, buffer) != 0)
+		fail("a message of an invalid type is encoded", &invalid);
+
+	printf("codec_test (%s state): %d messages per type, %d random packets: %s\n",
+	       encoding_names[STATE_ENCODING], 6*opts.iterations, opts.iterations, failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
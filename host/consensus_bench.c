@@ -0,0 +1,257 @@
+/***************************************************************************//**
+ * @file consensus_bench.c
+ * @brief A host benchmark of the update rules of Average Consensus. It runs
+ * the synchronous iterations of all boards with the functions of
+ * app/app_consensus.c, on the default graph of config/app_config.c and on
+ * random connected graphs, and compares the iterations until every board is
+ * below the STOP_THRESHOLD (i.e., when the application stops) and until every
+ * board is within a given accuracy of the true average. Every iteration costs
+ * the same radio packets, whatever the update rule.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_config.h"
+#include "app_consensus.h"
+
+///The maximum number of iterations of a run (also the limit of the iteration counter of the application).
+#define MAX_ITERATIONS 255
+
+///The number of update rules.
+#define NUM_OF_RULES 4
+
+///The names of the update rules (ordered by their values in app_config.h).
+static const char *const rule_names[NUM_OF_RULES] = { "first-order", "second-order", "chebyshev", "finite-time" };
+
+///The options of the benchmark.
+static struct {
+	int graphs;
+	int boards;
+	double extra_edges;
+	double accuracy;
+	uint64_t seed;
+} opts = {
+	.graphs = 100,
+	.boards = 10,
+	.extra_edges = 0.1,
+	.accuracy = 0.1,
+	.seed = 1
+};
+
+///The state of the random generator.
+static uint64_t rng_state;
+
+/*******************************************************************************
+ * The console of the application is not used by the benchmark.
+ ******************************************************************************/
+void sim_log(int level, const char *fmt, ...){
+	(void)level; (void)fmt;
+}
+
+/** Returns a uniformly distributed random number in [0,1) (xorshift64*).
+ *
+ * @return The random number.
+ */
+static double random_uniform(void){
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return ((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * (1.0/9007199254740992.0);
+}
+
+/** Makes a random connected graph the current one: a random spanning tree (every
+ * board is connected to a random board with a smaller identity), plus every
+ * other edge with a given probability.
+ *
+ * @param boards The number of boards.
+ * @param extra The probability of an edge which does not belong to the tree.
+ */
+static void random_graph(int boards, double extra){
+	num_of_boards = boards;
+	memset(graph, 0, sizeof(graph));
+	for(int i=0;i<boards;i++){
+		graph[i][i] = true;
+		if(i>0){
+			int j = (int)(random_uniform()*i);
+			graph[i][j] = graph[j][i] = true;
+		}
+	}
+	for(int i=0;i<boards;i++)
+		for(int j=i+1;j<boards;j++)
+			if(random_uniform()<extra)
+				graph[i][j] = graph[j][i] = true;
+}
+
+/** The result of a run.
+ * - stop_iters: The iterations until every board changed its state by at most STOP_THRESHOLD (MAX_ITERATIONS+1 if never).
+ * - stop_err: The maximum distance of a state from the average at that iteration.
+ * - accurate_iters: The iterations until every state was within the accuracy of the average (MAX_ITERATIONS+1 if never).
+ */
+typedef struct {
+	int stop_iters;
+	double stop_err;
+	int accurate_iters;
+} result_t;
+
+/** Computes the convergence rate of the weights of {@link CONSENSUS_WEIGHTS} on the current graph.
+ *
+ * @return The convergence rate.
+ */
+static float graph_rate(void){
+	static float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	consensus_weights(CONSENSUS_WEIGHTS, w);
+	return consensus_rate(w);
+}
+
+/** Runs the synchronous iterations of all boards on the current graph.
+ *
+ * @param rule The update rule.
+ * @param temperatures The initial states of the boards.
+ * @return The result of the run.
+ */
+static result_t run(uint8_t rule, const float *temperatures){
+	static float w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	static float history[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS+1];
+	static double coefs[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS+1];
+	uint8_t degree[MAX_NUM_OF_BOARDS];
+	int exact_iters = 0;
+	float x[MAX_NUM_OF_BOARDS], prev[MAX_NUM_OF_BOARDS], next[MAX_NUM_OF_BOARDS];
+	consensus_weights(CONSENSUS_WEIGHTS, w);
+	float rate = consensus_rate(w), coef = 1;
+	double mean = 0;
+	for(int i=0;i<num_of_boards;i++){
+		x[i] = prev[i] = history[i][0] = temperatures[i];
+		mean += temperatures[i]/num_of_boards;
+		if(rule==CONSENSUS_FINITE_TIME){
+			degree[i] = finite_time_polynomial((const float (*)[MAX_NUM_OF_BOARDS]) w, rate, i, coefs[i]);
+			if(degree[i]>exact_iters)
+				exact_iters = degree[i];
+		}
+	}
+
+	result_t res = { MAX_ITERATIONS+1, 0, MAX_ITERATIONS+1 };
+	for(int iter=0;iter<MAX_ITERATIONS && (res.stop_iters>MAX_ITERATIONS || res.accurate_iters>MAX_ITERATIONS);iter++){
+		bool below = true;
+		double err = 0;
+		for(int i=0;i<num_of_boards;i++){
+			float wx = 0;
+			for(int j=0;j<num_of_boards;j++)
+				wx += w[i][j]*x[j];
+			next[i] = next_consensus_state(rule, coef, rate, wx, prev[i]);
+			if(rule==CONSENSUS_FINITE_TIME && iter<exact_iters){
+				history[i][iter+1] = next[i];
+				if(iter+1==exact_iters)
+					next[i] = finite_time_average(degree[i], coefs[i], history[i]);
+			}
+			if(rule==CONSENSUS_FINITE_TIME)
+				below = below && iter+1>=exact_iters;
+			else
+				below = below && fabsf(next[i]-x[i])<=STOP_THRESHOLD;
+			if(fabs(next[i]-mean)>err)
+				err = fabs(next[i]-mean);
+		}
+		memcpy(prev, x, sizeof(x));
+		memcpy(x, next, sizeof(x));
+		coef = next_chebyshev_coefficient(coef, rate);
+		if(below && res.stop_iters>MAX_ITERATIONS){
+			res.stop_iters = iter+1;
+			res.stop_err = err;
+		}
+		if(err<=opts.accuracy && res.accurate_iters>MAX_ITERATIONS)
+			res.accurate_iters = iter+1;
+	}
+	return res;
+}
+
+/** Prints the usage of the benchmark.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options]\n"
+	       "Compares the update rules of Average Consensus on the default graph and on random graphs.\n\n"
+	       "  --graphs N           Number of random graphs (default 100).\n"
+	       "  --boards N           Boards of every random graph (at most %d, default 10).\n"
+	       "  --extra-edges P      Probability of every edge beyond a random spanning tree (default 0.1).\n"
+	       "  --accuracy E         Maximum distance from the true average of an accurate state (default 0.1).\n"
+	       "  --seed N             Seed of the random generator (default 1).\n"
+	       "  -h, --help           Print this message.\n", prog, MAX_NUM_OF_BOARDS);
+}
+
+/** Parses the command line and runs the benchmark.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 1 on invalid arguments.
+ */
+int main(int argc, char **argv){
+	static const struct option long_opts[] = {
+		{ "graphs", required_argument, NULL, 'g' },
+		{ "boards", required_argument, NULL, 'n' },
+		{ "extra-edges", required_argument, NULL, 'x' },
+		{ "accuracy", required_argument, NULL, 'a' },
+		{ "seed", required_argument, NULL, 'S' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "h", long_opts, NULL)) != -1){
+		switch(c){
+		case 'g': opts.graphs = atoi(optarg); break;
+		case 'n': opts.boards = atoi(optarg); break;
+		case 'x': opts.extra_edges = atof(optarg); break;
+		case 'a': opts.accuracy = atof(optarg); break;
+		case 'S': opts.seed = strtoull(optarg, NULL, 0); break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	if(opts.graphs < 0 || opts.boards < 2 || opts.boards > MAX_NUM_OF_BOARDS){
+		usage(argv[0]);
+		return 1;
+	}
+	rng_state = opts.seed ? opts.seed : 1;
+
+	//The default graph, with the simulated temperatures
+	num_of_boards = DEFAULT_NUM_OF_BOARDS;
+	for(int i=0;i<DEFAULT_NUM_OF_BOARDS;i++)
+		for(int j=0;j<DEFAULT_NUM_OF_BOARDS;j++)
+			graph[i][j] = default_graph[i][j];
+	printf("Default graph (%d boards, convergence rate %.4f):\n", num_of_boards, graph_rate());
+	printf("  %-13s %21s   accurate within %g\n", "", "stop (max error)", opts.accuracy);
+	for(int r=0;r<NUM_OF_RULES;r++){
+		result_t res = run(r, simulated_temperatures);
+		printf("  %-13s %6d iters (%.4f) %17d iters\n", rule_names[r], res.stop_iters, res.stop_err, res.accurate_iters);
+	}
+
+	if(opts.graphs == 0)
+		return 0;
+	double sum_stop[NUM_OF_RULES] = { 0 }, sum_err[NUM_OF_RULES] = { 0 }, sum_accurate[NUM_OF_RULES] = { 0 };
+	int worst[NUM_OF_RULES] = { 0 }, failed[NUM_OF_RULES] = { 0 };
+	double sum_rate = 0;
+	for(int g=0;g<opts.graphs;g++){
+		float temperatures[MAX_NUM_OF_BOARDS];
+		random_graph(opts.boards, opts.extra_edges);
+		for(int i=0;i<opts.boards;i++)
+			temperatures[i] = 15 + 10*random_uniform();
+		sum_rate += graph_rate();
+		for(int r=0;r<NUM_OF_RULES;r++){
+			result_t res = run(r, temperatures);
+			sum_stop[r] += res.stop_iters;
+			sum_err[r] += res.stop_err;
+			sum_accurate[r] += res.accurate_iters;
+			failed[r] += res.accurate_iters > MAX_ITERATIONS;
+			if(res.accurate_iters > worst[r])
+				worst[r] = res.accurate_iters;
+		}
+	}
+	printf("\n%d random graphs (%d boards, extra edges %.2f, mean convergence rate %.4f):\n", opts.graphs, opts.boards, opts.extra_edges, sum_rate/opts.graphs);
+	printf("  %-13s %21s   accurate within %g: mean / worst\n", "", "mean stop (max error)", opts.accuracy);
+	for(int r=0;r<NUM_OF_RULES;r++)
+		printf("  %-13s %6.1f iters (%.4f) %17.1f / %3d iters (%d never)\n",
+				rule_names[r], sum_stop[r]/opts.graphs, sum_err[r]/opts.graphs, sum_accurate[r]/opts.graphs, worst[r], failed[r]);
+	return 0;
+}
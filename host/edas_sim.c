@@ -0,0 +1,733 @@
+/***************************************************************************//**
+ * @file edas_sim.c
+ * @brief The command-line driver of the host simulator. It loads one image of
+ * the application per board, optionally provisions the topology of every board
+ * (as the 'provision' CLI command does), starts the Average Consensus from the
+ * CLI of a board (with the baton, or with the randomized gossip, or both for a
+ * comparison of their means, or the tracking of the average over drifting
+ * temperatures) and reports the time to converge, the exchanged packets, the
+ * retransmissions, the baton-cycle latency and the energy estimates of the boards (optionally also
+ * of an idle period after the run). The graph can also be discovered by the
+ * boards first (as the 'discover' CLI command does), over links of which some
+ * may be marginal (weak), and every run can follow a previous run of the same
+ * command (e.g., for the warm start of the boards).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sim.h"
+#include "sl_cli.h"
+#include "app_config.h"
+#include "app_power.h"
+#include "app_codec.h"
+#include "app_network.h"
+
+///The names of the message types (same ordering as message_t in app_codec.h).
+static const char *const msg_names[NUM_OF_MSG_TYPES] = { "RESTART", "START_TASK", "CONSENSUS_STATE", "BATON", "LINKS", "ACK", "GOSSIP" };
+
+///The engines of Average Consensus which the simulator can run.
+enum { ENGINE_BATON, ENGINE_GOSSIP, ENGINE_TRACK, NUM_OF_ENGINES };
+
+///The names of the engines, and the CLI commands which start them.
+static const char *const engine_names[NUM_OF_ENGINES] = { "baton", "gossip", "track" };
+
+///The engines which are compared by '--engine both'.
+#define BOTH_ENGINES ((1 << ENGINE_BATON) | (1 << ENGINE_GOSSIP))
+
+///The options of the simulation.
+static struct {
+	int runs;
+	int start_board;
+	int boards;
+	const char *edges;
+	const char *path;
+	const char *temperature_list;
+	double temperatures[MAX_NUM_OF_BOARDS];
+	const char *drift_list;
+	double drifts[MAX_NUM_OF_BOARDS];
+	double track_s;
+	double rerun_s;
+	uint64_t seed;
+	double timeout_s;
+	double idle_s;
+	int rssi;
+	const char *weak_links;
+	bool weak[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	int weak_rssi;
+	double weak_loss;
+	bool discover;
+	int engines;
+} opts = {
+	.runs = 1,
+	.start_board = 0,
+	.boards = DEFAULT_NUM_OF_BOARDS,
+	.seed = 1,
+	.timeout_s = 600,
+	.track_s = 120,
+	.rssi = -60,
+	.weak_rssi = -92,
+	.weak_loss = 0.5,
+	.engines = 1 << ENGINE_BATON
+};
+
+///The statistics of the protocol during a run, collected by the observers of the simulation.
+static struct {
+	uint64_t first_baton;
+	uint64_t last_baton;
+	uint32_t batons;
+	uint32_t tx_by_type[NUM_OF_MSG_TYPES];
+	uint8_t last_baton_frame[SIM_MAX_NODES][SIM_MAX_FRAME_BYTES+1];
+	uint64_t last_sleep;
+	uint64_t last_wake;
+} run_stats;
+
+/** Counts the messages of every type, and the batons released on the air (a
+ * retransmitted baton, which repeats the last baton frame of its board, is not
+ * released again).
+ *
+ * @param node The transmitting board.
+ * @param tx The transmitted frame.
+ */
+static void on_tx_start(const sim_node_t *node, const sim_tx_t *tx){
+	if(tx->len <= PKTIDX_HEADER || PACKET_TYPE(tx->data) >= NUM_OF_MSG_TYPES)
+		return;
+	run_stats.tx_by_type[PACKET_TYPE(tx->data)]++;
+	if(PACKET_TYPE(tx->data) != MSG_BATON)
+		return;
+	uint8_t *last = run_stats.last_baton_frame[node->id];
+	if(last[0] == tx->len && memcmp(last+1, tx->data, tx->len) == 0)
+		return;
+	last[0] = (uint8_t) tx->len;
+	memcpy(last+1, tx->data, tx->len);
+	if(run_stats.batons == 0)
+		run_stats.first_baton = tx->start;
+	run_stats.last_baton = tx->start;
+	run_stats.batons++;
+}
+
+/** Records when the last board woke up and went to sleep, and stops the
+ * simulation when every board sleeps (the listen windows of sleeping boards
+ * never let it run out of events).
+ *
+ * @param node The board.
+ */
+static void on_sleep_change(const sim_node_t *node){
+	if(!node->asleep){
+		run_stats.last_wake = node->woke_at;
+		return;
+	}
+	run_stats.last_sleep = node->slept_at;
+	for(int i=0;i<sim_num_nodes;i++)
+		if(!sim_nodes[i].asleep)
+			return;
+	sim_stop();
+}
+
+/** Initializes the application of a board (in the context of the board).
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_app_init(sim_node_t *node, void *ctx){
+	(void)ctx;
+	node->app_init();
+}
+
+/** Provisions the topology given in the command line to a board (in the
+ * context of the board), exactly as the 'provision' CLI command does.
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_provision(sim_node_t *node, void *ctx){
+	(void)ctx;
+	bool (*provision)(uint8_t, uint8_t, const char *, const char *) =
+			(bool (*)(uint8_t, uint8_t, const char *, const char *)) sim_symbol(node, "provision_topology");
+	if(!provision((uint8_t) node->id, (uint8_t) opts.boards, opts.edges, opts.path)){
+		fprintf(stderr, "edas_sim: the topology could not be provisioned to board %d (use -v for details).\n", node->id);
+		exit(1);
+	}
+}
+
+/** Executes the 'average' CLI command on a board (in the context of the board).
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_cli_average(sim_node_t *node, void *ctx){
+	(void)ctx;
+	void (*cli)(sl_cli_command_arg_t *) = (void (*)(sl_cli_command_arg_t *)) sim_symbol(node, "cli_avg_consensus");
+	sl_cli_command_arg_t args = { .argc = 0, .argv = NULL, .arg_ofs = 0 };
+	cli(&args);
+}
+
+/** Executes the 'gossip' CLI command on a board (in the context of the board).
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_cli_gossip(sim_node_t *node, void *ctx){
+	(void)ctx;
+	void (*cli)(sl_cli_command_arg_t *) = (void (*)(sl_cli_command_arg_t *)) sim_symbol(node, "cli_gossip");
+	sl_cli_command_arg_t args = { .argc = 0, .argv = NULL, .arg_ofs = 0 };
+	cli(&args);
+}
+
+/** Executes the 'track' CLI command on a board (in the context of the board).
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_cli_track(sim_node_t *node, void *ctx){
+	(void)ctx;
+	void (*cli)(sl_cli_command_arg_t *) = (void (*)(sl_cli_command_arg_t *)) sim_symbol(node, "cli_track");
+	sl_cli_command_arg_t args = { .argc = 0, .argv = NULL, .arg_ofs = 0 };
+	cli(&args);
+}
+
+/** Executes the 'discover' CLI command on a board (in the context of the board).
+ *
+ * @param node The board.
+ * @param ctx Is not used.
+ */
+static void call_cli_discover(sim_node_t *node, void *ctx){
+	(void)ctx;
+	void (*cli)(sl_cli_command_arg_t *) = (void (*)(sl_cli_command_arg_t *)) sim_symbol(node, "cli_discover");
+	sl_cli_command_arg_t args = { .argc = 0, .argv = NULL, .arg_ofs = 0 };
+	cli(&args);
+}
+
+/** Reads the energy estimate of the last run of a board (in the context of the
+ * board), or zeros if the board has not run.
+ *
+ * @param node The board.
+ * @param ctx The estimate, stored in an energy_estimate_t.
+ */
+static void call_energy_estimate(sim_node_t *node, void *ctx){
+	bool (*get)(energy_estimate_t *) = (bool (*)(energy_estimate_t *)) sim_symbol(node, "get_energy_estimate");
+	if(!get(ctx))
+		memset(ctx, 0, sizeof(energy_estimate_t));
+}
+
+/** Reads the energy estimate of the current idle period of a board (in the
+ * context of the board), or zeros if the board has not slept.
+ *
+ * @param node The board.
+ * @param ctx The estimate, stored in an energy_estimate_t.
+ */
+static void call_idle_estimate(sim_node_t *node, void *ctx){
+	bool (*get)(energy_estimate_t *) = (bool (*)(energy_estimate_t *)) sim_symbol(node, "get_idle_estimate");
+	if(!get(ctx))
+		memset(ctx, 0, sizeof(energy_estimate_t));
+}
+
+/** Prints the usage of the simulator.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options]\n"
+	       "Simulates EDAS boards and runs Average Consensus from the CLI of one of them.\n"
+	       "Without --boards/--edges/--path, the %d boards use the default topology of config/app_config.c.\n\n"
+	       "  --runs N             Number of independent runs (default 1).\n"
+	       "  --start-board ID     The board where the 'average' command is given (default 0).\n"
+	       "  --boards N           Provision N boards (at most %d) with the following topology.\n"
+	       "  --edges LIST         Edges of the graph to be provisioned (e.g., 0-1,1-2,2-3, with 3>0 for a one-way link from board 3 to board 0).\n"
+	       "  --path LIST          Baton path to be provisioned (e.g., 0,1,2,3,2,1), or auto (default) for the path generated from the graph.\n"
+	       "  --temperatures LIST  Comma-separated temperatures of the boards (default: simulated_temperatures).\n"
+	       "  --drifts LIST        Comma-separated drifts of the temperatures of the boards, in degrees per minute (default 0).\n"
+	       "  --seed N             Seed of the random generator (default 1).\n"
+	       "  --bitrate BPS        Bitrate of the radio (default 2400).\n"
+	       "  --overhead-bits N    Preamble, sync word & CRC bits of every frame (default 72).\n"
+	       "  --tx-warmup-us US    Delay from RAIL_StartTx() to the first bit on the air (default 100).\n"
+	       "  --latency-us US      Delay from the last bit on the air to the RX event (default 100).\n"
+	       "  --jitter-us US       Uniform extra latency in [0,US] (default 0).\n"
+	       "  --loss P             Probability that a receiver misses a frame (default 0).\n"
+	       "  --all-in-range       Every board hears every other board (default: only its neighbors in the graph).\n"
+	       "  --rssi DBM           RSSI of the frames of every link (default -60).\n"
+	       "  --weak-links LIST    Marginal links (e.g., 1-5), with a low RSSI and an extra loss in both directions.\n"
+	       "  --weak-rssi DBM      RSSI of the frames of the weak links (default -92).\n"
+	       "  --weak-loss P        Extra probability that a frame of a weak link is missed (default 0.5).\n"
+	       "  --discover           Discover the graph (the 'discover' CLI command) before Average Consensus.\n"
+	       "  --engine NAME        baton (the 'average' CLI command, default), gossip (the 'gossip' CLI command), both\n"
+	       "                       (every run with each engine, and a comparison of their means), or track (the 'track'\n"
+	       "                       CLI command, given again after --track-s to stop the tracking).\n"
+	       "  --track-s S          Simulated time of the tracking of the average, before it is stopped (default 120).\n"
+	       "  --rerun-s S          Give the command of the engine (not track) once before every run, which starts S seconds after\n"
+	       "                       the boards went to sleep (e.g., to measure USE_WARM_START).\n"
+	       "  --loop-us US         CPU time of a pass through the main loop (default 20).\n"
+	       "  --baud BAUD          Baud rate of the console; 0 makes logging free (default 115200).\n"
+	       "  --sensor-us US       Conversion time of the temperature sensor (default 23000).\n"
+	       "  --timeout-s S        Simulated time limit of every run (default 600).\n"
+	       "  --idle-s S           Simulate S seconds of idle boards after every run and report their current (default 0).\n"
+	       "  -v, --verbose        Print the console output of every board.\n"
+	       "  -h, --help           Print this message.\n", prog, DEFAULT_NUM_OF_BOARDS, MAX_NUM_OF_BOARDS);
+}
+
+/** Parses a comma-separated list of values of the boards (e.g., their
+ * temperatures).
+ *
+ * @param list The list.
+ * @param values Where the values are stored.
+ * @return True if exactly one value per board was parsed.
+ */
+static bool parse_values(const char *list, double *values){
+	int n = 0;
+	const char *p = list;
+	while(*p && n < opts.boards){
+		char *end;
+		values[n++] = strtod(p, &end);
+		if(end == p)
+			return false;
+		p = (*end == ',') ? end+1 : end;
+	}
+	return n == opts.boards && *p == '\0';
+}
+
+/** Parses a comma-separated list of weak links (e.g., 1-5,2-3).
+ *
+ * @param list The list.
+ * @return True if the list was parsed successfully.
+ */
+static bool parse_weak_links(const char *list){
+	const char *p = list;
+	while(*p){
+		char *end;
+		long a = strtol(p, &end, 10);
+		if(end == p || *end != '-' || a < 0 || a >= opts.boards)
+			return false;
+		p = end+1;
+		long b = strtol(p, &end, 10);
+		if(end == p || b < 0 || b >= opts.boards || a == b)
+			return false;
+		opts.weak[a][b] = opts.weak[b][a] = true;
+		if(*end && *end != ',')
+			return false;
+		p = (*end == ',') ? end+1 : end;
+	}
+	return true;
+}
+
+/** Prints the edges of the graph of a board, and its one-way links.
+ *
+ * @param node The board.
+ */
+static void print_graph(sim_node_t *node){
+	const bool (*graph)[MAX_NUM_OF_BOARDS] = sim_symbol(node, "graph");
+	const bool (*directed)[MAX_NUM_OF_BOARDS] = sim_symbol(node, "directed_graph");
+	for(int i=0;i<sim_num_nodes;i++)
+		for(int j=i+1;j<sim_num_nodes;j++)
+			if(graph[i][j])
+				printf(" %d-%d", i, j);
+	for(int i=0;i<sim_num_nodes;i++)
+		for(int j=0;j<sim_num_nodes;j++)
+			if(directed[j][i] && !graph[i][j])
+				printf(" %d>%d", i, j);
+}
+
+/** Discovers the graph from the CLI of the starting board, and prints the
+ * discovered graph. The statistics of the discovery are not included in the
+ * results of the run.
+ *
+ * @param start The time of the 'discover' command.
+ * @param limit The simulated time limit of the discovery.
+ * @return The time when the discovery was completed.
+ */
+static uint64_t discover(uint64_t start, uint64_t limit){
+	sim_call(&sim_nodes[opts.start_board], start, call_cli_discover, NULL);
+	uint64_t end = sim_run(start + limit);
+	uint32_t packets = 0;
+	for(int i=0;i<sim_num_nodes;i++)
+		packets += sim_nodes[i].stats.tx_packets;
+	bool same = true;
+	for(int i=1;i<sim_num_nodes;i++)
+		same = same && memcmp(sim_symbol(&sim_nodes[i], "graph"), sim_symbol(&sim_nodes[0], "graph"), sizeof(bool)*MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS) == 0;
+	printf("Discovery: %.3f ms, %u packets (LINKS %u), discovered graph:", (end - start)/1000.0, packets, run_stats.tx_by_type[MSG_LINKS]);
+	print_graph(&sim_nodes[opts.start_board]);
+	printf("%s\n", same ? "" : " (the graphs of the boards DIFFER)");
+
+	memset(&run_stats, 0, sizeof(run_stats));
+	for(int i=0;i<sim_num_nodes;i++)
+		memset(&sim_nodes[i].stats, 0, sizeof(sim_nodes[i].stats));
+	return end;
+}
+
+/** Executes a previous run of an engine from the CLI of the starting board,
+ * and prints its duration. The statistics of the previous run are not included
+ * in the results of the run.
+ *
+ * @param engine The engine of Average Consensus (not ENGINE_TRACK).
+ * @param start The time of the command.
+ * @param limit The simulated time limit of the previous run.
+ * @return The time when the boards went to sleep (or the time limit).
+ */
+static uint64_t previous_run(int engine, uint64_t start, uint64_t limit){
+	sim_call(&sim_nodes[opts.start_board], start, engine==ENGINE_GOSSIP ? call_cli_gossip : call_cli_average, NULL);
+	uint64_t end = sim_run(start + limit);
+	bool all_asleep = true;
+	for(int i=0;i<sim_num_nodes;i++)
+		all_asleep = all_asleep && sim_nodes[i].asleep;
+	if(all_asleep)
+		end = run_stats.last_sleep;
+	const uint8_t *iters = sim_symbol(&sim_nodes[opts.start_board], "consensus_iters");
+	printf("Previous run: %.3f ms (%d %s)%s\n", (end - start)/1000.0, *iters, engine==ENGINE_BATON ? "iterations" : "exchanges of the starting board",
+	       all_asleep ? "" : ", did NOT converge before the time limit");
+
+	memset(&run_stats, 0, sizeof(run_stats));
+	for(int i=0;i<sim_num_nodes;i++)
+		memset(&sim_nodes[i].stats, 0, sizeof(sim_nodes[i].stats));
+	return end;
+}
+
+/** Returns the directory of the executable, where the images of the boards are built.
+ *
+ * @param dir A buffer for the directory.
+ * @param size The size of the buffer.
+ */
+static void executable_dir(char *dir, size_t size){
+	ssize_t len = readlink("/proc/self/exe", dir, size-1);
+	if(len <= 0){
+		snprintf(dir, size, ".");
+		return;
+	}
+	dir[len] = '\0';
+	char *slash = strrchr(dir, '/');
+	if(slash)
+		*slash = '\0';
+}
+
+/** Executes a single run of the simulation and prints its results.
+ *
+ * @param run The index of the run.
+ * @param engine The engine of Average Consensus.
+ * @param totals Accumulates the time to converge (0), packets (1), baton-cycle latency (2), error (3), charge (4) and idle current (5) of the runs.
+ * @return True if the run converged before the time limit.
+ */
+static bool simulate(int run, int engine, double totals[6]){
+	char dir[PATH_MAX], path[PATH_MAX+32];
+	executable_dir(dir, sizeof(dir));
+
+	sim_init(opts.seed + run);
+	memset(&run_stats, 0, sizeof(run_stats));
+	for(int i=0;i<opts.boards;i++){
+		snprintf(path, sizeof(path), "%s/node_%d.so", dir, i);
+		sim_node_t *node = sim_load_node(path);
+		if(!node)
+			exit(1);
+		const float *simulated = sim_symbol(node, "simulated_temperatures");
+		const float *humidities = sim_symbol(node, "simulated_humidities");
+		node->temperature = opts.temperature_list ? opts.temperatures[i] : simulated[i];
+		node->temperature_drift = opts.drift_list ? opts.drifts[i]/60 : 0;
+		node->humidity = humidities[i];
+	}
+
+	//Power-on: every board (provisioned first, if requested) initializes itself and goes to sleep
+	for(int i=0;i<sim_num_nodes;i++){
+		if(opts.edges)
+			sim_call(&sim_nodes[i], 0, call_provision, NULL);
+		sim_call(&sim_nodes[i], 0, call_app_init, NULL);
+	}
+	uint64_t limit = (uint64_t)(opts.timeout_s*1e6);
+	uint64_t start = sim_run(limit);
+
+	const bool (*directed)[MAX_NUM_OF_BOARDS] = sim_symbol(&sim_nodes[0], "directed_graph");
+	for(int i=0;i<sim_num_nodes;i++){
+		for(int j=0;j<sim_num_nodes;j++){
+			sim_links[i][j] = directed[j][i]; //board j receives board i, also over a one-way link
+			sim_link_rssi[i][j] = (int8_t)(opts.weak[i][j] ? opts.weak_rssi : opts.rssi);
+			sim_link_loss[i][j] = opts.weak[i][j] ? opts.weak_loss : 0;
+		}
+	}
+	const uint8_t *length_of_baton_path = sim_symbol(&sim_nodes[0], "length_of_baton_path");
+
+	//The user discovers the graph (which changes the graph of the boards, but not the links of the radio)
+	if(opts.discover)
+		start = discover(start + 1000, limit);
+
+	//The user gives the same command earlier, and the boards go to sleep until the run
+	if(opts.rerun_s > 0)
+		start = previous_run(engine, start + 1000, limit) + (uint64_t)(opts.rerun_s*1e6) - 1000;
+
+	//The user gives the 'average' (or 'gossip', or 'track') command to the starting board
+	start += 1000;
+	sim_call(&sim_nodes[opts.start_board], start, engine==ENGINE_TRACK ? call_cli_track : engine==ENGINE_GOSSIP ? call_cli_gossip : call_cli_average, NULL);
+
+	//While the boards track the average, their errors are sampled every second, and the user stops them with a second 'track' command
+	double track_err = 0, track_mean_err = 0;
+	int track_samples = 0;
+	uint64_t track_end = start + (uint64_t)(opts.track_s*1e6);
+	for(uint64_t t=start+1000000;engine==ENGINE_TRACK && t<=track_end;t+=1000000){
+		sim_run(t);
+		double err = 0, now_mean = 0;
+		for(int i=0;i<sim_num_nodes;i++)
+			now_mean += sim_temperature(&sim_nodes[i], t)/sim_num_nodes;
+		for(int i=0;i<sim_num_nodes;i++){
+			const float (*states)[NUM_OF_QUANTITIES] = sim_symbol(&sim_nodes[i], "consensus_states");
+			if(fabs(states[i][QUANTITY_TEMPERATURE] - now_mean) > err)
+				err = fabs(states[i][QUANTITY_TEMPERATURE] - now_mean);
+		}
+		track_err = err;
+		if(t > start + (track_end-start)/2){ //After the initial convergence
+			track_mean_err += err;
+			track_samples++;
+		}
+	}
+	if(engine==ENGINE_TRACK){
+		sim_call(&sim_nodes[opts.start_board], track_end, call_cli_average, NULL); //Answered instantly
+		sim_call(&sim_nodes[opts.start_board], track_end, call_cli_track, NULL);
+	}
+	sim_run(start + limit);
+
+	bool all_asleep = true;
+	for(int i=0;i<sim_num_nodes;i++)
+		all_asleep = all_asleep && sim_nodes[i].asleep;
+	bool converged = all_asleep;
+
+	uint64_t end = converged ? run_stats.last_sleep : start + limit;
+	double mean[NUM_OF_QUANTITIES] = { 0 };
+	for(int i=0;i<sim_num_nodes;i++) //The temperatures when the boards went to sleep
+		for(int q=0;q<NUM_OF_QUANTITIES;q++)
+			mean[q] += (q==QUANTITY_HUMIDITY ? sim_nodes[i].humidity : sim_temperature(&sim_nodes[i], end))/sim_num_nodes;
+
+	sim_node_stats_t total = { 0 };
+	link_stats_t link = { 0 };
+	double max_err = 0;
+	for(int i=0;i<sim_num_nodes;i++){
+		const sim_node_stats_t *s = &sim_nodes[i].stats;
+		total.tx_packets += s->tx_packets;
+		total.tx_airtime_us += s->tx_airtime_us;
+		total.rx_lost += s->rx_lost;
+		total.rx_collided += s->rx_collided;
+		total.rx_overflows += s->rx_overflows;
+		total.rx_filtered += s->rx_filtered;
+		total.rx_too_long += s->rx_too_long;
+		total.log_chars += s->log_chars;
+		const link_stats_t *l = sim_symbol(&sim_nodes[i], "link_stats");
+		link.retransmissions += l->retransmissions;
+		link.failures += l->failures;
+		link.duplicates += l->duplicates;
+		const float (*states)[NUM_OF_QUANTITIES] = sim_symbol(&sim_nodes[i], "consensus_states");
+		for(int q=0;q<NUM_OF_QUANTITIES;q++){
+			double err = fabs(states[i][q] - mean[q]);
+			if(err > max_err)
+				max_err = err;
+		}
+	}
+	//The boards report the energy estimates of their runs (which have been stopped when they went to sleep)
+	static energy_estimate_t estimates[SIM_MAX_NODES];
+	for(int i=0;i<sim_num_nodes;i++)
+		sim_call(&sim_nodes[i], end, call_energy_estimate, &estimates[i]);
+	sim_run(end);
+	energy_estimate_t energy = { 0 };
+	for(int i=0;i<sim_num_nodes;i++){
+		for(int em=0;em<SL_POWER_MANAGER_EM3;em++)
+			energy.em[em] += estimates[i].em[em];
+		energy.rx += estimates[i].rx;
+		energy.tx += estimates[i].tx;
+		energy.radio_off += estimates[i].radio_off;
+		energy.charge_uc += estimates[i].charge_uc;
+	}
+
+	const uint8_t *iters = sim_symbol(&sim_nodes[opts.start_board], "consensus_iters");
+	double converge_ms = (end - start)/1000.0;
+	double wake_ms = run_stats.last_wake > start ? (run_stats.last_wake - start)/1000.0 : 0;
+	double cycle_ms = run_stats.batons > 1 ? (run_stats.last_baton - run_stats.first_baton)/1000.0/(run_stats.batons-1)*(*length_of_baton_path) : 0;
+
+	printf("Run %d (seed %llu, %s): %s\n", run+1, (unsigned long long)(opts.seed + run), engine_names[engine], converged ? "converged" : "did NOT converge before the time limit");
+	printf("  Time to converge:     %.3f ms (%d %s)\n", converge_ms, *iters, engine==ENGINE_BATON ? "iterations" : "exchanges of the starting board");
+	printf("  Wake-up latency:      %.3f ms (until the last board woke up)\n", wake_ms);
+	printf("  Packets sent:         %u (", total.tx_packets);
+	for(int t=0;t<NUM_OF_MSG_TYPES;t++)
+		printf("%s%s %u", t ? ", " : "", msg_names[t], run_stats.tx_by_type[t]);
+	printf(")\n");
+	printf("  Airtime:              %.3f ms\n", total.tx_airtime_us/1000.0);
+	printf("  Baton-cycle latency:  %.3f ms (%u batons)\n", cycle_ms, run_stats.batons);
+	printf("  Frames lost/collided: %u/%u (RX FIFO overflows: %u, dropped by the address filter: %u)\n", total.rx_lost, total.rx_collided, total.rx_overflows, total.rx_filtered);
+	if(total.rx_too_long)
+		printf("  Frames too long for the PHY: %u\n", total.rx_too_long);
+	printf("  Link layer:           %u retransmissions, %u messages given up, %u duplicates dropped\n", link.retransmissions, link.failures, link.duplicates);
+	printf("  Console output:       %llu characters\n", (unsigned long long) total.log_chars);
+	printf("  Energy modes:         EM0 %.3f ms, EM1 %.3f ms, EM2 %.3f ms (all boards)\n",
+	       energy.em[SL_POWER_MANAGER_EM0]/1000.0, energy.em[SL_POWER_MANAGER_EM1]/1000.0, energy.em[SL_POWER_MANAGER_EM2]/1000.0);
+	printf("  Radio:                RX %.3f ms, TX %.3f ms, off %.3f ms (all boards)\n", energy.rx/1000.0, energy.tx/1000.0, energy.radio_off/1000.0);
+	printf("  Estimated charge:     %.3f mC (all boards)\n", energy.charge_uc/1000.0);
+	printf("  True average:         ");
+	for(int q=0;q<NUM_OF_QUANTITIES;q++)
+		printf("%s%.4f", q ? "/" : "", mean[q]);
+	printf("%s\n", NUM_OF_QUANTITIES>1 ? " (temperature/humidity)" : "");
+	printf("  Estimates:           ");
+	for(int i=0;i<sim_num_nodes;i++){
+		const float (*states)[NUM_OF_QUANTITIES] = sim_symbol(&sim_nodes[i], "consensus_states");
+		for(int q=0;q<NUM_OF_QUANTITIES;q++)
+			printf("%s%.4f", q ? "/" : " ", states[i][q]);
+	}
+	printf(" (max error %.4f)\n", max_err);
+	if(engine==ENGINE_TRACK)
+		printf("  Tracking error:       %.4f after %.1f s (mean %.4f over the second half)\n", track_err, opts.track_s, track_samples ? track_mean_err/track_samples : 0);
+
+	//The boards stay idle, and report the energy estimates of their idle periods
+	if(opts.idle_s > 0){
+		uint64_t idle_end = end + (uint64_t)(opts.idle_s*1e6);
+		for(int i=0;i<sim_num_nodes;i++)
+			sim_call(&sim_nodes[i], idle_end, call_idle_estimate, &estimates[i]);
+		sim_run(idle_end);
+		double current_ua = 0;
+		for(int i=0;i<sim_num_nodes;i++)
+			if(estimates[i].duration)
+				current_ua += estimates[i].charge_uc/estimates[i].duration*1e6;
+		current_ua /= sim_num_nodes;
+		printf("  Idle current:         %.3f uA (mean of the boards over %.1f s)\n", current_ua, opts.idle_s);
+		totals[5] += current_ua;
+	}
+
+	totals[0] += converge_ms;
+	totals[1] += total.tx_packets;
+	totals[2] += cycle_ms;
+	totals[3] += max_err;
+	totals[4] += energy.charge_uc/1000.0;
+	return converged;
+}
+
+/** Parses the command line and executes the requested runs.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 if every run converged, 1 otherwise.
+ */
+int main(int argc, char **argv){
+	sim_radio = (sim_radio_config_t){ .bitrate = 2400, .overhead_bits = 72, .tx_warmup_us = 100, .latency_us = 100, .max_frame_bytes = RADIO_MAX_PACKET_LENGTH };
+	sim_platform = (sim_platform_config_t){ .loop_us = 20, .baud = 115200, .sensor_us = 23000 };
+	sim_observer = (sim_observer_t){ .on_tx_start = on_tx_start, .on_sleep_change = on_sleep_change };
+
+	static const struct option long_opts[] = {
+		{ "runs", required_argument, NULL, 'r' },
+		{ "start-board", required_argument, NULL, 's' },
+		{ "boards", required_argument, NULL, 'n' },
+		{ "edges", required_argument, NULL, 'e' },
+		{ "path", required_argument, NULL, 'P' },
+		{ "temperatures", required_argument, NULL, 't' },
+		{ "drifts", required_argument, NULL, 'd' },
+		{ "seed", required_argument, NULL, 'S' },
+		{ "bitrate", required_argument, NULL, 'b' },
+		{ "overhead-bits", required_argument, NULL, 'o' },
+		{ "tx-warmup-us", required_argument, NULL, 'w' },
+		{ "latency-us", required_argument, NULL, 'l' },
+		{ "jitter-us", required_argument, NULL, 'j' },
+		{ "loss", required_argument, NULL, 'p' },
+		{ "all-in-range", no_argument, NULL, 'a' },
+		{ "rssi", required_argument, NULL, 'R' },
+		{ "weak-links", required_argument, NULL, 'W' },
+		{ "weak-rssi", required_argument, NULL, 'X' },
+		{ "weak-loss", required_argument, NULL, 'Y' },
+		{ "discover", no_argument, NULL, 'D' },
+		{ "engine", required_argument, NULL, 'E' },
+		{ "track-s", required_argument, NULL, 'k' },
+		{ "rerun-s", required_argument, NULL, 'x' },
+		{ "loop-us", required_argument, NULL, 'L' },
+		{ "baud", required_argument, NULL, 'B' },
+		{ "sensor-us", required_argument, NULL, 'm' },
+		{ "timeout-s", required_argument, NULL, 'T' },
+		{ "idle-s", required_argument, NULL, 'I' },
+		{ "verbose", no_argument, NULL, 'v' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "vh", long_opts, NULL)) != -1){
+		switch(c){
+		case 'r': opts.runs = atoi(optarg); break;
+		case 's': opts.start_board = atoi(optarg); break;
+		case 'n': opts.boards = atoi(optarg); break;
+		case 'e': opts.edges = optarg; break;
+		case 'P': opts.path = optarg; break;
+		case 't': opts.temperature_list = optarg; break;
+		case 'd': opts.drift_list = optarg; break;
+		case 'S': opts.seed = strtoull(optarg, NULL, 0); break;
+		case 'b': sim_radio.bitrate = strtoul(optarg, NULL, 0); break;
+		case 'o': sim_radio.overhead_bits = strtoul(optarg, NULL, 0); break;
+		case 'w': sim_radio.tx_warmup_us = strtoul(optarg, NULL, 0); break;
+		case 'l': sim_radio.latency_us = strtoul(optarg, NULL, 0); break;
+		case 'j': sim_radio.jitter_us = strtoul(optarg, NULL, 0); break;
+		case 'p': sim_radio.loss = atof(optarg); break;
+		case 'a': sim_radio.all_in_range = true; break;
+		case 'R': opts.rssi = atoi(optarg); break;
+		case 'W': opts.weak_links = optarg; break;
+		case 'X': opts.weak_rssi = atoi(optarg); break;
+		case 'Y': opts.weak_loss = atof(optarg); break;
+		case 'D': opts.discover = true; break;
+		case 'E':
+			opts.engines = strcmp(optarg, "both") == 0 ? BOTH_ENGINES : 0;
+			for(int e=0;e<NUM_OF_ENGINES;e++)
+				if(strcmp(optarg, engine_names[e]) == 0)
+					opts.engines = 1 << e;
+			break;
+		case 'L': sim_platform.loop_us = strtoul(optarg, NULL, 0); break;
+		case 'B': sim_platform.baud = strtoul(optarg, NULL, 0); break;
+		case 'm': sim_platform.sensor_us = strtoul(optarg, NULL, 0); break;
+		case 'T': opts.timeout_s = atof(optarg); break;
+		case 'k': opts.track_s = atof(optarg); break;
+		case 'x': opts.rerun_s = atof(optarg); break;
+		case 'I': opts.idle_s = atof(optarg); break;
+		case 'v': sim_platform.verbose = true; break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	if(opts.runs < 1 || opts.boards < 2 || opts.boards > MAX_NUM_OF_BOARDS || opts.start_board < 0
+			|| opts.start_board >= opts.boards || sim_radio.bitrate == 0 || opts.engines == 0 || (opts.path && !opts.edges)
+			|| (!opts.edges && opts.boards != DEFAULT_NUM_OF_BOARDS) || (opts.rerun_s > 0 && ((opts.engines >> ENGINE_TRACK) & 1))){
+		usage(argv[0]);
+		return 1;
+	}
+	if(opts.edges && !opts.path)
+		opts.path = "auto";
+	if(opts.weak_links && !parse_weak_links(opts.weak_links)){
+		fprintf(stderr, "edas_sim: invalid list of weak links '%s'.\n", opts.weak_links);
+		return 1;
+	}
+	if(opts.temperature_list && !parse_values(opts.temperature_list, opts.temperatures)){
+		fprintf(stderr, "edas_sim: exactly %d temperatures are required.\n", opts.boards);
+		return 1;
+	}
+	if(opts.drift_list && !parse_values(opts.drift_list, opts.drifts)){
+		fprintf(stderr, "edas_sim: exactly %d drifts are required.\n", opts.boards);
+		return 1;
+	}
+
+	double totals[NUM_OF_ENGINES][6] = { { 0 } };
+	int converged[NUM_OF_ENGINES] = { 0 }, all_converged = 0, engines = 0;
+	for(int run=0;run<opts.runs;run++){
+		for(int e=0;e<NUM_OF_ENGINES;e++){
+			if((opts.engines >> e) & 1)
+				converged[e] += simulate(run, e, totals[e]);
+		}
+	}
+
+	for(int e=0;e<NUM_OF_ENGINES;e++){
+		if(!((opts.engines >> e) & 1))
+			continue;
+		engines++;
+		all_converged += converged[e];
+		if(opts.runs == 1 && opts.engines == 1 << e)
+			continue;
+		printf("\nSummary of %d runs with the %s engine (%d converged):\n", opts.runs, engine_names[e], converged[e]);
+		printf("  Mean time to converge:    %.3f ms\n", totals[e][0]/opts.runs);
+		printf("  Mean packets sent:        %.1f\n", totals[e][1]/opts.runs);
+		if(e == ENGINE_BATON)
+			printf("  Mean baton-cycle latency: %.3f ms\n", totals[e][2]/opts.runs);
+		printf("  Mean max error:           %.4f\n", totals[e][3]/opts.runs);
+		printf("  Mean estimated charge:    %.3f mC\n", totals[e][4]/opts.runs);
+		if(opts.idle_s > 0)
+			printf("  Mean idle current:        %.3f uA\n", totals[e][5]/opts.runs);
+	}
+	if(opts.engines == BOTH_ENGINES && totals[ENGINE_GOSSIP][0] > 0)
+		printf("\nGossip vs baton: %.2fx the time to converge, %.2fx the packets, %.2fx the charge\n",
+		       totals[ENGINE_GOSSIP][0]/totals[ENGINE_BATON][0], totals[ENGINE_GOSSIP][1]/totals[ENGINE_BATON][1], totals[ENGINE_GOSSIP][4]/totals[ENGINE_BATON][4]);
+	return all_converged == engines*opts.runs ? 0 : 1;
+}
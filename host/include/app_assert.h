@@ -0,0 +1,26 @@
+/***************************************************************************//**
+ * @file app_assert.h
+ * @brief Host stand-in for the app_assert component. A failed assertion stops
+ * the whole simulation.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_ASSERT_H
+#define APP_ASSERT_H
+
+#include "app_log.h"
+
+/** Reports a failed assertion of the current board and aborts the simulation.
+ *
+ * @param file The source file of the assertion.
+ * @param line The line of the assertion.
+ * @param fmt A printf-like format string, followed by its arguments.
+ */
+void sim_assert_failed(const char *file, int line, const char *fmt, ...) __attribute__((noreturn, format(printf, 3, 4)));
+
+#define app_assert(expr, ...)                                   \
+	do {                                                        \
+		if(!(expr))                                             \
+			sim_assert_failed(__FILE__, __LINE__, __VA_ARGS__); \
+	} while(0)
+
+#endif  // APP_ASSERT_H
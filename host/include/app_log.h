@@ -0,0 +1,35 @@
+/***************************************************************************//**
+ * @file app_log.h
+ * @brief Host stand-in for the app_log component. Every message is forwarded to
+ * the simulator, which charges its transmission time over the console UART to
+ * the simulated board and optionally prints it.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+#define APP_LOG_LEVEL_DEBUG    4
+#define APP_LOG_LEVEL_INFO     3
+#define APP_LOG_LEVEL_WARNING  2
+#define APP_LOG_LEVEL_ERROR    1
+#define APP_LOG_LEVEL_CRITICAL 0
+
+/** Writes a log message of the current board to the simulated console.
+ *
+ * @param level The log level of the message.
+ * @param fmt A printf-like format string, followed by its arguments.
+ */
+void sim_log(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#define app_log(...) sim_log(APP_LOG_LEVEL_INFO, __VA_ARGS__)
+#define app_log_debug(...) sim_log(APP_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define app_log_info(...) sim_log(APP_LOG_LEVEL_INFO, __VA_ARGS__)
+#define app_log_warning(...) sim_log(APP_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define app_log_error(...) sim_log(APP_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define app_log_critical(...) sim_log(APP_LOG_LEVEL_CRITICAL, __VA_ARGS__)
+
+#endif  // APP_LOG_H
@@ -0,0 +1,17 @@
+/***************************************************************************//**
+ * @file em_chip.h
+ * @brief Host stand-in for the chip-level functions of emlib.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef EM_CHIP_H
+#define EM_CHIP_H
+
+#include <stdint.h>
+
+/** Returns the unique number of the simulated board.
+ *
+ * @return The unique number of the board.
+ */
+uint64_t SYSTEM_GetUnique(void);
+
+#endif  // EM_CHIP_H
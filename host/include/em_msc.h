@@ -0,0 +1,39 @@
+/***************************************************************************//**
+ * @file em_msc.h
+ * @brief Host stand-in for the Memory System Controller (flash) functions of
+ * emlib. Every simulated board has its own user-data page, which behaves like
+ * the flash: an erased page reads 0xFF and writes can only clear bits.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef EM_MSC_H
+#define EM_MSC_H
+
+#include <stdint.h>
+
+///The size of a flash page.
+#define FLASH_PAGE_SIZE 2048U
+
+///The status codes of the MSC functions.
+typedef enum {
+	mscReturnOk          = 0,
+	mscReturnInvalidAddr = -1,
+	mscReturnLocked      = -2,
+	mscReturnTimeOut     = -3,
+	mscReturnUnaligned   = -4
+} MSC_Status_TypeDef;
+
+/** Returns the user-data page of the simulated board which is currently executed.
+ *
+ * @return The user-data page.
+ */
+uint8_t *sim_userdata(void);
+
+///The base address of the user-data page.
+#define USERDATA_BASE ((uintptr_t) sim_userdata())
+
+void MSC_Init(void);
+void MSC_Deinit(void);
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress);
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes);
+
+#endif  // EM_MSC_H
@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @file rail.h
+ * @brief Host stand-in for the RAIL API. The functions are implemented by the
+ * simulated radio of the host simulator (see host/sim_rail.c).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef RAIL_H
+#define RAIL_H
+
+#include <string.h>
+#include "rail_types.h"
+
+RAIL_Time_t RAIL_GetTime(void);
+
+bool RAIL_ConfigMultiTimer(bool enable);
+RAIL_Status_t RAIL_SetMultiTimer(RAIL_MultiTimer_t *tmr, RAIL_Time_t expirationTime, RAIL_TimeMode_t expirationMode, RAIL_MultiTimerCallback_t callback, void *cbArg);
+bool RAIL_CancelMultiTimer(RAIL_MultiTimer_t *tmr);
+bool RAIL_IsMultiTimerRunning(RAIL_MultiTimer_t *tmr);
+
+RAIL_Status_t RAIL_InitPowerManager(void);
+RAIL_Status_t RAIL_Calibrate(RAIL_Handle_t railHandle, RAIL_CalValues_t *calValues, RAIL_CalMask_t calForce);
+
+uint16_t RAIL_SetTxFifo(RAIL_Handle_t railHandle, uint8_t *addr, uint16_t initLength, uint16_t size);
+uint16_t RAIL_WriteTxFifo(RAIL_Handle_t railHandle, const uint8_t *dataPtr, uint16_t writeLength, bool reset);
+
+RAIL_Status_t RAIL_PrepareChannel(RAIL_Handle_t railHandle, uint16_t channel);
+RAIL_Status_t RAIL_StartTx(RAIL_Handle_t railHandle, uint16_t channel, RAIL_TxOptions_t options, const RAIL_SchedulerInfo_t *schedulerInfo);
+RAIL_Status_t RAIL_StartRx(RAIL_Handle_t railHandle, uint16_t channel, const RAIL_SchedulerInfo_t *schedulerInfo);
+RAIL_Status_t RAIL_ScheduleRx(RAIL_Handle_t railHandle, uint16_t channel, const RAIL_ScheduleRxConfig_t *cfg, const RAIL_SchedulerInfo_t *schedulerInfo);
+void RAIL_Idle(RAIL_Handle_t railHandle, RAIL_IdleMode_t mode, bool wait);
+
+RAIL_RxPacketHandle_t RAIL_HoldRxPacket(RAIL_Handle_t railHandle);
+RAIL_RxPacketHandle_t RAIL_GetRxPacketInfo(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketInfo_t *pPacketInfo);
+RAIL_Status_t RAIL_ReleaseRxPacket(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle);
+RAIL_Status_t RAIL_GetRxPacketDetailsAlt(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketDetails_t *pPacketDetails);
+RAIL_Status_t RAIL_GetRxTimePreambleStartAlt(RAIL_Handle_t railHandle, RAIL_RxPacketDetails_t *pPacketDetails);
+
+RAIL_Status_t RAIL_ConfigAutoAck(RAIL_Handle_t railHandle, const RAIL_AutoAckConfig_t *config);
+RAIL_Status_t RAIL_WriteAutoAckFifo(RAIL_Handle_t railHandle, const uint8_t *ackData, uint8_t ackDataLen);
+RAIL_Status_t RAIL_CancelAutoAck(RAIL_Handle_t railHandle);
+
+RAIL_Status_t RAIL_ConfigAddressFilter(RAIL_Handle_t railHandle, const RAIL_AddrConfig_t *addrConfig);
+RAIL_Status_t RAIL_SetAddressFilterAddress(RAIL_Handle_t railHandle, uint8_t field, uint8_t index, const uint8_t *value, bool enable);
+bool RAIL_EnableAddressFilter(RAIL_Handle_t railHandle, bool enable);
+
+uint16_t RAIL_GetRadioEntropy(RAIL_Handle_t railHandle, uint8_t *buffer, uint16_t bytes);
+
+/** Copies a received packet (described by its packet info) to a buffer of the
+ * application, exactly as the inline function of the SDK does.
+ *
+ * @param pDest The buffer where the packet will be copied.
+ * @param pPacketInfo The information of the packet to be copied.
+ */
+static inline void RAIL_CopyRxPacket(uint8_t *pDest, const RAIL_RxPacketInfo_t *pPacketInfo){
+	memcpy(pDest, pPacketInfo->firstPortionData, pPacketInfo->firstPortionBytes);
+	if(pPacketInfo->lastPortionData != NULL)
+		memcpy(pDest + pPacketInfo->firstPortionBytes, pPacketInfo->lastPortionData, pPacketInfo->packetBytes - pPacketInfo->firstPortionBytes);
+}
+
+#endif  // RAIL_H
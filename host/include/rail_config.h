@@ -0,0 +1,13 @@
+/***************************************************************************//**
+ * @file rail_config.h
+ * @brief Host stand-in for the generated radio configuration. The airtime of
+ * the packets is configured from the command line of the simulator instead.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef __RAIL_CONFIG_H__
+#define __RAIL_CONFIG_H__
+
+#include <stdint.h>
+#include "rail_types.h"
+
+#endif  // __RAIL_CONFIG_H__
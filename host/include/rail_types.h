@@ -0,0 +1,295 @@
+/***************************************************************************//**
+ * @file rail_types.h
+ * @brief Host stand-in for the RAIL type definitions. Only the types, events
+ * and constants used by the application are provided, with the same names and
+ * semantics as in the Gecko SDK.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef RAIL_TYPES_H
+#define RAIL_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+///A handle of a RAIL instance. The simulator uses it to identify the simulated board.
+typedef void *RAIL_Handle_t;
+
+///A time value in microseconds, wrapping around like the radio's timer.
+typedef uint32_t RAIL_Time_t;
+
+///The status codes returned by the RAIL functions.
+typedef enum {
+	RAIL_STATUS_NO_ERROR,
+	RAIL_STATUS_INVALID_PARAMETER,
+	RAIL_STATUS_INVALID_STATE,
+	RAIL_STATUS_INVALID_CALL,
+	RAIL_STATUS_SUSPENDED,
+	RAIL_STATUS_SCHED_ERROR
+} RAIL_Status_t;
+
+///Determines how a time value passed to a timer or a scheduled operation is interpreted.
+typedef enum {
+	RAIL_TIME_ABSOLUTE,
+	RAIL_TIME_DELAY,
+	RAIL_TIME_DISABLED
+} RAIL_TimeMode_t;
+
+///Determines how the radio is turned off by RAIL_Idle().
+typedef enum {
+	RAIL_IDLE,
+	RAIL_IDLE_ABORT,
+	RAIL_IDLE_FORCE_SHUTDOWN,
+	RAIL_IDLE_FORCE_SHUTDOWN_CLEAR_FLAGS
+} RAIL_IdleMode_t;
+
+///The radio events, as a bitmask.
+typedef uint64_t RAIL_Events_t;
+
+///The bit positions of the radio events (same ordering as in the SDK).
+typedef enum {
+	RAIL_EVENT_RSSI_AVERAGE_DONE_SHIFT = 0,
+	RAIL_EVENT_RX_ACK_TIMEOUT_SHIFT,
+	RAIL_EVENT_RX_FIFO_ALMOST_FULL_SHIFT,
+	RAIL_EVENT_RX_PACKET_RECEIVED_SHIFT,
+	RAIL_EVENT_RX_PREAMBLE_LOST_SHIFT,
+	RAIL_EVENT_RX_PREAMBLE_DETECT_SHIFT,
+	RAIL_EVENT_RX_SYNC1_DETECT_SHIFT,
+	RAIL_EVENT_RX_SYNC2_DETECT_SHIFT,
+	RAIL_EVENT_RX_FRAME_ERROR_SHIFT,
+	RAIL_EVENT_RX_FIFO_FULL_SHIFT,
+	RAIL_EVENT_RX_FIFO_OVERFLOW_SHIFT,
+	RAIL_EVENT_RX_ADDRESS_FILTERED_SHIFT,
+	RAIL_EVENT_RX_TIMEOUT_SHIFT,
+	RAIL_EVENT_SCHEDULED_RX_STARTED_SHIFT,
+	RAIL_EVENT_RX_SCHEDULED_RX_END_SHIFT,
+	RAIL_EVENT_RX_SCHEDULED_RX_MISSED_SHIFT,
+	RAIL_EVENT_RX_PACKET_ABORTED_SHIFT,
+	RAIL_EVENT_RX_FILTER_PASSED_SHIFT,
+	RAIL_EVENT_RX_TIMING_LOST_SHIFT,
+	RAIL_EVENT_RX_TIMING_DETECT_SHIFT,
+	RAIL_EVENT_RX_CHANNEL_HOPPING_COMPLETE_SHIFT,
+	RAIL_EVENT_IEEE802154_DATA_REQUEST_COMMAND_SHIFT,
+	RAIL_EVENT_ZWAVE_BEAM_SHIFT,
+	RAIL_EVENT_TX_FIFO_ALMOST_EMPTY_SHIFT,
+	RAIL_EVENT_TX_PACKET_SENT_SHIFT,
+	RAIL_EVENT_TXACK_PACKET_SENT_SHIFT,
+	RAIL_EVENT_TX_ABORTED_SHIFT,
+	RAIL_EVENT_TXACK_ABORTED_SHIFT,
+	RAIL_EVENT_TX_BLOCKED_SHIFT,
+	RAIL_EVENT_TXACK_BLOCKED_SHIFT,
+	RAIL_EVENT_TX_UNDERFLOW_SHIFT,
+	RAIL_EVENT_TXACK_UNDERFLOW_SHIFT,
+	RAIL_EVENT_TX_CHANNEL_CLEAR_SHIFT,
+	RAIL_EVENT_TX_CHANNEL_BUSY_SHIFT,
+	RAIL_EVENT_TX_CCA_RETRY_SHIFT,
+	RAIL_EVENT_TX_START_CCA_SHIFT,
+	RAIL_EVENT_TX_STARTED_SHIFT,
+	RAIL_EVENT_TX_SCHEDULED_TX_MISSED_SHIFT,
+	RAIL_EVENT_CONFIG_UNSCHEDULED_SHIFT,
+	RAIL_EVENT_CONFIG_SCHEDULED_SHIFT,
+	RAIL_EVENT_SCHEDULER_STATUS_SHIFT,
+	RAIL_EVENT_CAL_NEEDED_SHIFT
+} RAIL_EventsShift_t;
+
+#define RAIL_EVENTS_NONE 0ULL
+#define RAIL_EVENT_RX_ACK_TIMEOUT (1ULL << RAIL_EVENT_RX_ACK_TIMEOUT_SHIFT)
+#define RAIL_EVENT_RX_PACKET_RECEIVED (1ULL << RAIL_EVENT_RX_PACKET_RECEIVED_SHIFT)
+#define RAIL_EVENT_RX_FRAME_ERROR (1ULL << RAIL_EVENT_RX_FRAME_ERROR_SHIFT)
+#define RAIL_EVENT_RX_FIFO_OVERFLOW (1ULL << RAIL_EVENT_RX_FIFO_OVERFLOW_SHIFT)
+#define RAIL_EVENT_RX_ADDRESS_FILTERED (1ULL << RAIL_EVENT_RX_ADDRESS_FILTERED_SHIFT)
+#define RAIL_EVENT_SCHEDULED_RX_STARTED (1ULL << RAIL_EVENT_SCHEDULED_RX_STARTED_SHIFT)
+#define RAIL_EVENT_RX_SCHEDULED_RX_END (1ULL << RAIL_EVENT_RX_SCHEDULED_RX_END_SHIFT)
+#define RAIL_EVENT_RX_SCHEDULED_RX_MISSED (1ULL << RAIL_EVENT_RX_SCHEDULED_RX_MISSED_SHIFT)
+#define RAIL_EVENT_RX_PACKET_ABORTED (1ULL << RAIL_EVENT_RX_PACKET_ABORTED_SHIFT)
+#define RAIL_EVENT_TX_PACKET_SENT (1ULL << RAIL_EVENT_TX_PACKET_SENT_SHIFT)
+#define RAIL_EVENT_TXACK_PACKET_SENT (1ULL << RAIL_EVENT_TXACK_PACKET_SENT_SHIFT)
+#define RAIL_EVENT_TXACK_ABORTED (1ULL << RAIL_EVENT_TXACK_ABORTED_SHIFT)
+#define RAIL_EVENT_TXACK_BLOCKED (1ULL << RAIL_EVENT_TXACK_BLOCKED_SHIFT)
+#define RAIL_EVENT_TXACK_UNDERFLOW (1ULL << RAIL_EVENT_TXACK_UNDERFLOW_SHIFT)
+#define RAIL_EVENT_TX_ABORTED (1ULL << RAIL_EVENT_TX_ABORTED_SHIFT)
+#define RAIL_EVENT_TX_BLOCKED (1ULL << RAIL_EVENT_TX_BLOCKED_SHIFT)
+#define RAIL_EVENT_TX_UNDERFLOW (1ULL << RAIL_EVENT_TX_UNDERFLOW_SHIFT)
+#define RAIL_EVENT_TX_CHANNEL_BUSY (1ULL << RAIL_EVENT_TX_CHANNEL_BUSY_SHIFT)
+#define RAIL_EVENT_TX_SCHEDULED_TX_MISSED (1ULL << RAIL_EVENT_TX_SCHEDULED_TX_MISSED_SHIFT)
+#define RAIL_EVENT_CAL_NEEDED (1ULL << RAIL_EVENT_CAL_NEEDED_SHIFT)
+
+///All events which mark the end of a receive operation.
+#define RAIL_EVENTS_RX_COMPLETION (RAIL_EVENT_RX_PACKET_RECEIVED    \
+                                   | RAIL_EVENT_RX_PACKET_ABORTED   \
+                                   | RAIL_EVENT_RX_FRAME_ERROR      \
+                                   | RAIL_EVENT_RX_FIFO_OVERFLOW    \
+                                   | RAIL_EVENT_RX_ADDRESS_FILTERED \
+                                   | RAIL_EVENT_RX_SCHEDULED_RX_MISSED)
+
+///All events which mark the end of a transmit operation.
+#define RAIL_EVENTS_TX_COMPLETION (RAIL_EVENT_TX_PACKET_SENT    \
+                                   | RAIL_EVENT_TX_ABORTED      \
+                                   | RAIL_EVENT_TX_BLOCKED      \
+                                   | RAIL_EVENT_TX_UNDERFLOW    \
+                                   | RAIL_EVENT_TX_CHANNEL_BUSY \
+                                   | RAIL_EVENT_TX_SCHEDULED_TX_MISSED)
+
+///All events which mark the end of the transmission of an ACK.
+#define RAIL_EVENTS_TXACK_COMPLETION (RAIL_EVENT_TXACK_PACKET_SENT \
+                                      | RAIL_EVENT_TXACK_ABORTED   \
+                                      | RAIL_EVENT_TXACK_BLOCKED   \
+                                      | RAIL_EVENT_TXACK_UNDERFLOW)
+
+///Options of a transmit operation, as a bitmask.
+typedef uint32_t RAIL_TxOptions_t;
+#define RAIL_TX_OPTIONS_NONE 0UL
+#define RAIL_TX_OPTIONS_DEFAULT RAIL_TX_OPTIONS_NONE
+///The radio waits for an ACK after the transmission (see RAIL_ConfigAutoAck()): the first packet received within the ACK timeout is reported as an ACK, otherwise RAIL_EVENT_RX_ACK_TIMEOUT is raised.
+#define RAIL_TX_OPTION_WAIT_FOR_ACK (1UL << 0)
+
+///The states of the radio, as a bitmask (only the states of the transitions are used by the simulator).
+typedef enum RAIL_RadioState {
+	RAIL_RF_STATE_INACTIVE = 0u,
+	RAIL_RF_STATE_ACTIVE = (1u << 0),
+	RAIL_RF_STATE_RX = (1u << 1),
+	RAIL_RF_STATE_TX = (1u << 2),
+	RAIL_RF_STATE_IDLE = (RAIL_RF_STATE_ACTIVE),
+	RAIL_RF_STATE_RX_ACTIVE = (RAIL_RF_STATE_RX | RAIL_RF_STATE_ACTIVE),
+	RAIL_RF_STATE_TX_ACTIVE = (RAIL_RF_STATE_TX | RAIL_RF_STATE_ACTIVE)
+} RAIL_RadioState_t;
+
+///The states of the radio after an operation (the simulator always receives after a transmission, see sim_rail.c).
+typedef struct RAIL_StateTransitions {
+	RAIL_RadioState_t success;
+	RAIL_RadioState_t error;
+} RAIL_StateTransitions_t;
+
+///The configuration of the auto-ACK: the radio sends the contents of the ACK FIFO after every received packet (unless RAIL_CancelAutoAck() is called in its RAIL_EVENT_RX_PACKET_RECEIVED), and waits for an ACK after a transmission with RAIL_TX_OPTION_WAIT_FOR_ACK.
+typedef struct RAIL_AutoAckConfig {
+	bool enable;
+	uint16_t ackTimeout; ///< The time to wait for an ACK after a transmission, in microseconds.
+	RAIL_StateTransitions_t rxTransitions;
+	RAIL_StateTransitions_t txTransitions;
+} RAIL_AutoAckConfig_t;
+
+///The maximum number of fields of the address filter.
+#define ADDRCONFIG_MAX_ADDRESS_FIELDS 2
+///The number of addresses of every field of the address filter.
+#define ADDRESS_FILTER_ENTRIES 4
+///The match table of an address filter with a single field: a packet is accepted if its first field matches any enabled address.
+#define ADDRCONFIG_MATCH_TABLE_SINGLE_FIELD (0x1FFFFFE)
+
+///The configuration of the address filter: the offset & size (in bytes) of every field (the simulator supports a single field, of up to 8 bytes, whose offset is counted from the start of the packet).
+typedef struct RAIL_AddrConfig {
+	const uint8_t *offsets;
+	const uint8_t *sizes;
+	uint32_t matchTable;
+} RAIL_AddrConfig_t;
+
+///Information for the radio scheduler (ignored by the simulator).
+typedef struct RAIL_SchedulerInfo {
+	uint8_t priority;
+	RAIL_Time_t slipTime;
+	RAIL_Time_t transactionTime;
+} RAIL_SchedulerInfo_t;
+
+///The configuration of a scheduled receive window.
+typedef struct RAIL_ScheduleRxConfig {
+	RAIL_Time_t start;
+	RAIL_TimeMode_t startMode;
+	RAIL_Time_t end;
+	RAIL_TimeMode_t endMode;
+	uint8_t rxTransitionEndSchedule;
+	uint8_t hardWindowEnd;
+} RAIL_ScheduleRxConfig_t;
+
+///The alignment type of the TX & RX FIFOs.
+#define RAIL_FIFO_ALIGNMENT_TYPE uint8_t
+///The alignment of the TX & RX FIFOs.
+#define RAIL_FIFO_ALIGNMENT (sizeof(RAIL_FIFO_ALIGNMENT_TYPE))
+
+///A handle of a packet held in the receive FIFO.
+typedef const void *RAIL_RxPacketHandle_t;
+#define RAIL_RX_PACKET_HANDLE_INVALID (NULL)
+#define RAIL_RX_PACKET_HANDLE_OLDEST ((RAIL_RxPacketHandle_t) 1)
+#define RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE ((RAIL_RxPacketHandle_t) 2)
+#define RAIL_RX_PACKET_HANDLE_NEWEST ((RAIL_RxPacketHandle_t) 3)
+
+///The status of a packet held in the receive FIFO.
+typedef enum {
+	RAIL_RX_PACKET_NONE = 0,
+	RAIL_RX_PACKET_ABORT_FORMAT,
+	RAIL_RX_PACKET_ABORT_FILTERED,
+	RAIL_RX_PACKET_ABORT_ABORTED,
+	RAIL_RX_PACKET_ABORT_OVERFLOW,
+	RAIL_RX_PACKET_ABORT_CRC_ERROR,
+	RAIL_RX_PACKET_READY_CRC_ERROR,
+	RAIL_RX_PACKET_READY_SUCCESS,
+	RAIL_RX_PACKET_RECEIVING
+} RAIL_RxPacketStatus_t;
+
+///Basic information about a packet held in the receive FIFO.
+typedef struct RAIL_RxPacketInfo {
+	RAIL_RxPacketStatus_t packetStatus;
+	uint16_t packetBytes;
+	uint16_t firstPortionBytes;
+	uint8_t *firstPortionData;
+	uint8_t *lastPortionData;
+	uint8_t filterMask;
+} RAIL_RxPacketInfo_t;
+
+///The position within a packet to which a timestamp refers.
+typedef enum RAIL_PacketTimePosition {
+	RAIL_PACKET_TIME_INVALID = 0,
+	RAIL_PACKET_TIME_DEFAULT,
+	RAIL_PACKET_TIME_AT_PREAMBLE_START,
+	RAIL_PACKET_TIME_AT_PREAMBLE_START_USED_TOTAL,
+	RAIL_PACKET_TIME_AT_SYNC_END,
+	RAIL_PACKET_TIME_AT_SYNC_END_USED_TOTAL,
+	RAIL_PACKET_TIME_AT_PACKET_END,
+	RAIL_PACKET_TIME_AT_PACKET_END_USED_TOTAL
+} RAIL_PacketTimePosition_t;
+
+///The timestamp of a packet.
+typedef struct RAIL_PacketTimeStamp {
+	RAIL_Time_t packetTime;
+	uint16_t totalPacketBytes;
+	RAIL_PacketTimePosition_t timePosition;
+} RAIL_PacketTimeStamp_t;
+
+///The RSSI reported when it cannot be measured.
+#define RAIL_RSSI_INVALID_DBM (-128)
+
+///Detailed information about a packet held in the receive FIFO.
+typedef struct RAIL_RxPacketDetails {
+	RAIL_PacketTimeStamp_t timeReceived;
+	bool crcPassed;
+	bool isAck;
+	int8_t rssi;
+	uint8_t lqi;
+	uint8_t syncWordId;
+	uint8_t subPhyId;
+	uint8_t antennaId;
+	uint8_t channelHoppingChannelIndex;
+	uint16_t channel;
+} RAIL_RxPacketDetails_t;
+
+///A multitimer instance. Its contents are managed by the simulator.
+typedef struct RAIL_MultiTimer {
+	RAIL_Time_t absOffset;
+	RAIL_Time_t relPeriodic;
+	void *callback;
+	void *cbArg;
+	struct RAIL_MultiTimer *next;
+	uint8_t priority;
+	bool isRunning;
+	bool doCallback;
+} RAIL_MultiTimer_t;
+
+///The callback of a multitimer instance.
+typedef void (*RAIL_MultiTimerCallback_t)(RAIL_MultiTimer_t *tmr, RAIL_Time_t expectedTimeOfEvent, void *cbArg);
+
+///A bitmask of calibrations.
+typedef uint32_t RAIL_CalMask_t;
+#define RAIL_CAL_ALL_PENDING (0x00000000U)
+
+///Calibration values (not used by the simulator).
+typedef uint32_t RAIL_CalValues_t;
+
+#endif  // RAIL_TYPES_H
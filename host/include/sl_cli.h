@@ -0,0 +1,30 @@
+/***************************************************************************//**
+ * @file sl_cli.h
+ * @brief Host stand-in for the CLI service. The simulator builds the arguments
+ * of a command the same way the CLI service does, i.e., every argument points
+ * to a value of the type declared in the command table.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_CLI_H
+#define SL_CLI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+///The arguments of a CLI command.
+typedef struct {
+	int argc;
+	void **argv;
+	int arg_ofs;
+} sl_cli_command_arg_t;
+
+#define sl_cli_get_argument_count(a)      ((int)((a)->argc - (a)->arg_ofs))
+#define sl_cli_get_argument_int8(a, n)    (*(int8_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_int16(a, n)   (*(int16_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_int32(a, n)   (*(int32_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_uint8(a, n)   (*(uint8_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_uint16(a, n)  (*(uint16_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_uint32(a, n)  (*(uint32_t *)((a)->argv[(a)->arg_ofs + (n)]))
+#define sl_cli_get_argument_string(a, n)  ((char *)((a)->argv[(a)->arg_ofs + (n)]))
+
+#endif  // SL_CLI_H
@@ -0,0 +1,17 @@
+/***************************************************************************//**
+ * @file sl_i2cspm_instances.h
+ * @brief Host stand-in for the I2C instances of the board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_I2CSPM_INSTANCES_H
+#define SL_I2CSPM_INSTANCES_H
+
+///An I2C peripheral (its contents are irrelevant to the simulator).
+typedef struct {
+	int instance;
+} sl_i2cspm_t;
+
+///The I2C instance connected to the temperature & humidity sensor.
+#define sl_i2cspm_sensor ((sl_i2cspm_t *)0)
+
+#endif  // SL_I2CSPM_INSTANCES_H
@@ -0,0 +1,23 @@
+/***************************************************************************//**
+ * @file sl_rail_util_init.h
+ * @brief Host stand-in for the RAIL initialization utility.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_RAIL_UTIL_INIT_H
+#define SL_RAIL_UTIL_INIT_H
+
+#include "rail.h"
+
+///The RAIL instances which can be requested.
+typedef enum {
+	SL_RAIL_UTIL_HANDLE_INST0
+} sl_rail_util_handle_type_t;
+
+/** Returns the RAIL handle of the simulated board which is currently executed.
+ *
+ * @param handle The requested RAIL instance.
+ * @return The handle of the instance.
+ */
+RAIL_Handle_t sl_rail_util_get_handle(sl_rail_util_handle_type_t handle);
+
+#endif  // SL_RAIL_UTIL_INIT_H
@@ -0,0 +1,12 @@
+/***************************************************************************//**
+ * @file sl_rail_util_init_inst0_config.h
+ * @brief Host stand-in for the configuration of the RAIL instance. The
+ * simulated radio needs none of its settings.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_RAIL_UTIL_INIT_INST0_CONFIG_H
+#define SL_RAIL_UTIL_INIT_INST0_CONFIG_H
+
+#include "rail_types.h"
+
+#endif  // SL_RAIL_UTIL_INIT_INST0_CONFIG_H
@@ -0,0 +1,14 @@
+/***************************************************************************//**
+ * @file sl_rail_util_protocol_types.h
+ * @brief Host stand-in for the RAIL protocol types.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_RAIL_UTIL_PROTOCOL_TYPES_H
+#define SL_RAIL_UTIL_PROTOCOL_TYPES_H
+
+///The protocols supported by the RAIL utilities.
+typedef enum {
+	SL_RAIL_UTIL_PROTOCOL_PROPRIETARY
+} sl_rail_util_protocol_type_t;
+
+#endif  // SL_RAIL_UTIL_PROTOCOL_TYPES_H
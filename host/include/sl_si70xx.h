@@ -0,0 +1,22 @@
+/***************************************************************************//**
+ * @file sl_si70xx.h
+ * @brief Host stand-in for the Si70xx temperature & humidity sensor driver. The
+ * measurements are provided by the simulator, which also charges the
+ * conversion time to the simulated board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_SI70XX_H
+#define SL_SI70XX_H
+
+#include <stdbool.h>
+#include "sl_status.h"
+#include "sl_i2cspm_instances.h"
+
+///The I2C address of the sensor.
+#define SI7021_ADDR 0x40
+
+sl_status_t sl_si70xx_measure_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr, uint32_t *rhData, int32_t *tData);
+sl_status_t sl_si70xx_start_no_hold_measure_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr);
+sl_status_t sl_si70xx_read_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr, uint32_t *rhData, int32_t *tData);
+
+#endif  // SL_SI70XX_H
@@ -0,0 +1,20 @@
+/***************************************************************************//**
+ * @file sl_simple_led_instances.h
+ * @brief Host stand-in for the LED instances of the board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_SIMPLE_LED_INSTANCES_H
+#define SL_SIMPLE_LED_INSTANCES_H
+
+///A LED of the board.
+typedef struct {
+	int instance;
+} sl_led_t;
+
+extern const sl_led_t sl_led_led0;
+extern const sl_led_t sl_led_led1;
+
+void sl_led_turn_on(const sl_led_t *led_handle);
+void sl_led_turn_off(const sl_led_t *led_handle);
+
+#endif  // SL_SIMPLE_LED_INSTANCES_H
@@ -0,0 +1,15 @@
+/***************************************************************************//**
+ * @file sl_sleeptimer.h
+ * @brief Host stand-in for the Sleep Timer service. The ticks follow the time
+ * of the simulated board (see host/sim_platform.c).
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_SLEEPTIMER_H
+#define SL_SLEEPTIMER_H
+
+#include <stdint.h>
+
+uint64_t sl_sleeptimer_get_tick_count64(void);
+uint32_t sl_sleeptimer_get_timer_frequency(void);
+
+#endif  // SL_SLEEPTIMER_H
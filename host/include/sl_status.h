@@ -0,0 +1,21 @@
+/***************************************************************************//**
+ * @file sl_status.h
+ * @brief Host stand-in for the status codes of the Gecko SDK.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SL_STATUS_H
+#define SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK             ((sl_status_t)0x0000)
+#define SL_STATUS_FAIL           ((sl_status_t)0x0001)
+#define SL_STATUS_INVALID_STATE  ((sl_status_t)0x0002)
+#define SL_STATUS_NOT_READY      ((sl_status_t)0x0003)
+#define SL_STATUS_BUSY           ((sl_status_t)0x0004)
+#define SL_STATUS_TIMEOUT        ((sl_status_t)0x0007)
+#define SL_STATUS_TRANSMIT       ((sl_status_t)0x0042)
+
+#endif  // SL_STATUS_H
@@ -0,0 +1,390 @@
+/***************************************************************************//**
+ * @file sim.h
+ * @brief Internal interface of the host-side discrete-event simulator, shared by
+ * the kernel, the simulated radio and the simulated platform services.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rail_types.h"
+#include "sl_power_manager.h"
+
+///The maximum number of boards which can be simulated together.
+#define SIM_MAX_NODES 64
+
+///The maximum size of a frame (equal to the size of the TX FIFO of the application).
+#define SIM_MAX_FRAME_BYTES 256
+
+///The number of received packets that the receive FIFO of a board can hold.
+#define SIM_RX_QUEUE_LENGTH 8
+
+///The maximum number of multitimers that a board can use concurrently.
+#define SIM_MAX_TIMERS 8
+
+///The maximum number of writable memory regions tracked per board image.
+#define SIM_MAX_MEM_REGIONS 4
+
+///The size of the user-data flash page of every board.
+#define SIM_USERDATA_BYTES 2048
+
+/** The configuration of the simulated radio channel.
+ * - bitrate: The bitrate of the PHY, in bits per second.
+ * - overhead_bits: The bits of every frame in addition to its payload (preamble, sync word, CRC).
+ * - tx_warmup_us: The time between RAIL_StartTx() and the first bit on the air.
+ * - latency_us: The time between the end of a frame and the RX event at a receiver.
+ * - jitter_us: A uniformly distributed extra latency in [0, jitter_us].
+ * - loss: The probability that a frame is not received by a receiver in range.
+ * - all_in_range: If true, every board hears every other board. Otherwise, only the boards connected in the graph hear each other.
+ * - max_frame_bytes: The length of the longest frame which the PHY accepts (its maximum length field plus 1). Longer frames are dropped by every receiver.
+ */
+typedef struct {
+	uint32_t bitrate;
+	uint32_t overhead_bits;
+	uint32_t tx_warmup_us;
+	uint32_t latency_us;
+	uint32_t jitter_us;
+	double loss;
+	bool all_in_range;
+	uint16_t max_frame_bytes;
+} sim_radio_config_t;
+
+/** The configuration of the simulated platform services.
+ * - loop_us: The CPU time of a pass through the main loop of a board.
+ * - baud: The baud rate of the console. Every logged character costs 10 bit-times of CPU time (0 makes logging free).
+ * - sensor_us: The conversion time of a temperature & humidity measurement (the CPU time of a blocking one).
+ * - verbose: If true, the console output of every board is printed.
+ */
+typedef struct {
+	uint32_t loop_us;
+	uint32_t baud;
+	uint32_t sensor_us;
+	bool verbose;
+} sim_platform_config_t;
+
+///The statistics collected for every board.
+typedef struct {
+	uint32_t tx_packets;
+	uint64_t tx_airtime_us;
+	uint32_t rx_packets;
+	uint32_t rx_lost;
+	uint32_t rx_collided;
+	uint32_t rx_overflows;
+	uint32_t rx_filtered;
+	uint32_t rx_too_long;
+	uint64_t log_chars;
+} sim_node_stats_t;
+
+///A packet in the receive FIFO of a board.
+typedef struct {
+	uint8_t data[SIM_MAX_FRAME_BYTES];
+	uint16_t len;
+	bool used;
+	bool held;
+	uint64_t seq;
+	uint64_t start;
+	int8_t rssi;
+	bool is_ack;
+} sim_rx_packet_t;
+
+///A multitimer of a board.
+typedef struct {
+	RAIL_MultiTimer_t *tmr;
+	RAIL_MultiTimerCallback_t callback;
+	void *cb_arg;
+	uint64_t expiry;
+	uint32_t gen;
+	bool armed;
+} sim_timer_t;
+
+///A simulated board, i.e., an independently loaded image of the application together with its simulated peripherals.
+typedef struct sim_node {
+	int id;
+	void *lib;
+
+	//Entry points of the application image
+	RAIL_Handle_t (*app_init)(void);
+	void (*app_process_action)(RAIL_Handle_t);
+	void (*on_rail_event)(RAIL_Handle_t, RAIL_Events_t);
+	bool (*app_is_ok_to_sleep)(void);
+	bool (*is_asleep)(void);
+
+	//Writable memory of the image, used to detect when the board waits for an event
+	uint8_t *mem_base[SIM_MAX_MEM_REGIONS];
+	size_t mem_len[SIM_MAX_MEM_REGIONS];
+	int mem_regions;
+	uint8_t *mem_snapshot;
+
+	//CPU
+	uint64_t now;
+	bool run_pending;
+	uint64_t api_calls;
+	bool asleep;
+	sl_power_manager_em_t em;
+	uint64_t slept_at;
+	uint64_t woke_at;
+	uint32_t clock_offset;
+
+	//Radio
+	bool rx_on;
+	bool rx_requested;
+	uint16_t rx_channel;
+	bool transmitting;
+	bool tx_pending;
+	int rx_after_tx;
+	uint32_t radio_epoch;
+	uint32_t rx_window_gen;
+	uint64_t rx_window_len;
+	bool rx_window_hard;
+	uint8_t tx_fifo[SIM_MAX_FRAME_BYTES];
+	uint16_t tx_fifo_len;
+	int rx_lock;
+	uint32_t rx_lock_epoch;
+	bool rx_lock_corrupt;
+	sim_rx_packet_t rx_queue[SIM_RX_QUEUE_LENGTH];
+	sim_rx_packet_t *rx_current;
+	uint64_t rx_seq;
+	sim_timer_t timers[SIM_MAX_TIMERS];
+
+	//Auto-ACK
+	bool ack_enabled;
+	uint32_t ack_timeout_us;
+	uint8_t ack_fifo[SIM_MAX_FRAME_BYTES];
+	uint16_t ack_fifo_len;
+	bool ack_cancelled;
+	bool ack_waiting;
+	uint32_t ack_wait_gen;
+
+	//Address filter
+	bool addr_filter_on;
+	uint8_t addr_offset;
+	uint8_t addr_size;
+	uint8_t addr_values[ADDRESS_FILTER_ENTRIES][8];
+	bool addr_enabled[ADDRESS_FILTER_ENTRIES];
+
+	//Platform
+	double temperature;
+	double temperature_drift; //degrees Celsius per second, from time 0
+	double humidity;
+	bool sensor_converting;
+	uint64_t sensor_ready_at;
+	int em_requirements[SL_POWER_MANAGER_EM4];
+	const sl_power_manager_em_transition_event_info_t *em_subscriber;
+	char log_line[256];
+	size_t log_len;
+	uint8_t userdata[SIM_USERDATA_BYTES];
+
+	sim_node_stats_t stats;
+} sim_node_t;
+
+/** The types of the events processed by the kernel.
+ * - SIM_EV_RUN: Execute one pass through the main loop of a board.
+ * - SIM_EV_CALL: Call a function in the main-loop context of a board (e.g., a CLI command).
+ * - SIM_EV_TIMER: A multitimer of a board expires.
+ * - SIM_EV_RX_ON: The radio of a board starts receiving on a channel.
+ * - SIM_EV_RX_OFF: The radio of a board is turned off.
+ * - SIM_EV_TX_START: The first bit of a frame goes on the air.
+ * - SIM_EV_TX_END: The last bit of a frame goes on the air.
+ * - SIM_EV_RX_DONE: A received frame is reported to a board.
+ * - SIM_EV_RX_WINDOW_START: A scheduled receive window of a board starts.
+ * - SIM_EV_RX_WINDOW_END: A scheduled receive window of a board ends.
+ * - SIM_EV_ACK_TIMEOUT: A board which waits for an ACK gives up.
+ */
+typedef enum {
+	SIM_EV_RUN,
+	SIM_EV_CALL,
+	SIM_EV_TIMER,
+	SIM_EV_RX_ON,
+	SIM_EV_RX_OFF,
+	SIM_EV_TX_START,
+	SIM_EV_TX_END,
+	SIM_EV_RX_DONE,
+	SIM_EV_RX_WINDOW_START,
+	SIM_EV_RX_WINDOW_END,
+	SIM_EV_ACK_TIMEOUT
+} sim_event_type_t;
+
+///A function called in the main-loop context of a board.
+typedef void (*sim_call_t)(sim_node_t *node, void *ctx);
+
+///An event of the kernel.
+typedef struct {
+	uint64_t time;
+	uint64_t seq;
+	sim_event_type_t type;
+	int node;
+	int arg;
+	uint32_t gen;
+	sim_call_t call;
+	void *ctx;
+} sim_event_t;
+
+///A frame on the air.
+typedef struct {
+	bool used;
+	int sender;
+	uint16_t channel;
+	uint64_t start;
+	uint64_t end;
+	uint16_t len;
+	uint8_t data[SIM_MAX_FRAME_BYTES];
+	int refs;
+	bool is_ack;
+	bool wait_ack;
+} sim_tx_t;
+
+///Observers of the simulation, used to collect statistics about the protocol.
+typedef struct {
+	void (*on_tx_start)(const sim_node_t *node, const sim_tx_t *tx);
+	void (*on_sleep_change)(const sim_node_t *node);
+} sim_observer_t;
+
+///The simulated boards.
+extern sim_node_t sim_nodes[SIM_MAX_NODES];
+///The number of simulated boards.
+extern int sim_num_nodes;
+///The configuration of the simulated radio channel.
+extern sim_radio_config_t sim_radio;
+///The configuration of the simulated platform services.
+extern sim_platform_config_t sim_platform;
+///The observers of the simulation (any member may be NULL).
+extern sim_observer_t sim_observer;
+///The adjacency of the boards, used by the radio if {@link sim_radio_config_t all_in_range} is false.
+extern bool sim_links[SIM_MAX_NODES][SIM_MAX_NODES];
+///The RSSI (in dBm) at which a board receives the frames of another board (reported by RAIL_GetRxPacketDetailsAlt()).
+extern int8_t sim_link_rssi[SIM_MAX_NODES][SIM_MAX_NODES];
+///The probability that a board misses a frame of another board in range, in addition to {@link sim_radio_config_t loss} (e.g., of a marginal link).
+extern double sim_link_loss[SIM_MAX_NODES][SIM_MAX_NODES];
+
+//--------------------------------- Kernel -------------------------------------
+/** Initializes the kernel with no boards and no pending events.
+ *
+ * @param seed The seed of the random generator.
+ */
+void sim_init(uint64_t seed);
+
+/** Loads an image of the application as a new board.
+ *
+ * @param path The path of the shared object with the application.
+ * @return The new board, or NULL if the image could not be loaded.
+ */
+sim_node_t *sim_load_node(const char *path);
+
+/** Resolves a symbol (data or function) of a board's image, or terminates the
+ * simulation if it does not exist.
+ *
+ * @param node The board.
+ * @param name The name of the symbol.
+ * @return The address of the symbol.
+ */
+void *sim_symbol(sim_node_t *node, const char *name);
+
+/** Schedules an event.
+ *
+ * @param ev The event (its sequence number is assigned by the kernel).
+ */
+void sim_schedule(sim_event_t ev);
+
+/** Schedules a function to be called in the main-loop context of a board.
+ *
+ * @param node The board.
+ * @param time The (earliest) time of the call.
+ * @param call The function to be called.
+ * @param ctx An argument passed to the function.
+ */
+void sim_call(sim_node_t *node, uint64_t time, sim_call_t call, void *ctx);
+
+/** Makes sure that a board executes its main loop from the given time on.
+ *
+ * @param node The board.
+ * @param time The time from which the board has to run.
+ */
+void sim_wake(sim_node_t *node, uint64_t time);
+
+/** Processes events until there are no more events or the time limit is reached.
+ *
+ * @param limit The time limit.
+ * @return The time of the last processed event.
+ */
+uint64_t sim_run(uint64_t limit);
+
+/** Makes sim_run() return after the current event (e.g., when the boards
+ * listen periodically and the simulation would never run out of events).
+ */
+void sim_stop(void);
+
+/** Returns whether there are no pending events.
+ *
+ * @return True if there are no pending events.
+ */
+bool sim_idle(void);
+
+/** Returns the board whose code is currently executed, and marks that it
+ * interacted with its environment. Every stand-in of the SDK calls it.
+ *
+ * @return The current board.
+ */
+sim_node_t *sim_self(void);
+
+/** Returns the current time of the board which is currently executed.
+ *
+ * @return The current time, in microseconds.
+ */
+uint64_t sim_now(void);
+
+/** Charges CPU time to the board which is currently executed (only in the
+ * main-loop context; interrupt handlers are considered instantaneous).
+ *
+ * @param us The CPU time, in microseconds.
+ */
+void sim_charge(uint64_t us);
+
+/** Calls a callback of a board in interrupt context.
+ *
+ * @param node The board.
+ * @param time The time of the interrupt.
+ * @param isr The callback.
+ * @param ctx An argument passed to the callback.
+ */
+void sim_interrupt(sim_node_t *node, uint64_t time, sim_call_t isr, void *ctx);
+
+/** Returns a uniformly distributed random number in [0,1).
+ *
+ * @return The random number.
+ */
+double sim_random(void);
+
+//--------------------------------- Platform -----------------------------------
+/** Returns the temperature of a board at a time, i.e., its initial temperature
+ * plus its drift since time 0 (which its sensor measures).
+ *
+ * @param node The board.
+ * @param time The time.
+ * @return The temperature, in degrees Celsius.
+ */
+double sim_temperature(const sim_node_t *node, uint64_t time);
+
+//---------------------------------- Radio -------------------------------------
+/** Returns the airtime of a frame.
+ *
+ * @param len The length of the frame's payload in bytes.
+ * @return The airtime, in microseconds.
+ */
+uint64_t sim_airtime(uint16_t len);
+
+/** Handles a radio event of the kernel.
+ *
+ * @param ev The event.
+ */
+void sim_radio_event(const sim_event_t *ev);
+
+/** Handles an expired multitimer.
+ *
+ * @param ev The event of the timer.
+ */
+void sim_timer_event(const sim_event_t *ev);
+
+#endif  // SIM_H
@@ -0,0 +1,436 @@
+/***************************************************************************//**
+ * @file sim_kernel.c
+ * @brief The discrete-event kernel of the host simulator. Every board is an
+ * independently loaded image of the application, which is executed one pass of
+ * its main loop at a time, in the order of the virtual time.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#define _GNU_SOURCE
+#include "sim.h"
+#include <dlfcn.h>
+#include <link.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+sim_node_t sim_nodes[SIM_MAX_NODES];
+int sim_num_nodes;
+sim_radio_config_t sim_radio;
+sim_platform_config_t sim_platform;
+sim_observer_t sim_observer;
+bool sim_links[SIM_MAX_NODES][SIM_MAX_NODES];
+int8_t sim_link_rssi[SIM_MAX_NODES][SIM_MAX_NODES];
+double sim_link_loss[SIM_MAX_NODES][SIM_MAX_NODES];
+
+///The pending events, as a binary min-heap ordered by time (and sequence number for equal times).
+static sim_event_t *heap;
+///The number of pending events.
+static size_t heap_len;
+///The capacity of the heap.
+static size_t heap_cap;
+///The sequence number of the next scheduled event, making the order of simultaneous events deterministic.
+static uint64_t next_seq;
+
+///The board whose code is currently executed (NULL when the kernel itself runs).
+static sim_node_t *ctx_node;
+///The time of the interrupt which is currently executed.
+static uint64_t ctx_time;
+///True while an interrupt callback is executed.
+static bool ctx_isr;
+
+///The state of the random generator.
+static uint64_t rng_state;
+
+///True if sim_run() has to return after the current event.
+static bool stop_requested;
+
+/** Returns true if event a has to be processed before event b.
+ *
+ * @param a The first event.
+ * @param b The second event.
+ * @return True if a precedes b.
+ */
+static bool precedes(const sim_event_t *a, const sim_event_t *b){
+	return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+/*******************************************************************************
+ * Initializes the kernel.
+ ******************************************************************************/
+void sim_init(uint64_t seed){
+	for(int i=0;i<sim_num_nodes;i++){
+		free(sim_nodes[i].mem_snapshot);
+		if(sim_nodes[i].lib)
+			dlclose(sim_nodes[i].lib);
+	}
+	memset(sim_nodes, 0, sizeof(sim_nodes));
+	sim_num_nodes = 0;
+	heap_len = 0;
+	next_seq = 0;
+	rng_state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+/*******************************************************************************
+ * Schedules an event.
+ ******************************************************************************/
+void sim_schedule(sim_event_t ev){
+	if(heap_len == heap_cap){
+		heap_cap = heap_cap ? 2*heap_cap : 256;
+		heap = realloc(heap, heap_cap*sizeof(*heap));
+		if(!heap){
+			perror("realloc");
+			exit(1);
+		}
+	}
+	ev.seq = next_seq++;
+	size_t i = heap_len++;
+	while(i>0 && precedes(&ev, &heap[(i-1)/2])){
+		heap[i] = heap[(i-1)/2];
+		i = (i-1)/2;
+	}
+	heap[i] = ev;
+}
+
+/** Removes the earliest event from the heap.
+ *
+ * @return The earliest event.
+ */
+static sim_event_t pop_event(){
+	sim_event_t top = heap[0];
+	sim_event_t last = heap[--heap_len];
+	size_t i = 0;
+	for(;;){
+		size_t c = 2*i+1;
+		if(c >= heap_len)
+			break;
+		if(c+1 < heap_len && precedes(&heap[c+1], &heap[c]))
+			c++;
+		if(!precedes(&heap[c], &last))
+			break;
+		heap[i] = heap[c];
+		i = c;
+	}
+	if(heap_len > 0)
+		heap[i] = last;
+	return top;
+}
+
+/*******************************************************************************
+ * Schedules a function call in the main-loop context of a board.
+ ******************************************************************************/
+void sim_call(sim_node_t *node, uint64_t time, sim_call_t call, void *ctx){
+	sim_event_t ev = { .time = time, .type = SIM_EV_CALL, .node = node->id, .call = call, .ctx = ctx };
+	sim_schedule(ev);
+}
+
+/*******************************************************************************
+ * Makes sure that a board executes its main loop from the given time on.
+ ******************************************************************************/
+void sim_wake(sim_node_t *node, uint64_t time){
+	if(node->run_pending)
+		return;
+	node->run_pending = true;
+	sim_event_t ev = { .time = time > node->now ? time : node->now, .type = SIM_EV_RUN, .node = node->id };
+	sim_schedule(ev);
+}
+
+/*******************************************************************************
+ * Returns the current board and counts its interaction with the environment.
+ ******************************************************************************/
+sim_node_t *sim_self(void){
+	if(!ctx_node){
+		fprintf(stderr, "edas_sim: SDK function called outside of a board's context.\n");
+		exit(1);
+	}
+	ctx_node->api_calls++;
+	return ctx_node;
+}
+
+/*******************************************************************************
+ * Returns the current time of the current board.
+ ******************************************************************************/
+uint64_t sim_now(void){
+	if(!ctx_node)
+		return 0;
+	return ctx_isr ? ctx_time : ctx_node->now;
+}
+
+/*******************************************************************************
+ * Charges CPU time to the current board.
+ ******************************************************************************/
+void sim_charge(uint64_t us){
+	if(ctx_node && !ctx_isr)
+		ctx_node->now += us;
+}
+
+/** Calls a callback of a board in interrupt context, without waking up its
+ * main loop.
+ *
+ * @param node The board.
+ * @param time The time of the interrupt.
+ * @param isr The callback.
+ * @param ctx An argument passed to the callback.
+ */
+static void call_isr(sim_node_t *node, uint64_t time, sim_call_t isr, void *ctx){
+	sim_node_t *saved_node = ctx_node;
+	uint64_t saved_time = ctx_time;
+	bool saved_isr = ctx_isr;
+	ctx_node = node;
+	ctx_time = time;
+	ctx_isr = true;
+	isr(node, ctx);
+	ctx_node = saved_node;
+	ctx_time = saved_time;
+	ctx_isr = saved_isr;
+}
+
+/*******************************************************************************
+ * Calls a callback of a board in interrupt context.
+ ******************************************************************************/
+void sim_interrupt(sim_node_t *node, uint64_t time, sim_call_t isr, void *ctx){
+	call_isr(node, time, isr, ctx);
+	sim_wake(node, time);
+}
+
+/*******************************************************************************
+ * Returns a uniformly distributed random number in [0,1) (xorshift64*).
+ ******************************************************************************/
+double sim_random(void){
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return ((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * (1.0/9007199254740992.0);
+}
+
+/** Collects the writable segments of a loaded image (used by dl_iterate_phdr()).
+ *
+ * @param info The information of a loaded object.
+ * @param size The size of the information structure.
+ * @param data The board whose image is searched.
+ * @return 1 when the image of the board was found, 0 otherwise.
+ */
+static int collect_writable_segments(struct dl_phdr_info *info, size_t size, void *data){
+	(void)size;
+	sim_node_t *node = data;
+	struct link_map *map = NULL;
+	if(dlinfo(node->lib, RTLD_DI_LINKMAP, &map) != 0 || info->dlpi_addr != map->l_addr)
+		return 0;
+	for(int i=0; i<info->dlpi_phnum && node->mem_regions<SIM_MAX_MEM_REGIONS; i++){
+		const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+		if(ph->p_type == PT_LOAD && (ph->p_flags & PF_W)){
+			node->mem_base[node->mem_regions] = (uint8_t *)(info->dlpi_addr + ph->p_vaddr);
+			node->mem_len[node->mem_regions] = ph->p_memsz;
+			node->mem_regions++;
+		}
+	}
+	return 1;
+}
+
+/** Resolves a symbol of a board's image, or terminates the simulation.
+ *
+ * @param node The board.
+ * @param name The name of the symbol.
+ * @return The address of the symbol.
+ */
+static void *resolve(sim_node_t *node, const char *name){
+	void *sym = dlsym(node->lib, name);
+	if(!sym){
+		fprintf(stderr, "edas_sim: board %d: symbol '%s' not found: %s\n", node->id, name, dlerror());
+		exit(1);
+	}
+	return sym;
+}
+
+/*******************************************************************************
+ * Loads an image of the application as a new board.
+ ******************************************************************************/
+sim_node_t *sim_load_node(const char *path){
+	if(sim_num_nodes >= SIM_MAX_NODES)
+		return NULL;
+	sim_node_t *node = &sim_nodes[sim_num_nodes];
+	memset(node, 0, sizeof(*node));
+	node->id = sim_num_nodes;
+	node->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(!node->lib){
+		fprintf(stderr, "edas_sim: %s\n", dlerror());
+		return NULL;
+	}
+	node->app_init = (RAIL_Handle_t (*)(void)) resolve(node, "app_init");
+	node->app_process_action = (void (*)(RAIL_Handle_t)) resolve(node, "app_process_action");
+	node->on_rail_event = (void (*)(RAIL_Handle_t, RAIL_Events_t)) resolve(node, "sl_rail_util_on_event");
+	node->app_is_ok_to_sleep = (bool (*)(void)) resolve(node, "app_is_ok_to_sleep");
+	node->is_asleep = (bool (*)(void)) resolve(node, "is_asleep");
+
+	dl_iterate_phdr(collect_writable_segments, node);
+	size_t total = 0;
+	for(int i=0;i<node->mem_regions;i++)
+		total += node->mem_len[i];
+	node->mem_snapshot = malloc(total ? total : 1);
+
+	node->clock_offset = (uint32_t)(sim_random()*4294967296.0); //the radio timers of the boards are not synchronized
+	node->rx_lock = -1;
+	node->rx_after_tx = -1;
+	memset(node->userdata, 0xFF, sizeof(node->userdata)); //an erased (i.e., not provisioned) user-data page
+	sim_num_nodes++;
+	return node;
+}
+
+/*******************************************************************************
+ * Resolves an arbitrary symbol of a board's image (data or function).
+ ******************************************************************************/
+void *sim_symbol(sim_node_t *node, const char *name){
+	return resolve(node, name);
+}
+
+/** Compares the writable memory of a board's image with its last snapshot, and
+ * takes a new snapshot.
+ *
+ * @param node The board.
+ * @return True if the memory changed since the last snapshot.
+ */
+static bool memory_changed(sim_node_t *node){
+	bool changed = false;
+	uint8_t *snap = node->mem_snapshot;
+	for(int i=0;i<node->mem_regions;i++){
+		if(memcmp(snap, node->mem_base[i], node->mem_len[i]) != 0){
+			memcpy(snap, node->mem_base[i], node->mem_len[i]);
+			changed = true;
+		}
+		snap += node->mem_len[i];
+	}
+	return changed;
+}
+
+/** Notifies the subscriber of a board about a transition of its energy mode
+ * (in interrupt context).
+ *
+ * @param node The board.
+ * @param ctx The new energy mode, stored in a sl_power_manager_em_t.
+ */
+static void em_isr(sim_node_t *node, void *ctx){
+	node->em_subscriber->on_event(node->em, *(sl_power_manager_em_t *)ctx);
+}
+
+/** Changes the energy mode of a board, and notifies its subscriber.
+ *
+ * @param node The board.
+ * @param em The new energy mode.
+ * @param time The time of the transition.
+ */
+static void set_energy_mode(sim_node_t *node, sl_power_manager_em_t em, uint64_t time){
+	if(em == node->em)
+		return;
+	if(node->em_subscriber)
+		call_isr(node, time, em_isr, &em);
+	node->em = em;
+}
+
+/** Returns the lowest energy mode that a board can enter, as the power manager
+ * of the SDK determines it: RAIL requires EM1 while the radio is active.
+ *
+ * @param node The board.
+ * @return The energy mode.
+ */
+static sl_power_manager_em_t lowest_energy_mode(const sim_node_t *node){
+	if(node->em_requirements[SL_POWER_MANAGER_EM1] > 0 || node->rx_requested || node->transmitting || node->tx_pending)
+		return SL_POWER_MANAGER_EM1;
+	return SL_POWER_MANAGER_EM2;
+}
+
+/** Executes one pass through the main loop of a board. If the application is
+ * ok to sleep after the pass, the MCU enters the lowest allowed energy mode
+ * until an interrupt wakes it up. Otherwise, if the pass neither interacted
+ * with the environment nor changed the memory of the board, the board waits
+ * for an event (busy in EM0) and is not executed again until it is woken up.
+ *
+ * @param node The board.
+ * @param time The time of the pass.
+ */
+static void run_node(sim_node_t *node, uint64_t time){
+	node->run_pending = false;
+	if(time > node->now)
+		node->now = time;
+	set_energy_mode(node, SL_POWER_MANAGER_EM0, node->now);
+	uint64_t calls = node->api_calls;
+
+	ctx_node = node;
+	ctx_isr = false;
+	node->app_process_action((RAIL_Handle_t) node);
+	node->now += sim_platform.loop_us;
+	bool ok_to_sleep = node->app_is_ok_to_sleep();
+	bool asleep = node->is_asleep();
+	ctx_node = NULL;
+
+	if(asleep != node->asleep){
+		node->asleep = asleep;
+		if(asleep)
+			node->slept_at = node->now;
+		else
+			node->woke_at = node->now;
+		if(sim_observer.on_sleep_change)
+			sim_observer.on_sleep_change(node);
+	}
+
+	bool changed = memory_changed(node);
+	if(ok_to_sleep)
+		set_energy_mode(node, lowest_energy_mode(node), node->now);
+	else if(changed || calls != node->api_calls)
+		sim_wake(node, node->now);
+}
+
+/** Executes a function in the main-loop context of a board.
+ *
+ * @param ev The event of the call.
+ */
+static void call_node(const sim_event_t *ev){
+	sim_node_t *node = &sim_nodes[ev->node];
+	if(ev->time > node->now)
+		node->now = ev->time;
+	set_energy_mode(node, SL_POWER_MANAGER_EM0, node->now);
+	ctx_node = node;
+	ctx_isr = false;
+	ev->call(node, ev->ctx);
+	ctx_node = NULL;
+	sim_wake(node, node->now);
+}
+
+/*******************************************************************************
+ * Processes events until there are no more events or the time limit is reached.
+ ******************************************************************************/
+uint64_t sim_run(uint64_t limit){
+	uint64_t time = 0;
+	stop_requested = false;
+	while(!stop_requested && heap_len > 0 && heap[0].time <= limit){
+		sim_event_t ev = pop_event();
+		time = ev.time;
+		switch(ev.type){
+		case SIM_EV_RUN:
+			run_node(&sim_nodes[ev.node], ev.time);
+			break;
+		case SIM_EV_CALL:
+			call_node(&ev);
+			break;
+		case SIM_EV_TIMER:
+			sim_timer_event(&ev);
+			break;
+		default:
+			sim_radio_event(&ev);
+			break;
+		}
+	}
+	return time;
+}
+
+/*******************************************************************************
+ * Makes sim_run() return after the current event.
+ ******************************************************************************/
+void sim_stop(void){
+	stop_requested = true;
+}
+
+/*******************************************************************************
+ * Returns true if there are no pending events.
+ ******************************************************************************/
+bool sim_idle(void){
+	return heap_len == 0;
+}
@@ -0,0 +1,261 @@
+/***************************************************************************//**
+ * @file sim_platform.c
+ * @brief The simulated platform services of the host simulator: console log,
+ * assertions, temperature & humidity sensor, power manager, sleeptimer, LEDs
+ * and chip information. Blocking services charge their duration to the calling board.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include "sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_log.h"
+#include "app_assert.h"
+#include "sl_si70xx.h"
+#include "sl_simple_led_instances.h"
+#include "sl_rail_util_init.h"
+#include "em_chip.h"
+#include "em_msc.h"
+#include "sl_sleeptimer.h"
+
+const sl_led_t sl_led_led0 = { 0 };
+const sl_led_t sl_led_led1 = { 1 };
+
+///The frequency of the sleeptimer (the LFXO), in Hz.
+#define SIM_SLEEPTIMER_HZ 32768
+
+///The CPU time of an I2C transaction with the sensor (a command, or the read of a result), in microseconds.
+#define SIM_I2C_TRANSFER_US 300
+
+/** Prints a complete line of a board's console.
+ *
+ * @param node The board.
+ */
+static void flush_line(sim_node_t *node){
+	if(sim_platform.verbose)
+		printf("[%12.3f ms] board %2d: %.*s\n", sim_now()/1000.0, node->id, (int) node->log_len, node->log_line);
+	node->log_len = 0;
+}
+
+/*******************************************************************************
+ * Writes a log message of the current board to the simulated console.
+ ******************************************************************************/
+void sim_log(int level, const char *fmt, ...){
+	(void)level;
+	sim_node_t *node = sim_self();
+	char buf[1024];
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	if(len < 0)
+		return;
+	if(len >= (int) sizeof(buf))
+		len = sizeof(buf) - 1;
+
+	node->stats.log_chars += len;
+	if(sim_platform.baud) //every character costs a start bit, 8 data bits and a stop bit
+		sim_charge((uint64_t) len * 10 * 1000000ULL / sim_platform.baud);
+
+	for(int i=0;i<len;i++){
+		if(buf[i] == '\n'){
+			if(node->log_len > 0)
+				flush_line(node);
+		}
+		else {
+			if(node->log_len == sizeof(node->log_line))
+				flush_line(node);
+			node->log_line[node->log_len++] = buf[i];
+		}
+	}
+}
+
+/*******************************************************************************
+ * Reports a failed assertion of the current board and aborts the simulation.
+ ******************************************************************************/
+void sim_assert_failed(const char *file, int line, const char *fmt, ...){
+	sim_node_t *node = sim_self();
+	fprintf(stderr, "edas_sim: board %d: assertion failed at %s:%d: ", node->id, file, line);
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+	exit(1);
+}
+
+/*******************************************************************************
+ * Returns the temperature of a board at a time.
+ ******************************************************************************/
+double sim_temperature(const sim_node_t *node, uint64_t time){
+	return node->temperature + node->temperature_drift*time/1e6;
+}
+
+/*******************************************************************************
+ * Returns the temperature & humidity of the current board (in milli-degrees
+ * Celsius and milli-percent), after the conversion time of the sensor.
+ ******************************************************************************/
+sl_status_t sl_si70xx_measure_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr, uint32_t *rhData, int32_t *tData){
+	(void)i2cspm; (void)addr;
+	sim_node_t *node = sim_self();
+	sim_charge(sim_platform.sensor_us);
+	*tData = (int32_t)(sim_temperature(node, sim_now())*1000.0);
+	*rhData = (uint32_t)(node->humidity*1000.0);
+	return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Starts a measurement of the sensor of the current board, whose result is
+ * ready after the conversion time of the sensor.
+ ******************************************************************************/
+sl_status_t sl_si70xx_start_no_hold_measure_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr){
+	(void)i2cspm; (void)addr;
+	sim_node_t *node = sim_self();
+	sim_charge(SIM_I2C_TRANSFER_US);
+	node->sensor_converting = true;
+	node->sensor_ready_at = sim_now() + sim_platform.sensor_us;
+	return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Reads the result of a measurement of the sensor of the current board. As the
+ * real sensor, it does not acknowledge the read while converting.
+ ******************************************************************************/
+sl_status_t sl_si70xx_read_rh_and_temp(sl_i2cspm_t *i2cspm, uint8_t addr, uint32_t *rhData, int32_t *tData){
+	(void)i2cspm; (void)addr;
+	sim_node_t *node = sim_self();
+	sim_charge(SIM_I2C_TRANSFER_US);
+	if(!node->sensor_converting || sim_now() < node->sensor_ready_at)
+		return SL_STATUS_TRANSMIT;
+	sim_charge(SIM_I2C_TRANSFER_US);
+	node->sensor_converting = false;
+	*tData = (int32_t)(sim_temperature(node, sim_now())*1000.0);
+	*rhData = (uint32_t)(node->humidity*1000.0);
+	return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Adds a requirement on an energy mode.
+ ******************************************************************************/
+void sl_power_manager_add_em_requirement(sl_power_manager_em_t em){
+	sim_node_t *node = sim_self();
+	if(em < SL_POWER_MANAGER_EM4)
+		node->em_requirements[em]++;
+}
+
+/*******************************************************************************
+ * Removes a requirement on an energy mode.
+ ******************************************************************************/
+void sl_power_manager_remove_em_requirement(sl_power_manager_em_t em){
+	sim_node_t *node = sim_self();
+	if(em < SL_POWER_MANAGER_EM4 && node->em_requirements[em] > 0)
+		node->em_requirements[em]--;
+}
+
+/*******************************************************************************
+ * Subscribes to the energy mode transitions.
+ ******************************************************************************/
+void sl_power_manager_subscribe_em_transition_event(sl_power_manager_em_transition_event_handle_t *event_handle, const sl_power_manager_em_transition_event_info_t *event_info){
+	sim_node_t *node = sim_self();
+	event_handle->info = event_info;
+	node->em_subscriber = event_info;
+}
+
+/*******************************************************************************
+ * Returns the ticks of the sleeptimer of the current board.
+ ******************************************************************************/
+uint64_t sl_sleeptimer_get_tick_count64(void){
+	sim_self();
+	return sim_now()*SIM_SLEEPTIMER_HZ/1000000ULL;
+}
+
+/*******************************************************************************
+ * Returns the frequency of the sleeptimer.
+ ******************************************************************************/
+uint32_t sl_sleeptimer_get_timer_frequency(void){
+	sim_self();
+	return SIM_SLEEPTIMER_HZ;
+}
+
+/*******************************************************************************
+ * Turns a LED on (nothing to do).
+ ******************************************************************************/
+void sl_led_turn_on(const sl_led_t *led_handle){
+	(void)led_handle;
+	sim_self();
+}
+
+/*******************************************************************************
+ * Turns a LED off (nothing to do).
+ ******************************************************************************/
+void sl_led_turn_off(const sl_led_t *led_handle){
+	(void)led_handle;
+	sim_self();
+}
+
+/*******************************************************************************
+ * Returns the unique number of the current board (an EUI-64 with the board's
+ * index in its lowest bits).
+ ******************************************************************************/
+uint64_t SYSTEM_GetUnique(void){
+	sim_node_t *node = sim_self();
+	return 0x000B57FFFE000000ULL | (uint64_t) node->id;
+}
+
+/*******************************************************************************
+ * Returns the user-data flash page of the current board.
+ ******************************************************************************/
+uint8_t *sim_userdata(void){
+	return sim_self()->userdata;
+}
+
+/*******************************************************************************
+ * Enables the writing to the flash (nothing to do).
+ ******************************************************************************/
+void MSC_Init(void){
+	sim_self();
+}
+
+/*******************************************************************************
+ * Disables the writing to the flash (nothing to do).
+ ******************************************************************************/
+void MSC_Deinit(void){
+	sim_self();
+}
+
+/*******************************************************************************
+ * Erases the user-data page of the current board.
+ ******************************************************************************/
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress){
+	sim_node_t *node = sim_self();
+	if((uint8_t *) startAddress != node->userdata)
+		return mscReturnInvalidAddr;
+	memset(node->userdata, 0xFF, sizeof(node->userdata));
+	return mscReturnOk;
+}
+
+/*******************************************************************************
+ * Writes words to the user-data page of the current board (a write can only
+ * clear bits, as in the flash).
+ ******************************************************************************/
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes){
+	sim_node_t *node = sim_self();
+	uint8_t *dst = (uint8_t *) address;
+	const uint8_t *src = data;
+	if(dst < node->userdata || dst + numBytes > node->userdata + sizeof(node->userdata))
+		return mscReturnInvalidAddr;
+	if(((uintptr_t) dst & 3) || (numBytes & 3))
+		return mscReturnUnaligned;
+	for(uint32_t i=0;i<numBytes;i++)
+		dst[i] &= src[i];
+	return mscReturnOk;
+}
+
+/*******************************************************************************
+ * Returns the RAIL handle of the current board.
+ ******************************************************************************/
+RAIL_Handle_t sl_rail_util_get_handle(sl_rail_util_handle_type_t handle){
+	(void)handle;
+	return (RAIL_Handle_t) sim_self();
+}
@@ -0,0 +1,823 @@
+/***************************************************************************//**
+ * @file sim_rail.c
+ * @brief The simulated radio of the host simulator: a stand-in for the RAIL
+ * functions used by the application, on top of a shared channel model with
+ * configurable airtime, latency, loss and RSSI. Frames that overlap at a receiver on
+ * the same channel are lost, and a receiver only hears a frame if it listens on
+ * the frame's channel from its first to its last bit. The auto-ACK of RAIL is
+ * simulated too: a board acknowledges every received packet (unless its
+ * application cancels the ACK), and a board which waits for an ACK reports the
+ * first packet which it receives as the ACK. The address filter of RAIL drops
+ * the frames whose destination field is not one of the addresses of the
+ * receiver, as if they were not received.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include "sim.h"
+#include "rail.h"
+#include "../config/sl_rail_util_init_inst0_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+///The frames on the air (or waiting to be reported to their receivers).
+static sim_tx_t air[2*SIM_MAX_NODES];
+
+///The value of rx_after_tx which turns the radio off after the transmission (i.e., RAIL_Idle() was called during the transmission).
+#define RX_OFF_AFTER_TX (-2)
+
+///The optional events of the receiver which the application enables in its init configuration (sl_rail_util_init_inst0_config.h), and which the simulated radio reports only then.
+static const RAIL_Events_t enabled_rx_events =
+		(SL_RAIL_UTIL_INIT_EVENT_RX_ADDRESS_FILTERED_INST0_ENABLE ? RAIL_EVENT_RX_ADDRESS_FILTERED : RAIL_EVENTS_NONE)
+		| (SL_RAIL_UTIL_INIT_EVENT_RX_FRAME_ERROR_INST0_ENABLE ? RAIL_EVENT_RX_FRAME_ERROR : RAIL_EVENTS_NONE)
+		| (SL_RAIL_UTIL_INIT_EVENT_RX_PACKET_ABORTED_INST0_ENABLE ? RAIL_EVENT_RX_PACKET_ABORTED : RAIL_EVENTS_NONE);
+
+/*******************************************************************************
+ * Returns the airtime of a frame.
+ ******************************************************************************/
+uint64_t sim_airtime(uint16_t len){
+	uint64_t bits = sim_radio.overhead_bits + 8ULL*len;
+	return (bits*1000000ULL + sim_radio.bitrate - 1) / sim_radio.bitrate;
+}
+
+/** Releases a reference to a frame, and frees it when no more references exist.
+ *
+ * @param id The index of the frame.
+ */
+static void release_tx(int id){
+	if(--air[id].refs <= 0)
+		air[id].used = false;
+}
+
+/** Returns whether a board can hear another one.
+ *
+ * @param from The transmitting board.
+ * @param to The receiving board.
+ * @return True if the frames of the first board reach the second one.
+ */
+static bool in_range(int from, int to){
+	return sim_radio.all_in_range || sim_links[from][to];
+}
+
+/** Changes the radio of a board to receive on a channel. Retuning to another
+ * channel aborts any frame being received.
+ *
+ * @param node The board.
+ * @param channel The channel.
+ */
+static void set_rx(sim_node_t *node, uint16_t channel){
+	if(node->rx_on && node->rx_channel == channel)
+		return;
+	node->rx_on = true;
+	node->rx_channel = channel;
+	node->radio_epoch++;
+}
+
+/** Reports a radio event to the application (in interrupt context).
+ *
+ * @param node The board.
+ * @param ctx The events, stored in a RAIL_Events_t.
+ */
+static void rail_isr(sim_node_t *node, void *ctx){
+	node->on_rail_event((RAIL_Handle_t) node, *(RAIL_Events_t *)ctx);
+}
+
+/** Puts a new frame of a board in the air, after the warm-up of its
+ * transmitter (the first bit goes on the air with SIM_EV_TX_START).
+ *
+ * @param node The transmitting board.
+ * @param channel The channel of the frame.
+ * @param data The payload of the frame.
+ * @param len The length of the payload.
+ * @param time The time of the request.
+ * @return The frame.
+ */
+static sim_tx_t *start_tx(sim_node_t *node, uint16_t channel, const uint8_t *data, uint16_t len, uint64_t time){
+	int id = -1;
+	for(int i=0;i<(int)(sizeof(air)/sizeof(air[0]));i++){
+		if(!air[i].used){
+			id = i;
+			break;
+		}
+	}
+	if(id < 0){
+		fprintf(stderr, "edas_sim: too many frames on the air.\n");
+		exit(1);
+	}
+	sim_tx_t *tx = &air[id];
+	tx->used = true;
+	tx->refs = 1;
+	tx->sender = node->id;
+	tx->channel = channel;
+	tx->len = len;
+	tx->is_ack = false;
+	tx->wait_ack = false;
+	memcpy(tx->data, data, len);
+	node->tx_pending = true;
+
+	sim_event_t ev = { .time = time + sim_radio.tx_warmup_us, .type = SIM_EV_TX_START, .node = node->id, .arg = id };
+	sim_schedule(ev);
+	return tx;
+}
+
+/** Sends the contents of the ACK FIFO of a board, after it received a packet
+ * (its radio turns around to transmit on the channel of the packet).
+ *
+ * @param node The board.
+ * @param time The time when the packet was received.
+ */
+static void send_ack(sim_node_t *node, uint64_t time){
+	RAIL_Events_t events = RAIL_EVENTS_NONE;
+	if(node->transmitting || node->tx_pending || !node->rx_on)
+		events = RAIL_EVENT_TXACK_BLOCKED;
+	else if(node->ack_fifo_len == 0)
+		events = RAIL_EVENT_TXACK_UNDERFLOW;
+	if(events){
+		sim_interrupt(node, time, rail_isr, &events);
+		return;
+	}
+	start_tx(node, node->rx_channel, node->ack_fifo, node->ack_fifo_len, time)->is_ack = true;
+}
+
+/** Ends the wait of a board for an ACK: the radio follows the requests of the
+ * application made meanwhile (see RAIL_StartRx() & RAIL_Idle()), or keeps
+ * receiving on the channel of the transmission.
+ *
+ * @param node The board.
+ */
+static void end_ack_wait(sim_node_t *node){
+	node->ack_waiting = false;
+	node->ack_wait_gen++;
+	if(node->rx_after_tx == RX_OFF_AFTER_TX){
+		node->rx_on = false;
+		node->radio_epoch++;
+	}
+	else if(node->rx_after_tx >= 0)
+		set_rx(node, (uint16_t) node->rx_after_tx);
+	node->rx_after_tx = -1;
+}
+
+/** Returns whether the address filter of a board accepts a frame (see
+ * RAIL_ConfigAddressFilter()): the field of the filter has to match one of its
+ * enabled addresses.
+ *
+ * @param node The receiving board.
+ * @param tx The frame.
+ * @return True if the frame is accepted, or if the filter is disabled.
+ */
+static bool passes_address_filter(const sim_node_t *node, const sim_tx_t *tx){
+	if(!node->addr_filter_on)
+		return true;
+	if(tx->len < node->addr_offset + node->addr_size)
+		return false;
+	for(int i=0;i<ADDRESS_FILTER_ENTRIES;i++)
+		if(node->addr_enabled[i] && memcmp(&tx->data[node->addr_offset], node->addr_values[i], node->addr_size) == 0)
+			return true;
+	return false;
+}
+
+/** Delivers a received frame to the receive FIFO of a board. If the board waits
+ * for an ACK, the frame is reported as the ACK. Otherwise, the board sends its
+ * ACK afterwards, if the auto-ACK is enabled and the application did not
+ * cancel it. A frame which the address filter of the board rejects (reported
+ * with RAIL_EVENT_RX_ADDRESS_FILTERED, if enabled), or which is longer than the
+ * PHY accepts, is dropped.
+ *
+ * @param node The receiving board.
+ * @param tx The frame.
+ * @param time The time of delivery.
+ */
+static void deliver(sim_node_t *node, const sim_tx_t *tx, uint64_t time){
+	if(tx->len > sim_radio.max_frame_bytes){ //the length field exceeds the maximum length of the frames, hence the frame is aborted
+		node->stats.rx_too_long++;
+		return;
+	}
+	if(!passes_address_filter(node, tx)){ //dropped by the radio, without an ACK
+		node->stats.rx_filtered++;
+		RAIL_Events_t events = RAIL_EVENT_RX_ADDRESS_FILTERED & enabled_rx_events;
+		if(events)
+			sim_interrupt(node, time, rail_isr, &events);
+		return;
+	}
+	bool is_ack = node->ack_waiting;
+	if(is_ack)
+		end_ack_wait(node);
+	sim_rx_packet_t *slot = NULL;
+	for(int i=0;i<SIM_RX_QUEUE_LENGTH;i++){
+		if(!node->rx_queue[i].used){
+			slot = &node->rx_queue[i];
+			break;
+		}
+	}
+	RAIL_Events_t events;
+	if(!slot){
+		node->stats.rx_overflows++;
+		events = RAIL_EVENT_RX_FIFO_OVERFLOW | (is_ack ? RAIL_EVENT_RX_ACK_TIMEOUT : RAIL_EVENTS_NONE);
+		sim_interrupt(node, time, rail_isr, &events);
+		return;
+	}
+	memcpy(slot->data, tx->data, tx->len);
+	slot->len = tx->len;
+	slot->used = true;
+	slot->held = false;
+	slot->seq = node->rx_seq++;
+	slot->start = tx->start;
+	slot->rssi = sim_link_rssi[tx->sender][node->id];
+	slot->is_ack = is_ack;
+	node->stats.rx_packets++;
+
+	node->rx_current = slot;
+	node->ack_cancelled = false;
+	events = RAIL_EVENT_RX_PACKET_RECEIVED;
+	sim_interrupt(node, time, rail_isr, &events);
+	node->rx_current = NULL;
+	if(!slot->held) //packets which are not held are dropped when the callback returns
+		slot->used = false;
+	if(!is_ack && node->ack_enabled && !node->ack_cancelled)
+		send_ack(node, time);
+}
+
+/*******************************************************************************
+ * Handles a radio event of the kernel.
+ ******************************************************************************/
+void sim_radio_event(const sim_event_t *ev){
+	sim_node_t *node = &sim_nodes[ev->node];
+	switch(ev->type){
+	case SIM_EV_RX_ON:
+		if(node->transmitting || node->tx_pending || node->ack_waiting)
+			node->rx_after_tx = ev->arg;
+		else
+			set_rx(node, (uint16_t) ev->arg);
+		break;
+	case SIM_EV_RX_OFF:
+		if(node->transmitting || node->tx_pending || node->ack_waiting)
+			node->rx_after_tx = RX_OFF_AFTER_TX;
+		else if(node->rx_on){ //any frame being received is lost
+			node->rx_on = false;
+			node->radio_epoch++;
+		}
+		break;
+	case SIM_EV_TX_START:{
+		sim_tx_t *tx = &air[ev->arg];
+		node->tx_pending = false;
+		node->transmitting = true;
+		node->rx_on = false;
+		node->radio_epoch++;
+		tx->start = ev->time;
+		tx->end = ev->time + sim_airtime(tx->len);
+		node->stats.tx_packets++;
+		node->stats.tx_airtime_us += tx->end - tx->start;
+		if(sim_observer.on_tx_start)
+			sim_observer.on_tx_start(node, tx);
+
+		for(int i=0;i<sim_num_nodes;i++){
+			sim_node_t *r = &sim_nodes[i];
+			if(r == node || !in_range(node->id, r->id) || !r->rx_on || r->rx_channel != tx->channel)
+				continue;
+			if(r->rx_lock >= 0){ //the receiver is already receiving another frame: both frames are lost
+				r->rx_lock_corrupt = true;
+				r->stats.rx_collided++;
+				continue;
+			}
+			r->rx_lock = ev->arg;
+			r->rx_lock_epoch = r->radio_epoch;
+			r->rx_lock_corrupt = false;
+			tx->refs++;
+		}
+		sim_event_t end = { .time = tx->end, .type = SIM_EV_TX_END, .node = node->id, .arg = ev->arg };
+		sim_schedule(end);
+		break;}
+	case SIM_EV_TX_END:{
+		sim_tx_t *tx = &air[ev->arg];
+		for(int i=0;i<sim_num_nodes;i++){
+			sim_node_t *r = &sim_nodes[i];
+			if(r->rx_lock != ev->arg)
+				continue;
+			r->rx_lock = -1;
+			if(r->radio_epoch != r->rx_lock_epoch)
+				r->stats.rx_lost++;
+			else if(r->rx_lock_corrupt){ //the frame fails its CRC, which the radio reports with RAIL_EVENT_RX_FRAME_ERROR (if enabled)
+				r->stats.rx_collided++;
+				RAIL_Events_t events = RAIL_EVENT_RX_FRAME_ERROR & enabled_rx_events;
+				if(events)
+					sim_interrupt(r, ev->time, rail_isr, &events);
+			}
+			else if(sim_random() < sim_radio.loss || (sim_link_loss[node->id][r->id] > 0 && sim_random() < sim_link_loss[node->id][r->id]))
+				r->stats.rx_lost++;
+			else {
+				uint64_t delay = sim_radio.latency_us;
+				if(sim_radio.jitter_us)
+					delay += (uint64_t)(sim_random()*(sim_radio.jitter_us+1));
+				sim_event_t done = { .time = ev->time + delay, .type = SIM_EV_RX_DONE, .node = r->id, .arg = ev->arg };
+				sim_schedule(done);
+				tx->refs++;
+			}
+			release_tx(ev->arg);
+		}
+
+		node->transmitting = false; //as configured in the RAIL transitions, the radio receives on the same channel after a transmission
+		if(tx->wait_ack){ //until the ACK arrives (or the ACK timeout expires), after which the requests made meanwhile are followed
+			set_rx(node, tx->channel);
+			node->radio_epoch++;
+			node->rx_requested = true;
+			node->ack_waiting = true;
+			node->ack_wait_gen++;
+			sim_event_t timeout = { .time = ev->time + node->ack_timeout_us, .type = SIM_EV_ACK_TIMEOUT, .node = node->id, .gen = node->ack_wait_gen };
+			sim_schedule(timeout);
+		}
+		else {
+			if(node->rx_after_tx == RX_OFF_AFTER_TX)
+				node->radio_epoch++;
+			else {
+				set_rx(node, tx->channel);
+				node->radio_epoch++;
+				node->rx_requested = true;
+				if(node->rx_after_tx >= 0)
+					set_rx(node, (uint16_t) node->rx_after_tx);
+			}
+			node->rx_after_tx = -1;
+		}
+		RAIL_Events_t events = tx->is_ack ? RAIL_EVENT_TXACK_PACKET_SENT : RAIL_EVENT_TX_PACKET_SENT;
+		sim_interrupt(node, ev->time, rail_isr, &events);
+		release_tx(ev->arg);
+		break;}
+	case SIM_EV_RX_DONE:
+		deliver(node, &air[ev->arg], ev->time);
+		release_tx(ev->arg);
+		break;
+	case SIM_EV_RX_WINDOW_START:{
+		if(ev->gen != node->rx_window_gen) //the window was cancelled
+			break;
+		RAIL_Events_t events = RAIL_EVENT_RX_SCHEDULED_RX_MISSED;
+		if(!node->transmitting && !node->tx_pending){
+			set_rx(node, (uint16_t) ev->arg);
+			node->rx_requested = true;
+			events = RAIL_EVENT_SCHEDULED_RX_STARTED;
+			sim_event_t end = { .time = ev->time + node->rx_window_len, .type = SIM_EV_RX_WINDOW_END, .node = node->id, .gen = ev->gen };
+			sim_schedule(end);
+		}
+		sim_interrupt(node, ev->time, rail_isr, &events);
+		break;}
+	case SIM_EV_RX_WINDOW_END:{
+		if(ev->gen != node->rx_window_gen)
+			break;
+		if(!node->rx_window_hard && node->rx_lock >= 0 && node->rx_lock_epoch == node->radio_epoch){ //the frame being received is completed first
+			sim_event_t end = { .time = air[node->rx_lock].end, .type = SIM_EV_RX_WINDOW_END, .node = node->id, .gen = ev->gen };
+			sim_schedule(end);
+			break;
+		}
+		node->rx_on = false;
+		node->rx_requested = false;
+		node->radio_epoch++;
+		RAIL_Events_t events = RAIL_EVENT_RX_SCHEDULED_RX_END;
+		sim_interrupt(node, ev->time, rail_isr, &events);
+		break;}
+	case SIM_EV_ACK_TIMEOUT:{
+		if(!node->ack_waiting || ev->gen != node->ack_wait_gen)
+			break;
+		if(node->rx_lock >= 0 && node->rx_lock_epoch == node->radio_epoch){ //a frame has started (its sync word was detected), which is reported as the ACK unless it is lost
+			sim_event_t later = { .time = air[node->rx_lock].end + sim_radio.latency_us + sim_radio.jitter_us + 1, .type = SIM_EV_ACK_TIMEOUT, .node = node->id, .gen = ev->gen };
+			sim_schedule(later);
+			break;
+		}
+		end_ack_wait(node);
+		RAIL_Events_t events = RAIL_EVENT_RX_ACK_TIMEOUT;
+		sim_interrupt(node, ev->time, rail_isr, &events);
+		break;}
+	default:
+		break;
+	}
+}
+
+//=========================================================================
+//-------------------- RAIL STAND-IN --------------------------------------
+//=========================================================================
+
+/** Converts a time of the radio timer of the current board to the time of the
+ * simulation.
+ *
+ * @param node The board.
+ * @param time The time.
+ * @param mode RAIL_TIME_DELAY if the time is relative to now, RAIL_TIME_ABSOLUTE if it is a time of the radio timer.
+ * @return The time of the simulation.
+ */
+static uint64_t to_sim_time(const sim_node_t *node, RAIL_Time_t time, RAIL_TimeMode_t mode){
+	uint64_t now = sim_now();
+	if(mode == RAIL_TIME_DELAY)
+		return now + time;
+	uint64_t t = (now & ~0xFFFFFFFFULL) | (uint32_t)(time - node->clock_offset); //the nearest time in the future with the given lower 32 bits (after removing the offset of the board's timer)
+	if(t + 0x80000000ULL < now)
+		t += 0x100000000ULL;
+	return t;
+}
+
+/*******************************************************************************
+ * Returns the current time of the board.
+ ******************************************************************************/
+RAIL_Time_t RAIL_GetTime(void){
+	sim_node_t *node = sim_self();
+	return (RAIL_Time_t)(sim_now() + node->clock_offset);
+}
+
+/*******************************************************************************
+ * Initializes the power manager of the radio (nothing to do).
+ ******************************************************************************/
+RAIL_Status_t RAIL_InitPowerManager(void){
+	sim_self();
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Calibrates the radio (nothing to do).
+ ******************************************************************************/
+RAIL_Status_t RAIL_Calibrate(RAIL_Handle_t railHandle, RAIL_CalValues_t *calValues, RAIL_CalMask_t calForce){
+	(void)railHandle; (void)calValues; (void)calForce;
+	sim_self();
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Sets up the TX FIFO.
+ ******************************************************************************/
+uint16_t RAIL_SetTxFifo(RAIL_Handle_t railHandle, uint8_t *addr, uint16_t initLength, uint16_t size){
+	(void)railHandle; (void)addr;
+	sim_node_t *node = sim_self();
+	node->tx_fifo_len = 0;
+	if(initLength > 0 && initLength <= SIM_MAX_FRAME_BYTES){
+		memcpy(node->tx_fifo, addr, initLength);
+		node->tx_fifo_len = initLength;
+	}
+	return size;
+}
+
+/*******************************************************************************
+ * Writes data to the TX FIFO.
+ ******************************************************************************/
+uint16_t RAIL_WriteTxFifo(RAIL_Handle_t railHandle, const uint8_t *dataPtr, uint16_t writeLength, bool reset){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	if(reset)
+		node->tx_fifo_len = 0;
+	uint16_t room = SIM_MAX_FRAME_BYTES - node->tx_fifo_len;
+	if(writeLength > room)
+		writeLength = room;
+	memcpy(node->tx_fifo + node->tx_fifo_len, dataPtr, writeLength);
+	node->tx_fifo_len += writeLength;
+	return writeLength;
+}
+
+/*******************************************************************************
+ * Prepares a channel for transmission (nothing to do).
+ ******************************************************************************/
+RAIL_Status_t RAIL_PrepareChannel(RAIL_Handle_t railHandle, uint16_t channel){
+	(void)railHandle; (void)channel;
+	sim_self();
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Starts the transmission of the contents of the TX FIFO (the radio is busy
+ * while it transmits, or sends an ACK, or waits for one).
+ ******************************************************************************/
+RAIL_Status_t RAIL_StartTx(RAIL_Handle_t railHandle, uint16_t channel, RAIL_TxOptions_t options, const RAIL_SchedulerInfo_t *schedulerInfo){
+	(void)railHandle; (void)schedulerInfo;
+	sim_node_t *node = sim_self();
+	if(node->transmitting || node->tx_pending || node->ack_waiting)
+		return RAIL_STATUS_INVALID_STATE;
+	if(node->tx_fifo_len == 0)
+		return RAIL_STATUS_INVALID_PARAMETER;
+
+	sim_tx_t *tx = start_tx(node, channel, node->tx_fifo, node->tx_fifo_len, sim_now());
+	tx->wait_ack = node->ack_enabled && (options & RAIL_TX_OPTION_WAIT_FOR_ACK);
+	node->tx_fifo_len = 0;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Starts receiving on a channel.
+ ******************************************************************************/
+RAIL_Status_t RAIL_StartRx(RAIL_Handle_t railHandle, uint16_t channel, const RAIL_SchedulerInfo_t *schedulerInfo){
+	(void)railHandle; (void)schedulerInfo;
+	sim_node_t *node = sim_self();
+	node->rx_requested = true;
+	node->rx_window_gen++; //any scheduled window is cancelled
+	sim_event_t ev = { .time = sim_now(), .type = SIM_EV_RX_ON, .node = node->id, .arg = channel };
+	sim_schedule(ev);
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Turns off the radio. A transmission which has already been started is
+ * completed first.
+ ******************************************************************************/
+void RAIL_Idle(RAIL_Handle_t railHandle, RAIL_IdleMode_t mode, bool wait){
+	(void)railHandle; (void)mode; (void)wait;
+	sim_node_t *node = sim_self();
+	node->rx_requested = false;
+	node->rx_window_gen++; //any scheduled window is cancelled
+	sim_event_t ev = { .time = sim_now(), .type = SIM_EV_RX_OFF, .node = node->id };
+	sim_schedule(ev);
+}
+
+/*******************************************************************************
+ * Schedules a receive window. The radio receives only from its start until its
+ * end (deferred while a frame is received, unless the end is hard).
+ ******************************************************************************/
+RAIL_Status_t RAIL_ScheduleRx(RAIL_Handle_t railHandle, uint16_t channel, const RAIL_ScheduleRxConfig_t *cfg, const RAIL_SchedulerInfo_t *schedulerInfo){
+	(void)railHandle; (void)schedulerInfo;
+	sim_node_t *node = sim_self();
+	if(cfg->startMode == RAIL_TIME_DISABLED || cfg->endMode == RAIL_TIME_DISABLED)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	uint64_t start = to_sim_time(node, cfg->start, cfg->startMode);
+	if(start < sim_now()) //a window in the past starts immediately
+		start = sim_now();
+	uint64_t end = to_sim_time(node, cfg->end, cfg->endMode);
+	if(cfg->endMode == RAIL_TIME_DELAY)
+		end = start + cfg->end;
+	node->rx_window_gen++;
+	node->rx_window_len = end > start ? end - start : 0;
+	node->rx_window_hard = cfg->hardWindowEnd;
+	sim_event_t ev = { .time = start, .type = SIM_EV_RX_WINDOW_START, .node = node->id, .arg = channel, .gen = node->rx_window_gen };
+	sim_schedule(ev);
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Holds the packet which is currently reported, so that it can be read later.
+ ******************************************************************************/
+RAIL_RxPacketHandle_t RAIL_HoldRxPacket(RAIL_Handle_t railHandle){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	if(!node->rx_current)
+		return RAIL_RX_PACKET_HANDLE_INVALID;
+	node->rx_current->held = true;
+	return node->rx_current;
+}
+
+/*******************************************************************************
+ * Returns the information of a held packet.
+ ******************************************************************************/
+RAIL_RxPacketHandle_t RAIL_GetRxPacketInfo(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketInfo_t *pPacketInfo){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	sim_rx_packet_t *pkt = NULL;
+	if(packetHandle == RAIL_RX_PACKET_HANDLE_OLDEST || packetHandle == RAIL_RX_PACKET_HANDLE_OLDEST_COMPLETE
+			|| packetHandle == RAIL_RX_PACKET_HANDLE_NEWEST){
+		for(int i=0;i<SIM_RX_QUEUE_LENGTH;i++){
+			sim_rx_packet_t *p = &node->rx_queue[i];
+			if(!p->used || (!p->held && p != node->rx_current)) //the packet which is being reported is in the FIFO too
+				continue;
+			if(!pkt || (packetHandle == RAIL_RX_PACKET_HANDLE_NEWEST ? p->seq > pkt->seq : p->seq < pkt->seq))
+				pkt = p;
+		}
+	}
+	else {
+		pkt = (sim_rx_packet_t *) packetHandle;
+		if(!pkt->used)
+			pkt = NULL;
+	}
+	if(!pkt)
+		return RAIL_RX_PACKET_HANDLE_INVALID;
+	pPacketInfo->packetStatus = RAIL_RX_PACKET_READY_SUCCESS;
+	pPacketInfo->packetBytes = pkt->len;
+	pPacketInfo->firstPortionBytes = pkt->len;
+	pPacketInfo->firstPortionData = pkt->data;
+	pPacketInfo->lastPortionData = NULL;
+	pPacketInfo->filterMask = 0;
+	return pkt;
+}
+
+/*******************************************************************************
+ * Releases a held packet.
+ ******************************************************************************/
+RAIL_Status_t RAIL_ReleaseRxPacket(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle){
+	(void)railHandle;
+	sim_self();
+	sim_rx_packet_t *pkt = (sim_rx_packet_t *) packetHandle;
+	if(!pkt || !pkt->used)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	pkt->used = false;
+	pkt->held = false;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Returns the details of a held packet. The timestamp refers to the start of
+ * the packet's preamble.
+ ******************************************************************************/
+RAIL_Status_t RAIL_GetRxPacketDetailsAlt(RAIL_Handle_t railHandle, RAIL_RxPacketHandle_t packetHandle, RAIL_RxPacketDetails_t *pPacketDetails){
+	sim_node_t *node = sim_self();
+	RAIL_RxPacketInfo_t info;
+	const sim_rx_packet_t *pkt = RAIL_GetRxPacketInfo(railHandle, packetHandle, &info);
+	if(!pkt)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	memset(pPacketDetails, 0, sizeof(*pPacketDetails));
+	pPacketDetails->timeReceived.packetTime = (RAIL_Time_t)(pkt->start + node->clock_offset);
+	pPacketDetails->timeReceived.totalPacketBytes = pkt->len;
+	pPacketDetails->timeReceived.timePosition = RAIL_PACKET_TIME_AT_PREAMBLE_START;
+	pPacketDetails->crcPassed = true;
+	pPacketDetails->isAck = pkt->is_ack;
+	pPacketDetails->rssi = pkt->rssi;
+	pPacketDetails->channel = node->rx_channel;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Adjusts the timestamp of a packet to the start of its preamble.
+ ******************************************************************************/
+RAIL_Status_t RAIL_GetRxTimePreambleStartAlt(RAIL_Handle_t railHandle, RAIL_RxPacketDetails_t *pPacketDetails){
+	(void)railHandle;
+	sim_self();
+	if(pPacketDetails->timeReceived.timePosition != RAIL_PACKET_TIME_AT_PREAMBLE_START)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Configures the auto-ACK.
+ ******************************************************************************/
+RAIL_Status_t RAIL_ConfigAutoAck(RAIL_Handle_t railHandle, const RAIL_AutoAckConfig_t *config){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	node->ack_enabled = config->enable;
+	node->ack_timeout_us = config->ackTimeout;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Writes the ACK which is sent after every received packet (until it is
+ * written again).
+ ******************************************************************************/
+RAIL_Status_t RAIL_WriteAutoAckFifo(RAIL_Handle_t railHandle, const uint8_t *ackData, uint8_t ackDataLen){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	if(!node->ack_enabled)
+		return RAIL_STATUS_INVALID_STATE;
+	memcpy(node->ack_fifo, ackData, ackDataLen);
+	node->ack_fifo_len = ackDataLen;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Cancels the ACK of the packet which is being reported.
+ ******************************************************************************/
+RAIL_Status_t RAIL_CancelAutoAck(RAIL_Handle_t railHandle){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	node->ack_cancelled = true;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Configures the address filter (a single field).
+ ******************************************************************************/
+RAIL_Status_t RAIL_ConfigAddressFilter(RAIL_Handle_t railHandle, const RAIL_AddrConfig_t *addrConfig){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	if(addrConfig->sizes[0] == 0 || addrConfig->sizes[0] > sizeof(node->addr_values[0]) || addrConfig->matchTable != ADDRCONFIG_MATCH_TABLE_SINGLE_FIELD)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	node->addr_offset = addrConfig->offsets[0];
+	node->addr_size = addrConfig->sizes[0];
+	memset(node->addr_enabled, 0, sizeof(node->addr_enabled)); //the addresses are cleared
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Sets an address of the address filter.
+ ******************************************************************************/
+RAIL_Status_t RAIL_SetAddressFilterAddress(RAIL_Handle_t railHandle, uint8_t field, uint8_t index, const uint8_t *value, bool enable){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	if(field != 0 || index >= ADDRESS_FILTER_ENTRIES || node->addr_size == 0)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	memcpy(node->addr_values[index], value, node->addr_size);
+	node->addr_enabled[index] = enable;
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Enables or disables the address filter, and returns whether it was enabled.
+ ******************************************************************************/
+bool RAIL_EnableAddressFilter(RAIL_Handle_t railHandle, bool enable){
+	(void)railHandle;
+	sim_node_t *node = sim_self();
+	bool was_on = node->addr_filter_on;
+	node->addr_filter_on = enable;
+	return was_on;
+}
+
+/*******************************************************************************
+ * Returns random bytes (from the random generator of the simulation).
+ ******************************************************************************/
+uint16_t RAIL_GetRadioEntropy(RAIL_Handle_t railHandle, uint8_t *buffer, uint16_t bytes){
+	(void)railHandle;
+	sim_self();
+	for(uint16_t i=0;i<bytes;i++)
+		buffer[i] = (uint8_t)(sim_random()*256);
+	return bytes;
+}
+
+//=========================================================================
+//-------------------- MULTITIMERS ----------------------------------------
+//=========================================================================
+
+/*******************************************************************************
+ * Enables the multitimer API.
+ ******************************************************************************/
+bool RAIL_ConfigMultiTimer(bool enable){
+	sim_self();
+	return enable;
+}
+
+/** Returns the slot of a multitimer of the current board, allocating one if needed.
+ *
+ * @param node The board.
+ * @param tmr The multitimer.
+ * @param allocate If true, a free slot is allocated for a new timer.
+ * @return The slot, or NULL if the timer is unknown (and allocate is false).
+ */
+static sim_timer_t *timer_slot(sim_node_t *node, RAIL_MultiTimer_t *tmr, bool allocate){
+	sim_timer_t *free_slot = NULL;
+	for(int i=0;i<SIM_MAX_TIMERS;i++){
+		if(node->timers[i].tmr == tmr)
+			return &node->timers[i];
+		if(!node->timers[i].tmr && !free_slot)
+			free_slot = &node->timers[i];
+	}
+	if(!allocate)
+		return NULL;
+	if(!free_slot){
+		fprintf(stderr, "edas_sim: board %d uses too many multitimers.\n", node->id);
+		exit(1);
+	}
+	free_slot->tmr = tmr;
+	return free_slot;
+}
+
+/*******************************************************************************
+ * Starts a multitimer.
+ ******************************************************************************/
+RAIL_Status_t RAIL_SetMultiTimer(RAIL_MultiTimer_t *tmr, RAIL_Time_t expirationTime, RAIL_TimeMode_t expirationMode, RAIL_MultiTimerCallback_t callback, void *cbArg){
+	sim_node_t *node = sim_self();
+	if(expirationMode == RAIL_TIME_DISABLED)
+		return RAIL_STATUS_INVALID_PARAMETER;
+	uint64_t expiry = to_sim_time(node, expirationTime, expirationMode);
+
+	sim_timer_t *slot = timer_slot(node, tmr, true);
+	slot->callback = callback;
+	slot->cb_arg = cbArg;
+	slot->expiry = expiry;
+	slot->armed = true;
+	slot->gen++;
+	tmr->isRunning = true;
+
+	sim_event_t ev = { .time = expiry, .type = SIM_EV_TIMER, .node = node->id, .arg = (int)(slot - node->timers), .gen = slot->gen };
+	sim_schedule(ev);
+	return RAIL_STATUS_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Stops a multitimer.
+ ******************************************************************************/
+bool RAIL_CancelMultiTimer(RAIL_MultiTimer_t *tmr){
+	sim_node_t *node = sim_self();
+	sim_timer_t *slot = timer_slot(node, tmr, false);
+	if(!slot || !slot->armed)
+		return false;
+	slot->armed = false;
+	slot->gen++;
+	tmr->isRunning = false;
+	return true;
+}
+
+/*******************************************************************************
+ * Returns whether a multitimer is running.
+ ******************************************************************************/
+bool RAIL_IsMultiTimerRunning(RAIL_MultiTimer_t *tmr){
+	sim_node_t *node = sim_self();
+	sim_timer_t *slot = timer_slot(node, tmr, false);
+	return slot && slot->armed;
+}
+
+/** Calls the callback of an expired multitimer (in interrupt context).
+ *
+ * @param node The board.
+ * @param ctx The slot of the timer.
+ */
+static void timer_isr(sim_node_t *node, void *ctx){
+	sim_timer_t *slot = ctx;
+	slot->callback(slot->tmr, (RAIL_Time_t)(slot->expiry + node->clock_offset), slot->cb_arg);
+}
+
+/*******************************************************************************
+ * Handles an expired multitimer.
+ ******************************************************************************/
+void sim_timer_event(const sim_event_t *ev){
+	sim_node_t *node = &sim_nodes[ev->node];
+	sim_timer_t *slot = &node->timers[ev->arg];
+	if(!slot->armed || slot->gen != ev->gen)
+		return;
+	slot->armed = false;
+	slot->tmr->isRunning = false;
+	if(slot->callback)
+		sim_interrupt(node, ev->time, timer_isr, slot);
+}
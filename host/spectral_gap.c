@@ -0,0 +1,329 @@
+/***************************************************************************//**
+ * @file spectral_gap.c
+ * @brief A host tool which reports the spectral gap of every weight policy of
+ * Average Consensus (see CONSENSUS_WEIGHTS in config/app_config.h) on a graph,
+ * so that the fastest-converging one can be chosen per deployment. The weights
+ * are computed with the functions of app/app_consensus.c. It also computes
+ * fastest-mixing weights (the symmetric weights of the edges which minimize the
+ * convergence rate, with a subgradient method), and prints them in the format
+ * of default_weights in config/app_config.c.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_config.h"
+#include "app_consensus.h"
+
+///The number of sweeps of the Jacobi eigenvalue method.
+#define JACOBI_SWEEPS 50
+
+///The options of the tool.
+static struct {
+	int boards;
+	const char *edges;
+	int iterations;
+} opts = {
+	.boards = DEFAULT_NUM_OF_BOARDS,
+	.edges = NULL,
+	.iterations = 3000
+};
+
+/*******************************************************************************
+ * The console of the application is not used by the tool.
+ ******************************************************************************/
+void sim_log(int level, const char *fmt, ...){
+	(void)level; (void)fmt;
+}
+
+/** Computes the eigenvalues & eigenvectors of a symmetric matrix with the
+ * (cyclic) Jacobi method.
+ *
+ * @param n The size of the matrix.
+ * @param m The matrix (it is destroyed).
+ * @param eig Where the eigenvalues are stored (in descending order).
+ * @param vec Where the eigenvectors are stored (column k for eig[k]).
+ */
+static void eigen(int n, double m[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], double *eig,
+		double vec[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	for(int i=0;i<n;i++)
+		for(int j=0;j<n;j++)
+			vec[i][j] = (i==j);
+	for(int sweep=0;sweep<JACOBI_SWEEPS;sweep++){
+		double off = 0;
+		for(int p=0;p<n;p++)
+			for(int q=p+1;q<n;q++)
+				off += m[p][q]*m[p][q];
+		if(off<1e-24)
+			break;
+		for(int p=0;p<n;p++){
+			for(int q=p+1;q<n;q++){
+				if(fabs(m[p][q])<1e-30)
+					continue;
+				double theta = (m[q][q]-m[p][p])/(2*m[p][q]);
+				double t = (theta>=0 ? 1 : -1)/(fabs(theta)+sqrt(theta*theta+1));
+				double c = 1/sqrt(t*t+1), s = t*c;
+				for(int k=0;k<n;k++){ //m = m*J
+					double mkp = m[k][p], mkq = m[k][q];
+					m[k][p] = c*mkp - s*mkq;
+					m[k][q] = s*mkp + c*mkq;
+				}
+				for(int k=0;k<n;k++){ //m = J'*m
+					double mpk = m[p][k], mqk = m[q][k];
+					m[p][k] = c*mpk - s*mqk;
+					m[q][k] = s*mpk + c*mqk;
+				}
+				for(int k=0;k<n;k++){
+					double vkp = vec[k][p], vkq = vec[k][q];
+					vec[k][p] = c*vkp - s*vkq;
+					vec[k][q] = s*vkp + c*vkq;
+				}
+			}
+		}
+	}
+	for(int i=0;i<n;i++)
+		eig[i] = m[i][i];
+	for(int i=0;i<n;i++){ //selection sort, in descending order
+		int best = i;
+		for(int j=i+1;j<n;j++)
+			if(eig[j]>eig[best])
+				best = j;
+		double tmp = eig[i]; eig[i] = eig[best]; eig[best] = tmp;
+		for(int k=0;k<n;k++){
+			tmp = vec[k][i]; vec[k][i] = vec[k][best]; vec[k][best] = tmp;
+		}
+	}
+}
+
+/** The spectrum of a weight matrix, relevant to the convergence of Average Consensus.
+ * - second: The second largest eigenvalue (the largest is 1).
+ * - smallest: The smallest eigenvalue.
+ * - rate: The convergence rate, max(|second|,|smallest|).
+ * - u: The eigenvector of the eigenvalue which determines the rate.
+ * - u_is_smallest: True if the rate is determined by the smallest eigenvalue.
+ */
+typedef struct {
+	double second;
+	double smallest;
+	double rate;
+	double u[MAX_NUM_OF_BOARDS];
+	bool u_is_smallest;
+} spectrum_t;
+
+/** Computes the spectrum of a weight matrix.
+ *
+ * @param w The weight matrix.
+ * @return The spectrum.
+ */
+static spectrum_t spectrum(const double w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	static double m[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS], vec[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	double eig[MAX_NUM_OF_BOARDS] = { 0 };
+	int n = num_of_boards;
+	spectrum_t s;
+	memcpy(m, w, sizeof(m));
+	eigen(n, m, eig, vec);
+	s.second = eig[1];
+	s.smallest = eig[n-1];
+	s.u_is_smallest = fabs(s.smallest)>fabs(s.second);
+	s.rate = s.u_is_smallest ? fabs(s.smallest) : fabs(s.second);
+	for(int i=0;i<n;i++)
+		s.u[i] = vec[i][s.u_is_smallest ? n-1 : 1];
+	return s;
+}
+
+/** Computes fastest-mixing weights of the current graph: the symmetric weights
+ * of the edges which minimize the convergence rate (the weights may be
+ * negative). It uses the subgradient method of Xiao & Boyd ("Fast linear
+ * iterations for distributed averaging"), starting from the best-constant
+ * weights.
+ *
+ * @param w Where the weight matrix is stored.
+ * @return The convergence rate of the weights.
+ */
+static double fastest_mixing_weights(double w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	static float start[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	static double cur[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	int n = num_of_boards;
+	int edges[MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS][2], num_of_edges = 0;
+	double x[MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS], g[MAX_NUM_OF_BOARDS*MAX_NUM_OF_BOARDS];
+
+	consensus_weights(WEIGHTS_BEST_CONSTANT, start);
+	for(int i=0;i<n;i++)
+		for(int j=i+1;j<n;j++)
+			if(graph[i][j]){
+				edges[num_of_edges][0] = i;
+				edges[num_of_edges][1] = j;
+				x[num_of_edges++] = start[i][j];
+			}
+
+	double best = 2;
+	for(int k=0;k<=opts.iterations;k++){
+		for(int i=0;i<n;i++)
+			for(int j=0;j<n;j++)
+				cur[i][j] = (i==j);
+		for(int l=0;l<num_of_edges;l++){ //W = I - sum of x_l (e_i-e_j)(e_i-e_j)'
+			int i = edges[l][0], j = edges[l][1];
+			cur[i][j] += x[l]; cur[j][i] += x[l];
+			cur[i][i] -= x[l]; cur[j][j] -= x[l];
+		}
+		spectrum_t s = spectrum((const double (*)[MAX_NUM_OF_BOARDS]) cur);
+		if(s.rate<best){
+			best = s.rate;
+			memcpy(w, cur, sizeof(cur));
+		}
+		if(k==opts.iterations || num_of_edges==0)
+			break;
+
+		//A subgradient of the rate: -(u_i-u_j)^2 for the second largest eigenvalue, (u_i-u_j)^2 for the smallest one
+		double norm = 0;
+		for(int l=0;l<num_of_edges;l++){
+			double d = s.u[edges[l][0]] - s.u[edges[l][1]];
+			g[l] = s.u_is_smallest ? d*d : -d*d;
+			norm += g[l]*g[l];
+		}
+		if(norm==0)
+			break;
+		double step = 0.1/sqrt(k+1.0)/sqrt(norm);
+		for(int l=0;l<num_of_edges;l++)
+			x[l] -= step*g[l];
+	}
+	return best;
+}
+
+/** Prints the spectrum of a weight matrix, as a row of the report.
+ *
+ * @param name The name of the weights.
+ * @param w The weight matrix.
+ */
+static void print_row(const char *name, const double w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS]){
+	spectrum_t s = spectrum(w);
+	printf("  %-17s %9.4f %9.4f %9.4f %9.4f ", name, s.second, s.smallest, s.rate, 1-s.rate);
+	if(s.rate<=0)
+		printf("%14s\n", "1");
+	else if(s.rate>=1)
+		printf("%14s\n", "never");
+	else
+		printf("%14.1f\n", log(0.1)/log(s.rate));
+}
+
+/** Prints the spectrum of the weights of a policy of the application.
+ *
+ * @param name The name of the policy.
+ * @param policy The policy.
+ */
+static void print_policy(const char *name, uint8_t policy){
+	static float wf[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	static double w[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	consensus_weights(policy, wf);
+	for(int i=0;i<num_of_boards;i++)
+		for(int j=0;j<num_of_boards;j++)
+			w[i][j] = wf[i][j];
+	print_row(name, (const double (*)[MAX_NUM_OF_BOARDS]) w);
+}
+
+/** Parses a comma-separated list of edges (e.g., 0-1,1-2) into the graph.
+ *
+ * @param list The list.
+ * @return True if the list was parsed successfully.
+ */
+static bool parse_edges(const char *list){
+	memset(graph, 0, sizeof(graph));
+	for(int i=0;i<num_of_boards;i++)
+		graph[i][i] = true;
+	const char *p = list;
+	while(*p){
+		char *end;
+		long a = strtol(p, &end, 10);
+		if(end==p || *end!='-' || a<0 || a>=num_of_boards)
+			return false;
+		p = end+1;
+		long b = strtol(p, &end, 10);
+		if(end==p || b<0 || b>=num_of_boards)
+			return false;
+		graph[a][b] = graph[b][a] = true;
+		p = (*end==',') ? end+1 : end;
+		if(*end && *end!=',')
+			return false;
+	}
+	return true;
+}
+
+/** Prints the usage of the tool.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options]\n"
+	       "Reports the spectral gap of every weight policy of Average Consensus on a graph.\n"
+	       "Without --edges, the default graph of config/app_config.c is used.\n\n"
+	       "  --boards N           Number of boards (at most %d, default %d).\n"
+	       "  --edges LIST         Edges of the graph (e.g., 0-1,1-2,2-3).\n"
+	       "  --iterations N       Iterations of the search for fastest-mixing weights (default 3000).\n"
+	       "  -h, --help           Print this message.\n", prog, MAX_NUM_OF_BOARDS, DEFAULT_NUM_OF_BOARDS);
+}
+
+/** Parses the command line and prints the report.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 1 on invalid arguments.
+ */
+int main(int argc, char **argv){
+	static const struct option long_opts[] = {
+		{ "boards", required_argument, NULL, 'n' },
+		{ "edges", required_argument, NULL, 'e' },
+		{ "iterations", required_argument, NULL, 'i' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "h", long_opts, NULL)) != -1){
+		switch(c){
+		case 'n': opts.boards = atoi(optarg); break;
+		case 'e': opts.edges = optarg; break;
+		case 'i': opts.iterations = atoi(optarg); break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	if(opts.boards < 2 || opts.boards > MAX_NUM_OF_BOARDS || opts.iterations < 0
+			|| (!opts.edges && opts.boards != DEFAULT_NUM_OF_BOARDS)){
+		usage(argv[0]);
+		return 1;
+	}
+	num_of_boards = opts.boards;
+	if(opts.edges){
+		if(!parse_edges(opts.edges)){
+			fprintf(stderr, "spectral_gap: invalid list of edges '%s'.\n", opts.edges);
+			return 1;
+		}
+	}
+	else {
+		for(int i=0;i<DEFAULT_NUM_OF_BOARDS;i++)
+			for(int j=0;j<DEFAULT_NUM_OF_BOARDS;j++)
+				graph[i][j] = default_graph[i][j];
+	}
+
+	static double fastest[MAX_NUM_OF_BOARDS][MAX_NUM_OF_BOARDS];
+	fastest_mixing_weights(fastest);
+
+	printf("%s graph (%d boards):\n", opts.edges ? "Given" : "Default", num_of_boards);
+	printf("  %-17s %9s %9s %9s %9s %14s\n", "weights", "lambda_2", "lambda_n", "rate", "gap", "iters/decade");
+	print_policy("max-degree", WEIGHTS_MAX_DEGREE);
+	print_policy("metropolis", WEIGHTS_METROPOLIS);
+	print_policy("best-constant", WEIGHTS_BEST_CONSTANT);
+	if(!opts.edges)
+		print_policy("configured", WEIGHTS_CONFIGURED);
+	print_row("fastest-mixing", (const double (*)[MAX_NUM_OF_BOARDS]) fastest);
+
+	printf("\nFastest-mixing weights (for default_weights in config/app_config.c):\n");
+	for(int i=0;i<num_of_boards;i++){
+		printf("    {");
+		for(int j=0;j<num_of_boards;j++)
+			printf("%s%.4f", j ? ", " : "", (i!=j && graph[i][j]) ? fastest[i][j] : 0.0);
+		printf("}%s\n", i+1<num_of_boards ? "," : "};");
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * @file trace_decode.c
+ * @brief Renders the trace of the boards as text. It copies its input (the
+ * console output of a board, or the output of edas_sim -v) to the standard
+ * output, and replaces every dumped record of a trace (see app/app_trace.h)
+ * with the message it stands for, after the same prefix (e.g., the time and
+ * the board of edas_sim). The messages are produced by the function of the
+ * application, hence they are identical to the ones of USE_TRACE 0.
+ * @author Georgios Apostolakis
+ ******************************************************************************/
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_trace.h"
+
+///The options of the decoder.
+static struct {
+	bool time;
+} opts = {
+	.time = false
+};
+
+/*******************************************************************************
+ * The console of the application is not used by the decoder.
+ ******************************************************************************/
+void sim_log(int level, const char *fmt, ...){
+	(void)level; (void)fmt;
+}
+
+/*******************************************************************************
+ * The time of the application is not used by the decoder.
+ ******************************************************************************/
+RAIL_Time_t RAIL_GetTime(void){
+	return 0;
+}
+
+/** Prints every line of a message after a prefix and a timestamp.
+ *
+ * @param prefix The prefix.
+ * @param prefix_len The length of the prefix.
+ * @param stamp The timestamp (or an empty string).
+ * @param text The message.
+ */
+static void print_lines(const char *prefix, int prefix_len, const char *stamp, const char *text){
+	while(*text){
+		const char *end = strchr(text, '\n');
+		int len = end ? (int)(end-text) : (int) strlen(text);
+		printf("%.*s%s%.*s\n", prefix_len, prefix, stamp, len, text);
+		text += end ? len+1 : len;
+	}
+}
+
+/** Copies a file to the standard output, and renders the records of a trace.
+ *
+ * @param in The file.
+ * @return The number of invalid records.
+ */
+static int decode(FILE *in){
+	char line[1024];
+	char text[256], stamp[32] = "";
+	int invalid = 0;
+	while(fgets(line, sizeof(line), in)){
+		char *start = strstr(line, TRACE_LINE_PREFIX);
+		trace_record_t record;
+		if(start==NULL || !decode_trace_record(start+strlen(TRACE_LINE_PREFIX), &record)){
+			invalid += start!=NULL;
+			fputs(line, stdout);
+			continue;
+		}
+		if(opts.time)
+			snprintf(stamp, sizeof(stamp), "[%10.3f ms] ", record.time/1000.0);
+		trace_to_text(&record, text, sizeof(text));
+		print_lines(line, (int)(start-line), stamp, text);
+	}
+	return invalid;
+}
+
+/** Prints the usage of the decoder.
+ *
+ * @param prog The name of the executable.
+ */
+static void usage(const char *prog){
+	printf("Usage: %s [options] [file...]\n"
+	       "Renders the trace records (%s...) of the console output of the boards (or of the standard input) as text.\n\n"
+	       "  -t, --time           Print the time of every record (in the RAIL time of its board).\n"
+	       "  -h, --help           Print this message.\n", prog, TRACE_LINE_PREFIX);
+}
+
+/** Parses the command line and decodes the files.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 1 on invalid arguments or files, 2 if some records were invalid.
+ */
+int main(int argc, char **argv){
+	static const struct option long_opts[] = {
+		{ "time", no_argument, NULL, 't' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int c;
+	while((c = getopt_long(argc, argv, "th", long_opts, NULL)) != -1){
+		switch(c){
+		case 't': opts.time = true; break;
+		case 'h': usage(argv[0]); return 0;
+		default: usage(argv[0]); return 1;
+		}
+	}
+	int invalid = 0;
+	if(optind == argc)
+		invalid = decode(stdin);
+	for(int i=optind;i<argc;i++){
+		FILE *in = fopen(argv[i], "r");
+		if(in == NULL){
+			perror(argv[i]);
+			return 1;
+		}
+		invalid += decode(in);
+		fclose(in);
+	}
+	if(invalid > 0)
+		fprintf(stderr, "%s: %d invalid trace records were copied unchanged.\n", argv[0], invalid);
+	return invalid > 0 ? 2 : 0;
+}